@@ -0,0 +1,57 @@
+#include <fmt/format.h>
+
+#include <clt/aes_hash.hpp>
+#include <clt/rng.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::rng;
+using namespace clt::bench;
+
+constexpr size_t long_bytes = 1 << 20;
+constexpr size_t long_reps = 256;
+constexpr size_t num_keys = 1 << 20;
+
+template <size_t Rounds> void do_iteration(const vector<uint8_t> &buff)
+{
+    const AESRoundHash<Rounds> hash;
+    uint64_t sum = 0;
+    print_throughput(fmt::format("long_rounds{}", Rounds),
+                     long_bytes * long_reps, [&]() {
+                         for (size_t r = 0; r < long_reps; r++) {
+                             sum += hash.hash64(buff.data(), long_bytes);
+                         }
+                     });
+    dummy_call(&sum);
+    vector<uint64_t> out(num_keys);
+    for (const size_t key_bytes : {8, 16, 32, 64}) {
+        const auto single_time = measure_static([&]() {
+            for (size_t i = 0; i < num_keys; i++) {
+                out[i] = hash.hash64(buff.data() + key_bytes * i, key_bytes);
+            }
+        });
+        dummy_call(out.data());
+        const auto batched_time = measure_static([&]() {
+            hash.hash64(out.data(), buff.data(), key_bytes, num_keys);
+        });
+        dummy_call(out.data());
+        fmt::print("keys_rounds{},{},{:e},{:e}\n", Rounds, key_bytes,
+                   1e9 * single_time / num_keys,
+                   1e9 * batched_time / num_keys);
+    }
+}
+
+int main()
+{
+    print_diagnosis();
+    vector<uint8_t> buff(64 * num_keys);
+    init(buff);
+    print_throughput_call_once();
+    fmt::print("mode,key_bytes,single_ns/key,batched_ns/key\n");
+    do_iteration<1>(buff);
+    do_iteration<2>(buff);
+    do_iteration<3>(buff);
+    do_iteration<4>(buff);
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <array>
+#include <cstdlib>
+#include <cmath>
+
+#include <fmt/format.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/shuffle.hpp>
+#include <clt/util_omp.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::rng;
+using namespace clt::bench;
+
+namespace {
+struct record_t {
+    std::array<uint64_t, 4> payload;
+};
+} // namespace
+
+inline void do_apply_inplace_iteration(const size_t max_exponent)
+{
+    const AES128::key_t key = gen_key();
+    AESPRF128_CTR prf(key.data());
+    fmt::print("mode,num_32byte_records,sec,records/sec,extra_rss_bytes\n");
+    const string fmt_str = "{},{},{:e},{:e},{}\n";
+    for (size_t e = 5; e <= max_exponent; e++) {
+        const auto n = static_cast<size_t>(std::pow(10, e));
+        Permutation perm(n);
+        shuffle_rounding(perm.indices_.data(), n, prf);
+        vector<record_t> buff(n);
+        for (size_t i = 0; i < n; i++) {
+            buff[i].payload.fill(i);
+        }
+        const auto *p_perm = perm.indices_.data();
+        auto run = [&](const string &label, auto &&func) {
+            const auto base_rss = peak_rss_bytes();
+            const auto elapsed_time = measure_static(func);
+            const auto rss = peak_rss_bytes();
+            fmt::print(CLT_FMT_RUNTIME(fmt_str), label, n, elapsed_time,
+                       n / elapsed_time, rss - base_rss);
+        };
+        // NOTE: In-place modes first, peak RSS only grows.
+        run("inplace",
+            [&]() { apply_permutation_inplace(buff.data(), p_perm, n); });
+        run("inplace_parallel", [&]() {
+            apply_permutation_inplace_parallel(buff.data(), p_perm, n);
+        });
+        run("out_of_place", [&]() {
+            vector<record_t> out(n);
+            apply_permutation(out.data(), buff.data(), p_perm, n);
+            dummy_call(out.data());
+        });
+        dummy_call(buff.data());
+    }
+}
+
+int main(int argc, char **argv)
+{
+    // NOTE: The largest size is 10^max_exponent records, 10^8 by default.
+    const size_t max_exponent = (argc > 1) ? std::atoi(argv[1]) : 8;
+    print_diagnosis();
+    print_omp_diagnosis();
+    do_apply_inplace_iteration(max_exponent);
+    return 0;
+}
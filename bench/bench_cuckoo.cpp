@@ -0,0 +1,72 @@
+#include <fmt/format.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/cuckoo.hpp>
+#include <clt/util_omp.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::bench;
+
+using block_t = AES128::block_t;
+
+constexpr size_t num_hashes = 3;
+// NOTE: 1.27 bins per item for 3 hash functions.
+constexpr double bins_per_item = 1.27;
+
+int main()
+{
+    print_diagnosis();
+    print_omp_diagnosis();
+    constexpr size_t num_items = 1 << 22;
+    const uint64_t num_bins = num_items * bins_per_item;
+    vector<block_t> items(num_items);
+    AES128(gen_key()).ctr_stream(items.data(), num_items, 0);
+    vector<uint32_t> hashes(num_hashes * num_items);
+    // NOTE: The baseline encrypts one item per call.
+    const AES128 aes(cuckoo::default_key);
+    print_throughput(
+        "hash_scalar", num_items,
+        [&]() {
+            for (size_t i = 0; i < num_items; i++) {
+                uint32_t words[4];
+                aes.enc(words, items[i].data());
+                for (size_t j = 0; j < num_hashes; j++) {
+                    hashes[num_hashes * i + j] =
+                        (uint64_t(words[j]) * num_bins) >> 32;
+                }
+            }
+        },
+        "items");
+    dummy_call(hashes.data());
+    const MultiHash hash(num_bins, num_hashes);
+    print_throughput(
+        "hash_batched", num_items,
+        [&]() { hash(hashes.data(), items.data(), num_items); }, "items");
+    dummy_call(hashes.data());
+    print_throughput(
+        "hash_batched_parallel", num_items,
+        [&]() { hash(hashes.data(), items.data(), num_items, true); },
+        "items");
+    dummy_call(hashes.data());
+
+    fmt::print("mode,num_items,num_bins,sec,items/sec,stash,max_bin\n");
+    for (size_t log_items = 20; log_items <= 24; log_items += 2) {
+        const size_t n = size_t(1) << log_items;
+        const uint64_t m = n * bins_per_item;
+        items.resize(n);
+        AES128(gen_key()).ctr_stream(items.data(), n, 0);
+        CuckooTable table(m, num_hashes);
+        const auto cuckoo_time =
+            measure_static([&]() { table.build(items.data(), n); });
+        fmt::print("cuckoo,{},{},{:e},{:e},{},\n", n, m, cuckoo_time,
+                   n / cuckoo_time, table.stash().size());
+        SimpleHashing simple(m, num_hashes);
+        const auto simple_time =
+            measure_static([&]() { simple.build(items.data(), n); });
+        fmt::print("simple,{},{},{:e},{:e},,{}\n", n, m, simple_time,
+                   n / simple_time, simple.max_bin_size());
+    }
+    return 0;
+}
@@ -13,10 +13,11 @@ inline void do_dev_urandom_iteration()
     size_t current = start_byte_size;
     vector<uint8_t> buff;
     buff.reserve(stop_byte_size);
+    RandomDevice rdev;
     while (current <= stop_byte_size) {
         buff.resize(current);
         print_throughput("/dev/urandom", buff.size(), [&]() {
-            clt::rng::rng_global(buff.data(), size(buff));
+            rdev(buff.data(), size(buff));
         });
         if (!check_random_bytes(buff)) {
             fmt::print(cerr, "WARN: Unexpected statistics.\n");
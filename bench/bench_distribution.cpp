@@ -0,0 +1,66 @@
+#include <random>
+
+#include <clt/aes-ni.hpp>
+#include <clt/distribution.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::bench;
+
+constexpr size_t num_values = 1 << 24;
+
+template <class T, class Func>
+inline void do_values_iteration(const string &label, Func &&gen)
+{
+    vector<T> buff(num_values);
+    print_throughput(
+        label, buff.size(), [&]() { gen(buff.data(), buff.size()); },
+        "values");
+    dummy_call(buff.data());
+}
+
+template <class T, class Dist>
+inline void do_std_iteration(const string &label, mt19937_64 &eng, Dist dist)
+{
+    do_values_iteration<T>(label, [&](T *out, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = dist(eng);
+        }
+    });
+}
+
+int main()
+{
+    print_diagnosis();
+    const auto key = gen_key();
+    AESPRF128_CTR prf_ctr(key.data());
+    AES128_CTR aes_ctr(key.data());
+    do_values_iteration<double>("aesprf_uniform_double",
+                                [&](double *out, size_t n) {
+                                    fill_uniform(prf_ctr, out, n);
+                                });
+    do_values_iteration<double>("aes_uniform_double",
+                                [&](double *out, size_t n) {
+                                    fill_uniform(aes_ctr, out, n);
+                                });
+    do_values_iteration<float>("aes_uniform_float", [&](float *out, size_t n) {
+        fill_uniform(aes_ctr, out, n);
+    });
+    do_values_iteration<double>("aes_normal", [&](double *out, size_t n) {
+        fill_normal(aes_ctr, out, n);
+    });
+    do_values_iteration<double>("aes_exponential", [&](double *out, size_t n) {
+        fill_exponential(aes_ctr, out, n);
+    });
+    mt19937_64 eng(key[0]);
+    do_std_iteration<double>("mt19937_64_uniform_double", eng,
+                             uniform_real_distribution<double>());
+    do_std_iteration<float>("mt19937_64_uniform_float", eng,
+                            uniform_real_distribution<float>());
+    do_std_iteration<double>("mt19937_64_normal", eng,
+                             normal_distribution<double>());
+    do_std_iteration<double>("mt19937_64_exponential", eng,
+                             exponential_distribution<double>());
+    return 0;
+}
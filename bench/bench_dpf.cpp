@@ -0,0 +1,67 @@
+#include <fmt/format.h>
+
+#include <clt/dpf.hpp>
+#include <clt/util_omp.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::bench;
+
+constexpr size_t max_threads = 8;
+
+inline void do_eval_full_iteration(const size_t log_domain,
+                                   const size_t elem_bits)
+{
+    const DPF dpf(log_domain, elem_bits);
+    const auto [key0, key1] = dpf.gen(log_domain * 12345, 1);
+    vector<uint8_t> out(dpf.full_bytes());
+    const string fmt_str = "eval_full,{},{},{},{},{:e},{:e}\n";
+    const auto serial_time =
+        measure_static([&]() { dpf.eval_full(key0, out.data()); });
+    fmt::print(CLT_FMT_RUNTIME(fmt_str), log_domain, elem_bits, "serial", 1,
+               serial_time, (uint64_t(1) << log_domain) / serial_time);
+    dummy_call(out.data());
+#ifdef _OPENMP
+    const auto default_threads = omp_get_max_threads();
+    for (size_t num_threads = 1; num_threads <= max_threads;
+         num_threads <<= 1) {
+        omp_set_num_threads(num_threads);
+        const auto parallel_time =
+            measure_static([&]() { dpf.eval_full(key0, out.data(), true); });
+        fmt::print(CLT_FMT_RUNTIME(fmt_str), log_domain, elem_bits, "parallel",
+                   num_threads, parallel_time,
+                   (uint64_t(1) << log_domain) / parallel_time);
+        dummy_call(out.data());
+    }
+    omp_set_num_threads(default_threads);
+#endif
+}
+
+int main()
+{
+    print_diagnosis();
+    print_omp_diagnosis();
+    const DPF dpf(20, 1);
+    const auto [key0, key1] = dpf.gen(12345, 1);
+    constexpr size_t num_evals = 1 << 16;
+    uint64_t sum = 0;
+    print_throughput(
+        "eval_log_domain20", num_evals,
+        [&]() {
+            for (size_t x = 0; x < num_evals; x++) {
+                sum += dpf.eval(key0, x);
+            }
+        },
+        "points");
+    dummy_call(&sum);
+    fmt::print("mode,log_domain,elem_bits,schedule,num_threads,sec,"
+               "points/sec\n");
+    for (size_t log_domain = 20; log_domain <= 28; log_domain += 2) {
+        do_eval_full_iteration(log_domain, 1);
+    }
+    for (size_t log_domain = 20; log_domain <= 26; log_domain += 2) {
+        do_eval_full_iteration(log_domain, 32);
+    }
+    return 0;
+}
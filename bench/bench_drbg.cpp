@@ -0,0 +1,61 @@
+#include <random>
+
+#include <clt/aes-ni.hpp>
+#include <clt/drbg.hpp>
+#include <clt/rdrand.hpp>
+#include <clt/rng.hpp>
+#include <clt/statistics.hpp>
+#include <clt/benchmark.hpp>
+
+#include <randen.h>
+
+using namespace std;
+using namespace clt;
+using namespace clt::rng;
+using namespace clt::bench;
+
+template <class Func>
+inline void do_byte_iteration(const string &label, Func &&gen)
+{
+    size_t current = start_byte_size;
+    vector<uint8_t> buff;
+    buff.reserve(stop_byte_size);
+    while (current <= stop_byte_size) {
+        buff.resize(current);
+        print_throughput(label, buff.size(),
+                         [&]() { gen(buff.data(), buff.size()); });
+        if (!check_random_bytes(buff)) {
+            fmt::print(cerr, "WARN: Unexpected statistics.\n");
+        }
+        current <<= 1;
+    }
+}
+
+int main()
+{
+    print_diagnosis();
+    AES128_CTR_DRBG drbg;
+    do_byte_iteration("ctr_drbg", [&](void *p, size_t n) { drbg(p, n); });
+    do_byte_iteration("ctr_drbg_thread_local", [](void *p, size_t n) {
+        thread_local_drbg()(p, n);
+    });
+    do_byte_iteration("getrandom",
+                      [](void *p, size_t n) { rng_global(p, n); });
+    RandomDevice rdev;
+    do_byte_iteration("/dev/urandom", [&](void *p, size_t n) { rdev(p, n); });
+#if defined(__RDRND__) || defined(__APPLE__)
+    do_byte_iteration("rdrand", [](void *p, size_t n) {
+        rdrand(p, n / sizeof(generic_rdrand_t));
+    });
+#endif
+    uint64_t seed;
+    init(&seed, 1);
+    randen::Randen<uint64_t> eng_randen(seed);
+    do_byte_iteration("randen", [&](void *p, size_t n) {
+        auto *p_out = reinterpret_cast<uint64_t *>(p);
+        for (size_t i = 0; i < n / sizeof(uint64_t); i++) {
+            p_out[i] = eng_randen();
+        }
+    });
+    return 0;
+}
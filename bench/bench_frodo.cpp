@@ -0,0 +1,67 @@
+#include <clt/aes-ni.hpp>
+#include <clt/frodo.hpp>
+#include <clt/util_omp.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::bench;
+
+constexpr size_t num_matrices = 64;
+
+int main()
+{
+    print_diagnosis();
+    print_omp_diagnosis();
+    const auto key = gen_key();
+    for (const auto &[n, log_q] :
+         {pair<size_t, size_t>(640, 15), pair<size_t, size_t>(976, 16),
+          pair<size_t, size_t>(1344, 16)}) {
+        const FrodoMatrixAES128 a(key.data(), n, log_q);
+        vector<uint16_t> mat(n * n);
+        // NOTE: Through the block API, with a row of plaintexts per row.
+        const AES128 aes(key.data());
+        vector<uint16_t> row_in(n);
+        print_throughput(
+            fmt::format("aes128_enc_row_buffer_n{}", n), num_matrices,
+            [&]() {
+                for (size_t m = 0; m < num_matrices; m++) {
+                    for (size_t i = 0; i < n; i++) {
+                        fill(row_in.begin(), row_in.end(), 0);
+                        for (size_t j = 0; j < n; j += 8) {
+                            row_in[j] = i;
+                            row_in[j + 1] = j;
+                        }
+                        auto *row = mat.data() + n * i;
+                        aes.enc(row, row_in.data(),
+                                n / frodo::entries_per_block);
+                        const uint16_t mask = (1 << log_q) - 1;
+                        for (size_t j = 0; j < n; j++) {
+                            row[j] &= mask;
+                        }
+                    }
+                }
+            },
+            "matrices");
+        dummy_call(mat.data());
+        print_throughput(
+            fmt::format("frodo_expand_n{}", n), num_matrices,
+            [&]() {
+                for (size_t m = 0; m < num_matrices; m++) {
+                    a.expand(mat.data());
+                }
+            },
+            "matrices");
+        dummy_call(mat.data());
+        print_throughput(
+            fmt::format("frodo_expand_parallel_n{}", n), num_matrices,
+            [&]() {
+                for (size_t m = 0; m < num_matrices; m++) {
+                    a.expand(mat.data(), true);
+                }
+            },
+            "matrices");
+        dummy_call(mat.data());
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <random>
+#include <sstream>
+
+#include <fmt/format.h>
+
+#include <clt/garble.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::bench;
+
+// NOTE: Circuits are garbled repeatedly up to min_and_gates AND gates.
+constexpr size_t min_and_gates = 1 << 22;
+
+/**
+ * Random layered circuit in Bristol Fashion with the given gate counts, a
+ * stand-in when no circuit file is given.
+ */
+string random_circuit(const size_t num_inputs, const size_t num_outputs,
+                      const size_t num_and, const size_t num_xor,
+                      const size_t num_inv, const size_t num_layers)
+{
+    mt19937_64 rng(num_and);
+    ostringstream body;
+    size_t next_wire = num_inputs;
+    auto random_wire = [&](const size_t bound) {
+        return uniform_int_distribution<size_t>(0, bound - 1)(rng);
+    };
+    auto share = [&](const size_t num, const size_t l) {
+        return (num * (l + 1)) / num_layers - (num * l) / num_layers;
+    };
+    // NOTE: AND gates take one input from the AND gates of the previous
+    // layer, so that the AND depth is num_layers.
+    size_t first = 0, last = num_inputs;
+    for (size_t l = 0; l < num_layers; l++) {
+        const size_t bound = next_wire;
+        for (size_t i = 0; i < share(num_and, l); i++) {
+            const auto x = first + random_wire(last - first);
+            body << fmt::format("2 1 {} {} {} AND\n", x, random_wire(bound),
+                                next_wire++);
+        }
+        first = bound;
+        last = next_wire;
+        for (size_t i = 0; i < share(num_xor, l); i++) {
+            body << fmt::format("2 1 {} {} {} XOR\n", random_wire(next_wire),
+                                random_wire(next_wire), next_wire);
+            next_wire++;
+        }
+        for (size_t i = 0; i < share(num_inv, l); i++) {
+            body << fmt::format("1 1 {} {} INV\n", random_wire(next_wire),
+                                next_wire);
+            next_wire++;
+        }
+    }
+    const size_t num_gates = next_wire - num_inputs + num_outputs;
+    for (size_t i = 0; i < num_outputs; i++) {
+        body << fmt::format("1 1 {} {} EQW\n", random_wire(next_wire),
+                            next_wire + i);
+    }
+    return fmt::format("{} {}\n2 {} {}\n1 {}\n\n{}", num_gates,
+                       next_wire + num_outputs, num_inputs / 2,
+                       num_inputs / 2, num_outputs, body.str());
+}
+
+void do_iteration(const string &label, const Circuit &circuit)
+{
+    const size_t reps =
+        max(size_t(1), min_and_gates / max(size_t(1), circuit.num_and_gates()));
+    HalfGatesGarbler garbler;
+    HalfGatesEvaluator evaluator;
+    vector<uint8_t> tables(circuit.table_bytes());
+    vector<AES128::block_t> labels0(circuit.num_inputs());
+    vector<AES128::block_t> labels(circuit.num_inputs());
+    vector<AES128::block_t> outputs(circuit.num_outputs());
+    vector<uint8_t> decoding(circuit.num_outputs());
+    vector<uint8_t> in(circuit.num_inputs(), 1);
+    // NOTE: tables are the in-memory channel from the garbler to the
+    // evaluator.
+    double garble_time = 0, evaluate_time = 0;
+    for (size_t r = 0; r < reps; r++) {
+        garble_time += measure_static([&]() {
+            garbler.garble(circuit, tables.data(), labels0.data(),
+                           decoding.data());
+        });
+        garbler.encode(labels.data(), labels0.data(), in.data(), in.size());
+        evaluate_time += measure_static([&]() {
+            evaluator.evaluate(circuit, tables.data(), labels.data(),
+                               outputs.data());
+        });
+        dummy_call(outputs.data());
+    }
+    const double num_and = double(reps) * circuit.num_and_gates();
+    fmt::print("{},{},{},{},{:e},{:e}\n", label, circuit.num_and_gates(),
+               circuit.num_gates(), circuit.num_layers(),
+               num_and / garble_time, num_and / evaluate_time);
+}
+
+int main(int argc, char **argv)
+{
+    print_diagnosis();
+    fmt::print("circuit,and_gates,gates,layers,garble_and/sec,"
+               "evaluate_and/sec\n");
+    if (argc > 1) {
+        // NOTE: Bristol Fashion files, e.g., aes_128.txt and sha256.txt.
+        for (int i = 1; i < argc; i++) {
+            do_iteration(argv[i], Circuit::from_file(argv[i]));
+        }
+        return 0;
+    }
+    // NOTE: Stand-ins with the gate counts of aes_128.txt and sha256.txt.
+    for (const size_t num_layers : {40, 400}) {
+        istringstream aes(
+            random_circuit(256, 128, 6400, 28176, 2087, num_layers));
+        do_iteration(fmt::format("random_aes_128_{}", num_layers),
+                     Circuit(aes));
+    }
+    for (const size_t num_layers : {400, 4000}) {
+        istringstream sha(
+            random_circuit(768, 256, 22573, 110644, 1856, num_layers));
+        do_iteration(fmt::format("random_sha256_{}", num_layers),
+                     Circuit(sha));
+    }
+    return 0;
+}
@@ -0,0 +1,35 @@
+#include <clt/aes-ni.hpp>
+#include <clt/gaussian.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::bench;
+
+constexpr size_t num_samples = 1 << 22;
+
+template <class Gen>
+inline void do_sigma_iteration(const string &label, Gen &gen,
+                               const double sigma)
+{
+    const DiscreteGaussianCDT dg(sigma);
+    vector<int32_t> buff(num_samples);
+    print_throughput(
+        fmt::format("{}_sigma{}_bound{}", label, sigma, dg.bound()),
+        buff.size(), [&]() { dg(gen, buff.data(), buff.size()); },
+        "samples");
+    dummy_call(buff.data());
+}
+
+int main()
+{
+    print_diagnosis();
+    const auto key = gen_key();
+    AES128_CTR aes_ctr(key.data());
+    AESPRF128_CTR prf_ctr(key.data());
+    for (const double sigma : {1.0, 2.0, 3.2, 8.0, 32.0}) {
+        do_sigma_iteration("aes_ctr", aes_ctr, sigma);
+        do_sigma_iteration("aesprf_ctr", prf_ctr, sigma);
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <mutex>
+
+#include <fmt/format.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/rng.hpp>
+#include <clt/util_omp.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::rng;
+using namespace clt::bench;
+
+template <class Func>
+inline void do_gen_key_iteration(const string &label, Func &&gen)
+{
+    constexpr size_t num_calls = 1 << 16;
+    const string fmt_str = label + ",{},{},{:e},{:e}\n";
+    for (int num_threads = 1; num_threads <= 64; num_threads <<= 1) {
+        const auto elapsed_time = measure_static([&]() {
+#pragma omp parallel num_threads(num_threads)
+            {
+                AES128::key_t key;
+#pragma omp for
+                for (size_t i = 0; i < num_calls; i++) {
+                    gen(key);
+                }
+                dummy_call(key.data());
+            }
+        });
+        fmt::print(CLT_FMT_RUNTIME(fmt_str), num_threads, num_calls,
+                   elapsed_time, num_calls / elapsed_time);
+    }
+}
+
+int main()
+{
+    print_diagnosis();
+    print_omp_diagnosis();
+    fmt::print("mode,num_threads,calls,sec,calls/sec\n");
+    do_gen_key_iteration("gen_key",
+                         [](AES128::key_t &key) { key = gen_key(); });
+    do_gen_key_iteration("getrandom", [](AES128::key_t &key) {
+        getrandom(key.data(), key.size());
+    });
+    // NOTE: The former global source, serialized to make it race-free.
+    RandomDevice rdev;
+    mutex mtx;
+    do_gen_key_iteration("dev_urandom_locked", [&](AES128::key_t &key) {
+        lock_guard<mutex> lock(mtx);
+        rdev(key.data(), key.size());
+    });
+    return 0;
+}
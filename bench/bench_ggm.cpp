@@ -0,0 +1,94 @@
+#include <clt/aes-ni.hpp>
+#include <clt/ggm.hpp>
+#include <clt/util_omp.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::bench;
+
+using block_t = GGMTree::block_t;
+
+// NOTE: Trees of small depths are repeated up to 2^min_leaves_log leaves.
+constexpr size_t min_leaves_log = 22;
+constexpr size_t max_expand_depth = 24;
+constexpr size_t max_chunks_depth = 30;
+constexpr size_t max_per_node_depth = 20;
+
+inline size_t num_trees(const size_t depth)
+{
+    return (depth < min_leaves_log) ? (size_t(1) << (min_leaves_log - depth))
+                                    : 1;
+}
+
+int main()
+{
+    print_diagnosis();
+    print_omp_diagnosis();
+    const GGMTree tree;
+    block_t root = gen_key();
+    // NOTE: The baseline calls MMO128 per node and level.
+    const MMO128 mmo_l(ggm::default_key_left), mmo_r(ggm::default_key_right);
+    for (size_t depth = 10; depth <= max_per_node_depth; depth += 5) {
+        vector<block_t> buff(size_t(1) << depth), next(buff.size());
+        const size_t n = num_trees(depth);
+        print_throughput(
+            fmt::format("mmo128_per_node_depth{}", depth), n * buff.size(),
+            [&]() {
+                for (size_t t = 0; t < n; t++) {
+                    buff[0] = root;
+                    for (size_t l = 0; l < depth; l++) {
+                        for (size_t i = 0; i < (size_t(1) << l); i++) {
+                            mmo_l(next[2 * i].data(), buff[i].data());
+                            mmo_r(next[2 * i + 1].data(), buff[i].data());
+                        }
+                        swap(buff, next);
+                    }
+                }
+            },
+            "leaves");
+        dummy_call(buff.data());
+    }
+    for (size_t depth = 10; depth <= max_expand_depth; depth += 2) {
+        vector<block_t> buff(size_t(1) << depth);
+        const size_t n = num_trees(depth);
+        for (const bool parallel : {false, true}) {
+            print_throughput(
+                fmt::format("ggm_expand{}_depth{}",
+                            parallel ? "_parallel" : "", depth),
+                n * buff.size(),
+                [&]() {
+                    for (size_t t = 0; t < n; t++) {
+                        buff[0] = root;
+                        tree.expand(buff.data(), depth, parallel);
+                    }
+                },
+                "leaves");
+            dummy_call(buff.data());
+        }
+    }
+    for (size_t depth = 10; depth <= max_chunks_depth; depth += 4) {
+        const size_t n = num_trees(depth);
+        __m128i sum = _mm_setzero_si128();
+        print_throughput(
+            fmt::format("ggm_expand_chunks_depth{}", depth),
+            n * (size_t(1) << depth),
+            [&]() {
+                for (size_t t = 0; t < n; t++) {
+                    tree.expand_chunks(
+                        root.data(), depth,
+                        [&](size_t, const block_t *leaves, size_t num) {
+                            const auto *p =
+                                reinterpret_cast<const __m128i *>(leaves);
+                            for (size_t i = 0; i < num; i++) {
+                                sum =
+                                    _mm_xor_si128(sum, _mm_loadu_si128(p + i));
+                            }
+                        });
+                }
+            },
+            "leaves");
+        dummy_call(&sum);
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <fmt/format.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/haraka.hpp>
+#include <clt/rng.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::rng;
+using namespace clt::bench;
+
+constexpr size_t num_msgs = 1 << 20;
+
+int main()
+{
+    print_diagnosis();
+    const Haraka haraka;
+    const MMO128 mmo(gen_key());
+    vector<uint8_t> in(64 * num_msgs), out(32 * num_msgs);
+    init(in);
+    // NOTE: One call per message, and one call for all messages.
+    print_throughput(
+        "haraka256_single", num_msgs,
+        [&]() {
+            for (size_t i = 0; i < num_msgs; i++) {
+                haraka.hash256(out.data() + 32 * i, in.data() + 32 * i);
+            }
+        },
+        "hashes");
+    print_throughput(
+        "haraka256_batch", num_msgs,
+        [&]() { haraka.hash256(out.data(), in.data(), num_msgs); },
+        "hashes");
+    print_throughput(
+        "haraka512_single", num_msgs,
+        [&]() {
+            for (size_t i = 0; i < num_msgs; i++) {
+                haraka.hash512(out.data() + 32 * i, in.data() + 64 * i);
+            }
+        },
+        "hashes");
+    print_throughput(
+        "haraka512_batch", num_msgs,
+        [&]() { haraka.hash512(out.data(), in.data(), num_msgs); },
+        "hashes");
+    // NOTE: MMO128 hashes 128-bit blocks to 128 bits.
+    print_throughput(
+        "mmo128_single", num_msgs,
+        [&]() {
+            for (size_t i = 0; i < num_msgs; i++) {
+                mmo(out.data() + 16 * i, in.data() + 16 * i);
+            }
+        },
+        "hashes");
+    print_throughput(
+        "mmo128_batch", num_msgs,
+        [&]() { mmo(out.data(), in.data(), num_msgs); }, "hashes");
+    dummy_call(out.data());
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <fmt/format.h>
+
+#ifdef CLT_HAVE_OPENSSL
+#include <openssl/evp.h>
+#endif
+
+#include <clt/aes-ni.hpp>
+#include <clt/hirose.hpp>
+#include <clt/rng.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::rng;
+using namespace clt::bench;
+
+constexpr size_t total_bytes = 1 << 26;
+
+int main()
+{
+    print_diagnosis();
+    const Hirose256 hirose;
+    vector<uint8_t> in(total_bytes), out(hirose::digest_bytes);
+    init(in);
+    // NOTE: One long message, and many short ones in batches of 4 messages.
+    print_throughput(
+        "hirose256_long", total_bytes,
+        [&]() { hirose.hash(out.data(), in.data(), total_bytes); }, "bytes");
+    for (size_t msg_bytes : {64, 1024}) {
+        const size_t num_msgs = total_bytes / msg_bytes;
+        vector<uint8_t> digests(hirose::digest_bytes * num_msgs);
+        print_throughput(
+            fmt::format("hirose256_single_{:d}B", msg_bytes), total_bytes,
+            [&]() {
+                for (size_t i = 0; i < num_msgs; i++) {
+                    hirose.hash(digests.data() + hirose::digest_bytes * i,
+                                in.data() + msg_bytes * i, msg_bytes);
+                }
+            },
+            "bytes");
+        print_throughput(
+            fmt::format("hirose256_batch_{:d}B", msg_bytes), total_bytes,
+            [&]() {
+                hirose.hash(digests.data(), in.data(), msg_bytes, num_msgs);
+            },
+            "bytes");
+        dummy_call(digests.data());
+    }
+#ifdef CLT_HAVE_OPENSSL
+    // NOTE: OpenSSL uses the SHA extensions if the CPU has them.
+    print_throughput(
+        "sha256_long", total_bytes,
+        [&]() {
+            EVP_Digest(in.data(), total_bytes, out.data(), nullptr,
+                       EVP_sha256(), nullptr);
+        },
+        "bytes");
+    for (size_t msg_bytes : {64, 1024}) {
+        const size_t num_msgs = total_bytes / msg_bytes;
+        print_throughput(
+            fmt::format("sha256_{:d}B", msg_bytes), total_bytes,
+            [&]() {
+                for (size_t i = 0; i < num_msgs; i++) {
+                    EVP_Digest(in.data() + msg_bytes * i, msg_bytes,
+                               out.data(), nullptr, EVP_sha256(), nullptr);
+                }
+            },
+            "bytes");
+    }
+#endif
+    dummy_call(out.data());
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <fmt/format.h>
+
+#include <clt/ot.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::bench;
+
+// NOTE: OTs per extend call, the in-process channel carries u of 128 columns
+// of call_ots bits (1 MiB) from the receiver to the sender.
+constexpr size_t call_ots = 1 << 16;
+
+int main()
+{
+    using block_t = AES128::block_t;
+    print_diagnosis();
+    vector<block_t> seeds0(ot::num_base_ots), seeds1(ot::num_base_ots);
+    vector<block_t> chosen(ot::num_base_ots);
+    for (size_t i = 0; i < ot::num_base_ots; i++) {
+        seeds0[i] = gen_key();
+        seeds1[i] = gen_key();
+    }
+    const block_t delta = gen_key();
+    for (size_t i = 0; i < ot::num_base_ots; i++) {
+        chosen[i] = ((delta[i / 8] >> (i % 8)) & 1) ? seeds1[i] : seeds0[i];
+    }
+
+    vector<uint8_t> in(ot::num_base_ots * call_ots / 8);
+    vector<block_t> rows(call_ots);
+    print_throughput(
+        "transpose_128xn", call_ots,
+        [&]() {
+            ot::transpose_128xn(rows.data(), in.data(), call_ots / 8,
+                                call_ots);
+        },
+        "OTs");
+    dummy_call(rows.data());
+
+    vector<uint8_t> choices(call_ots / 8, 0x5a);
+    vector<uint8_t> u(ot::num_base_ots * call_ots / 8);
+    vector<block_t> out(call_ots), out0(call_ots), out1(call_ots);
+    fmt::print("num_ots,receiver_sec,sender_sec,OTs/sec\n");
+    for (size_t log_ots = 20; log_ots <= 26; log_ots += 2) {
+        IKNPSender sender(delta.data(), chosen.data());
+        IKNPReceiver receiver(seeds0.data(), seeds1.data());
+        const size_t num_ots = size_t(1) << log_ots;
+        double receiver_time = 0, sender_time = 0;
+        for (size_t done = 0; done < num_ots; done += call_ots) {
+            receiver_time += measure_static([&]() {
+                receiver.extend(out.data(), u.data(), choices.data(),
+                                call_ots);
+            });
+            sender_time += measure_static([&]() {
+                sender.extend(out0.data(), out1.data(), u.data(), call_ots);
+            });
+            dummy_call(out.data());
+            dummy_call(out0.data());
+            dummy_call(out1.data());
+        }
+        fmt::print("{},{:e},{:e},{:e}\n", num_ots, receiver_time, sender_time,
+                   num_ots / (receiver_time + sender_time));
+    }
+    return 0;
+}
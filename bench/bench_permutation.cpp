@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <tuple>
+
+#include <fmt/format.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/shuffle.hpp>
+#include <clt/util_omp.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::rng;
+using namespace clt::bench;
+
+namespace {
+void inverse_permutation_by_sort(uint64_t *out, const uint64_t *in,
+                                 const size_t n)
+{
+    // NOTE: The former O(n log n) implementation, kept as a baseline.
+    using tuple_t = std::tuple<uint64_t, uint64_t>;
+    std::vector<tuple_t> t_vec;
+    t_vec.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        t_vec.emplace_back(in[i], i);
+    }
+    std::sort(t_vec.begin(), t_vec.end(),
+              [](const tuple_t &lhs, const tuple_t &rhs) -> bool {
+                  return std::get<0>(lhs) < std::get<0>(rhs);
+              });
+    for (size_t i = 0; i < n; i++) {
+        out[i] = std::get<1>(t_vec[i]);
+    }
+}
+} // namespace
+
+inline void do_permutation_iteration(const size_t max_exponent)
+{
+    const AES128::key_t key = gen_key();
+    AESPRF128_CTR prf(key.data());
+    fmt::print("mode,num_elems,sec,elems/sec\n");
+    const string fmt_str = "{},{},{:e},{:e}\n";
+    for (size_t e = 6; e <= max_exponent; e++) {
+        const auto n = static_cast<size_t>(std::pow(10, e));
+        Permutation perm(n);
+        shuffle_rounding(perm.indices_.data(), n, prf);
+        vector<uint64_t> in(n), out(n);
+        iota(begin(in), end(in), 0);
+        const auto *p_perm = perm.indices_.data();
+        auto run = [&](const string &label, auto &&func) {
+            const auto elapsed_time = measure_static(func);
+            dummy_call(out.data());
+            fmt::print(CLT_FMT_RUNTIME(fmt_str), label, n, elapsed_time,
+                       n / elapsed_time);
+        };
+        if (e <= 8) {
+            run("inverse_sort",
+                [&]() { inverse_permutation_by_sort(out.data(), p_perm, n); });
+        }
+        run("inverse_scatter",
+            [&]() { inverse_permutation(out.data(), p_perm, n); });
+        run("inverse_blocked",
+            [&]() { inverse_permutation_blocked(out.data(), p_perm, n); });
+        run("apply_gather",
+            [&]() { apply_permutation(out.data(), in.data(), p_perm, n); });
+        run("apply_blocked", [&]() {
+            apply_permutation_blocked(out.data(), in.data(), p_perm, n);
+        });
+        run("apply_scatter",
+            [&]() { scatter_permutation(out.data(), in.data(), p_perm, n); });
+        run("compose", [&]() {
+            const auto comp = perm * perm;
+            dummy_call(const_cast<uint64_t *>(comp.indices_.data()));
+        });
+    }
+}
+
+int main(int argc, char **argv)
+{
+    // NOTE: The largest size is 10^max_exponent elements, 10^9 by default.
+    const size_t max_exponent = (argc > 1) ? std::atoi(argv[1]) : 9;
+    print_diagnosis();
+    print_omp_diagnosis();
+    do_permutation_iteration(max_exponent);
+    return 0;
+}
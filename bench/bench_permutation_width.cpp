@@ -0,0 +1,55 @@
+#include <cmath>
+#include <cstdlib>
+
+#include <fmt/format.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/shuffle.hpp>
+#include <clt/util_omp.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::bench;
+
+template <class IndexType>
+inline void do_permutation_width_iteration(const size_t max_exponent)
+{
+    using perm_t = BasicPermutation<IndexType>;
+    const AES128::key_t key = gen_key();
+    AESPRF128_CTR prf(key.data());
+    const auto index_bits = sizeof(IndexType) * CHAR_BIT;
+    const string fmt_str = "{}_u{},{},{},{:e},{:e}\n";
+    for (size_t e = 6; e <= max_exponent; e++) {
+        const auto n = static_cast<size_t>(std::pow(10, e));
+        perm_t perm(n), other(n);
+        const auto num_bytes = n * sizeof(IndexType);
+        auto run = [&](const string &label, auto &&func) {
+            const auto elapsed_time = measure_static(func);
+            fmt::print(CLT_FMT_RUNTIME(fmt_str), label, index_bits, n,
+                       num_bytes, elapsed_time, n / elapsed_time);
+        };
+        run("shuffle", [&]() { perm.shuffle(prf); });
+        other.shuffle(prf);
+        run("apply", [&]() {
+            const auto comp = perm * other;
+            dummy_call(const_cast<IndexType *>(comp.indices_.data()));
+        });
+        run("inverse", [&]() {
+            const auto inv = perm.inverse();
+            dummy_call(const_cast<IndexType *>(inv.indices_.data()));
+        });
+    }
+}
+
+int main(int argc, char **argv)
+{
+    // NOTE: The largest degree is 10^max_exponent, 10^8 by default.
+    const size_t max_exponent = (argc > 1) ? std::atoi(argv[1]) : 8;
+    print_diagnosis();
+    print_omp_diagnosis();
+    fmt::print("mode,degree,total_bytes,sec,elems/sec\n");
+    do_permutation_width_iteration<uint64_t>(max_exponent);
+    do_permutation_width_iteration<uint32_t>(max_exponent);
+    return 0;
+}
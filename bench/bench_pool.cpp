@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <numeric>
+#include <thread>
+
+#include <clt/aes-ni.hpp>
+#include <clt/pool.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::bench;
+
+constexpr size_t request_bytes = 32;
+// NOTE: Buffer refilled at once by the inline buffered consumer.
+constexpr size_t inline_buffer_bytes = 1 << 16;
+
+template <class Func>
+inline void do_latency_iteration(const string &label, const size_t num_calls,
+                                 Func &&gen)
+{
+    using clock = chrono::steady_clock;
+    vector<double> latencies(num_calls);
+    array<uint8_t, request_bytes> out;
+    for (size_t i = 0; i < num_calls; i++) {
+        const auto start = clock::now();
+        gen(out.data());
+        const auto stop = clock::now();
+        dummy_call(out.data());
+        latencies[i] = chrono::duration<double, nano>(stop - start).count();
+    }
+    const auto mean =
+        accumulate(latencies.begin(), latencies.end(), 0.0) / num_calls;
+    const auto p50 = quantile(latencies, 0.5);
+    const auto p99 = quantile(latencies, 0.99);
+    const auto p999 = quantile(latencies, 0.999);
+    const auto p9999 = quantile(latencies, 0.9999);
+    const auto max = latencies.back();
+    fmt::print("{},{},{:.1f},{:.1f},{:.1f},{:.1f},{:.1f},{:.1f}\n", label,
+               num_calls, mean, p50, p99, p999, p9999, max);
+}
+
+int main(int argc, char **argv)
+{
+    print_diagnosis();
+    const size_t num_calls = (argc > 1) ? stoull(argv[1]) : (1 << 20);
+    fmt::print("mode,calls,mean_ns,p50_ns,p99_ns,p999_ns,p9999_ns,max_ns\n");
+    const auto key = gen_key();
+    AESPRF128_CTR ctr(key);
+    do_latency_iteration("aesprf_ctr_inline", num_calls,
+                         [&](void *out) { ctr(out, request_bytes); });
+    vector<uint8_t> buff(inline_buffer_bytes);
+    size_t pos = buff.size();
+    do_latency_iteration("aesprf_ctr_inline_buffered", num_calls,
+                         [&](void *out) {
+                             if (pos + request_bytes > buff.size()) {
+                                 ctr(buff.data(), buff.size());
+                                 pos = 0;
+                             }
+                             auto *p_out = reinterpret_cast<uint8_t *>(out);
+                             copy(buff.begin() + pos,
+                                  buff.begin() + pos + request_bytes, p_out);
+                             pos += request_bytes;
+                         });
+    RandomPool pool(key);
+    // NOTE: Let the producer fill the ring before measuring.
+    this_thread::sleep_for(chrono::milliseconds(10));
+    do_latency_iteration("pool", num_calls,
+                         [&](void *out) { pool(out, request_bytes); });
+    fmt::print(cerr, "# num_fallbacks = {}\n", pool.num_fallbacks());
+    return 0;
+}
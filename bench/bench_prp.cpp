@@ -0,0 +1,61 @@
+#include <numeric>
+
+#include <fmt/format.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/prp.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::bench;
+
+inline void do_prp_latency_iteration()
+{
+    constexpr size_t num_queries = 1 << 12;
+    const AES128::key_t key = gen_key();
+    fmt::print("mode,log2_domain_size,num_rounds,sec,ns/index\n");
+    for (size_t lg = 10; lg <= 40; lg += 6) {
+        const uint64_t n = uint64_t(1) << lg;
+        SwapOrNot prp(key, n);
+        uint64_t x = n / 3;
+        const auto elapsed_time = measure_static([&]() {
+            // NOTE: Chained queries, each depends on the previous result.
+            for (size_t i = 0; i < num_queries; i++) {
+                x = prp.forward(x);
+            }
+        });
+        dummy_call(&x);
+        fmt::print("swap_or_not_forward,{},{},{:e},{:e}\n", lg,
+                   prp.num_rounds(), elapsed_time,
+                   1e9 * elapsed_time / num_queries);
+    }
+}
+
+inline void do_prp_batch_iteration()
+{
+    constexpr size_t num_indices = 1 << 16;
+    const AES128::key_t key = gen_key();
+    vector<uint64_t> in(num_indices), out(num_indices);
+    fmt::print("mode,log2_domain_size,num_rounds,sec,indices/sec\n");
+    for (size_t lg = 10; lg <= 40; lg += 6) {
+        const uint64_t n = uint64_t(1) << lg;
+        SwapOrNot prp(key, n);
+        for (size_t i = 0; i < num_indices; i++) {
+            in[i] = (i * 0x9e3779b97f4a7c15ull) % n;
+        }
+        const auto elapsed_time = measure_static(
+            [&]() { prp.forward(out.data(), in.data(), num_indices); });
+        dummy_call(out.data());
+        fmt::print("swap_or_not_forward_batch,{},{},{:e},{:e}\n", lg,
+                   prp.num_rounds(), elapsed_time, num_indices / elapsed_time);
+    }
+}
+
+int main()
+{
+    print_diagnosis();
+    do_prp_latency_iteration();
+    do_prp_batch_iteration();
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <cmath>
+#include <cstdlib>
+
+#include <fmt/format.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/shuffle.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::rng;
+using namespace clt::bench;
+
+namespace {
+// NOTE: The former quadratic implementations, kept as a baseline.
+mpz_class rank_naive(const permutation_t &pi)
+{
+    const auto degree = pi.size();
+    auto pi_ = pi;
+    auto inv_pi = inverse_permutation(pi);
+    mpz_class r = 0, fact = 1;
+    vector<uint64_t> digits(degree + 1, 0);
+    for (size_t n = degree; n > 1; n--) {
+        const auto s = pi_[n - 1];
+        swap(pi_[n - 1], pi_[inv_pi[n - 1]]);
+        swap(inv_pi[s], inv_pi[n - 1]);
+        digits[n] = s;
+    }
+    for (size_t n = 2; n <= degree; n++) {
+        r = r * n + digits[n];
+        fact *= n;
+    }
+    return fact - r - 1;
+}
+
+permutation_t unrank_naive(const mpz_class &r, const size_t degree)
+{
+    permutation_t pi(degree);
+    iota(pi.begin(), pi.end(), 0);
+    mpz_class fact = 1;
+    for (size_t n = 2; n <= degree; n++) {
+        fact *= n;
+    }
+    mpz_class r_ = fact - r - 1;
+    for (size_t n = degree; n > 0; n--) {
+        const auto d = mpz_tdiv_q_ui(r_.get_mpz_t(), r_.get_mpz_t(), n);
+        swap(pi[n - 1], pi[d]);
+    }
+    return pi;
+}
+} // namespace
+
+inline void do_rank_iteration(const size_t max_exponent)
+{
+    const AES128::key_t key = gen_key();
+    AESPRF128_CTR prf(key.data());
+    fmt::print("mode,degree,sec,degree/sec\n");
+    const string fmt_str = "{},{},{:e},{:e}\n";
+    for (size_t e = 3; e <= max_exponent; e++) {
+        const auto n = static_cast<size_t>(std::pow(10, e));
+        Permutation perm(n);
+        perm.shuffle(prf);
+        mpz_class r;
+        permutation_t pi;
+        auto run = [&](const string &label, auto &&func) {
+            const auto elapsed_time = measure_static(func);
+            fmt::print(CLT_FMT_RUNTIME(fmt_str), label, n, elapsed_time,
+                       n / elapsed_time);
+        };
+        run("rank", [&]() { r = clt::rank(perm.indices_); });
+        run("unrank", [&]() { pi = clt::unrank(r, n); });
+        assert(pi == perm.indices_);
+        if (e <= 5) {
+            run("rank_naive", [&]() { r = rank_naive(perm.indices_); });
+            run("unrank_naive", [&]() { pi = unrank_naive(r, n); });
+            assert(pi == perm.indices_);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    // NOTE: The largest degree is 10^max_exponent, 10^6 by default.
+    const size_t max_exponent = (argc > 1) ? std::atoi(argv[1]) : 6;
+    print_diagnosis();
+    do_rank_iteration(max_exponent);
+    return 0;
+}
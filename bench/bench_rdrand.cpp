@@ -1,6 +1,7 @@
 #include <clt/aes-ni.hpp>
 #include <clt/rdrand.hpp>
 #include <clt/statistics.hpp>
+#include <clt/util_omp.hpp>
 #include <clt/benchmark.hpp>
 
 using namespace std;
@@ -29,9 +30,79 @@ inline void do_rdrand_iteration()
 #endif
 }
 
+/**
+ * Every thread fills its own chunks of a shared buffer, so the only shared
+ * resource is the hardware generator.
+ */
+template <class Func>
+inline void do_contention_iteration(const string &label, const size_t num_bytes,
+                                    Func &&gen)
+{
+    constexpr size_t chunk_elems = 1 << 9;
+    const size_t num_chunks = num_bytes / (sizeof(uint64_t) * chunk_elems);
+    vector<uint64_t> buff(num_bytes / sizeof(uint64_t));
+    const string fmt_str = label + ",{},{},{:e},{:e}\n";
+    for (int num_threads = 1; num_threads <= 64; num_threads <<= 1) {
+        bool ok = true;
+        const auto elapsed_time = measure_static([&]() {
+#pragma omp parallel num_threads(num_threads) reduction(&& : ok)
+            {
+                auto state = gen.init();
+#pragma omp for
+                for (size_t i = 0; i < num_chunks; i++) {
+                    if (!gen(state, buff.data() + i * chunk_elems,
+                             chunk_elems)) {
+                        ok = false;
+                    }
+                }
+            }
+        });
+        if (!ok) {
+            fmt::print(cerr, "WARN: {} failed with {} threads.\n", label,
+                       num_threads);
+        }
+        fmt::print(CLT_FMT_RUNTIME(fmt_str), num_threads, num_bytes,
+                   elapsed_time, num_bytes / elapsed_time);
+    }
+}
+
+struct RdrandGen {
+    int init() const noexcept { return 0; }
+    bool operator()(int, uint64_t *out, const size_t n) const noexcept
+    {
+        return rdrand(out, n);
+    }
+};
+
+struct RdseedGen {
+    int init() const noexcept { return 0; }
+    bool operator()(int, uint64_t *out, const size_t n) const noexcept
+    {
+        return rdseed(out, n);
+    }
+};
+
+struct HybridGen {
+    HybridRandom init() const { return HybridRandom(); }
+    bool operator()(HybridRandom &hrng, uint64_t *out,
+                    const size_t n) const noexcept
+    {
+        return hrng(out, sizeof(uint64_t) * n);
+    }
+};
+
 int main()
 {
     print_diagnosis();
+    print_omp_diagnosis();
     do_rdrand_iteration();
+    fmt::print("mode,num_threads,bytes,sec,bytes/sec\n");
+#if defined(__RDRND__) || defined(__APPLE__)
+    do_contention_iteration("rdrand", 1 << 24, RdrandGen{});
+#endif
+#if defined(__RDSEED__)
+    do_contention_iteration("rdseed", 1 << 20, RdseedGen{});
+#endif
+    do_contention_iteration("hybrid", 1 << 28, HybridGen{});
     return 0;
 }
@@ -0,0 +1,60 @@
+#include <mutex>
+
+#include <fmt/format.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/shared_ctr.hpp>
+#include <clt/util_omp.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::bench;
+
+constexpr size_t total_bytes = 1 << 28;
+
+template <class Func>
+inline void do_shared_iteration(const string &label, const size_t request_bytes,
+                                Func &&gen)
+{
+    const size_t num_calls = total_bytes / request_bytes;
+    const string fmt_str = label + ",{},{},{},{:e},{:e}\n";
+    for (int num_threads = 1; num_threads <= 64; num_threads <<= 1) {
+        const auto elapsed_time = measure_static([&]() {
+#pragma omp parallel num_threads(num_threads)
+            {
+                vector<uint8_t> out(request_bytes);
+#pragma omp for
+                for (size_t i = 0; i < num_calls; i++) {
+                    gen(out.data(), out.size());
+                }
+                dummy_call(out.data());
+            }
+        });
+        fmt::print(CLT_FMT_RUNTIME(fmt_str), num_threads, request_bytes,
+                   total_bytes, elapsed_time, total_bytes / elapsed_time);
+    }
+}
+
+int main()
+{
+    print_diagnosis();
+    print_omp_diagnosis();
+    fmt::print("mode,num_threads,request_bytes,bytes,sec,bytes/sec\n");
+    const auto key = gen_key();
+    for (size_t request_bytes : {size_t(64), size_t(1) << 12}) {
+        AESPRF128_SharedCTR shared_ctr(key);
+        do_shared_iteration("shared_ctr", request_bytes,
+                            [&](void *out, size_t num_bytes) {
+                                shared_ctr(out, num_bytes);
+                            });
+        AESPRF128_CTR ctr(key);
+        mutex mtx;
+        do_shared_iteration("mutex_ctr", request_bytes,
+                            [&](void *out, size_t num_bytes) {
+                                lock_guard<mutex> lock(mtx);
+                                ctr(out, num_bytes);
+                            });
+    }
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include <numeric>
+
+#include <fmt/format.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/shuffle.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::rng;
+using namespace clt::bench;
+
+template <class T>
+inline void do_shuffle_rounding_iteration(const string &label)
+{
+    constexpr size_t start_elems = 1 << 10;
+    constexpr size_t stop_elems = size_t(1) << 28;
+    const AES128::key_t key = gen_key();
+    AESPRF128_CTR prf(key.data());
+    size_t current = start_elems;
+    vector<T> buff;
+    buff.reserve(stop_elems);
+    while (current <= stop_elems) {
+        buff.resize(current);
+        iota(begin(buff), end(buff), 0);
+        // NOTE: The buffer itself is already resident here.
+        const auto base_rss = peak_rss_bytes();
+        const auto elapsed_time = measure_static(
+            [&]() { shuffle_rounding(buff.data(), size(buff), prf); });
+        dummy_call(reinterpret_cast<void *>(buff.data()));
+        const auto rss = peak_rss_bytes();
+        fmt::print("{},{},{:e},{:e},{},{}\n", label, current, elapsed_time,
+                   current / elapsed_time, rss, rss - base_rss);
+        current <<= 2;
+    }
+}
+
+int main()
+{
+    print_diagnosis();
+    fmt::print("mode,num_elems,sec,elems/sec,peak_rss_bytes,extra_rss_bytes\n");
+    do_shuffle_rounding_iteration<uint32_t>("shuffle_rounding_u32");
+    do_shuffle_rounding_iteration<uint64_t>("shuffle_rounding_u64");
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <fmt/format.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/simpira.hpp>
+#include <clt/rng.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::rng;
+using namespace clt::bench;
+
+constexpr size_t total_bytes = 1 << 26;
+
+template <size_t Blocks>
+inline void do_simpira_iteration(vector<uint8_t> &out, const vector<uint8_t> &in)
+{
+    using Perm = Simpira<Blocks>;
+    constexpr size_t n = Perm::state_bytes;
+    const size_t num_states = total_bytes / n;
+    const size_t bits = 8 * n;
+    // NOTE: One call per state, and one call for all states.
+    print_throughput(fmt::format("simpira{:d}_single", bits), total_bytes, [&]() {
+        for (size_t i = 0; i < num_states; i++) {
+            Perm::permute(out.data() + n * i, in.data() + n * i);
+        }
+    });
+    print_throughput(fmt::format("simpira{:d}_batch", bits), total_bytes, [&]() {
+        Perm::permute(out.data(), in.data(), num_states);
+    });
+    const WideBlockCipher<Blocks> cipher(gen_key().data());
+    print_throughput(fmt::format("wide_block{:d}_enc", bits), total_bytes,
+                     [&]() { cipher.enc(out.data(), in.data(), num_states); });
+    print_throughput(fmt::format("wide_block{:d}_dec", bits), total_bytes,
+                     [&]() { cipher.dec(out.data(), in.data(), num_states); });
+    dummy_call(out.data());
+}
+
+int main()
+{
+    print_diagnosis();
+    vector<uint8_t> in(total_bytes), out(total_bytes);
+    init(in);
+    // NOTE: The baseline is AES-128 of the same bytes.
+    const AES128 aes(gen_key());
+    print_throughput("aes128enc", total_bytes, [&]() {
+        aes.enc(out.data(), in.data(), total_bytes / aes128::block_bytes);
+    });
+    dummy_call(out.data());
+    do_simpira_iteration<2>(out, in);
+    do_simpira_iteration<4>(out, in);
+    do_simpira_iteration<8>(out, in);
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include <fmt/format.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/streams.hpp>
+#include <clt/util_omp.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::bench;
+
+constexpr size_t total_bytes = 1 << 28;
+
+int main()
+{
+    print_diagnosis();
+    print_omp_diagnosis();
+    fmt::print("mode,task_bytes,bytes,sec,bytes/sec\n");
+    const auto key = gen_key();
+    const AESPRF128_CTR base(key);
+    vector<uint8_t> buff(total_bytes);
+    const string fmt_str = "{},{},{},{:e},{:e}\n";
+    for (size_t task_bytes = 1 << 6; task_bytes <= (1 << 20);
+         task_bytes <<= 2) {
+        const size_t num_tasks = total_bytes / task_bytes;
+        auto ctr = base;
+        const auto serial_time = measure_static([&]() {
+            for (size_t i = 0; i < num_tasks; i++) {
+                ctr(buff.data() + i * task_bytes, task_bytes);
+            }
+        });
+        fmt::print(CLT_FMT_RUNTIME(fmt_str), "serial_stream", task_bytes,
+                   total_bytes, serial_time, total_bytes / serial_time);
+        const auto split_time = measure_static([&]() {
+            parallel_for_streams(base, num_tasks, [&](size_t i, auto &s) {
+                s(buff.data() + i * task_bytes, task_bytes);
+            });
+        });
+        fmt::print(CLT_FMT_RUNTIME(fmt_str), "split_streams", task_bytes,
+                   total_bytes, split_time, total_bytes / split_time);
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <cstdlib>
+#include <fstream>
+
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/hirose.hpp>
+#include <clt/tree_hash.hpp>
+#include <clt/rng.hpp>
+#include <clt/util_omp.hpp>
+#include <clt/benchmark.hpp>
+
+using namespace std;
+using namespace clt;
+using namespace clt::rng;
+using namespace clt::bench;
+
+constexpr size_t max_threads = 8;
+
+inline void do_tree_hash_iteration(const string &mode, const size_t num_bytes,
+                                   const function<void(bool)> &func)
+{
+    const string fmt_str = "{},{},{},{},{:e},{:e}\n";
+    const auto serial_time = measure_static([&]() { func(false); });
+    fmt::print(CLT_FMT_RUNTIME(fmt_str), mode, num_bytes, "serial", 1,
+               serial_time, num_bytes / serial_time);
+#ifdef _OPENMP
+    const auto default_threads = omp_get_max_threads();
+    for (size_t num_threads = 1; num_threads <= max_threads;
+         num_threads <<= 1) {
+        omp_set_num_threads(num_threads);
+        const auto parallel_time = measure_static([&]() { func(true); });
+        fmt::print(CLT_FMT_RUNTIME(fmt_str), mode, num_bytes, "parallel",
+                   num_threads, parallel_time, num_bytes / parallel_time);
+    }
+    omp_set_num_threads(default_threads);
+#endif
+}
+
+/**
+ * Usage: bench_tree_hash [file ...]
+ * Files are hashed by mmap, in addition to buffers in memory of 1 MiB to
+ * 1 GiB.
+ */
+int main(int argc, char **argv)
+{
+    print_diagnosis();
+    print_omp_diagnosis();
+    const TreeHash tree;
+    const Hirose256 hirose;
+    vector<uint8_t> out(tree_hash::digest_bytes);
+    // NOTE: The baseline is the serial chain of Hirose256.
+    constexpr size_t chain_bytes = 1 << 26;
+    vector<uint8_t> in(size_t(1) << 30);
+    init(in);
+    print_throughput(
+        "hirose256_chain", chain_bytes,
+        [&]() { hirose.hash(out.data(), in.data(), chain_bytes); }, "bytes");
+
+    fmt::print("mode,bytes,schedule,num_threads,sec,bytes/sec\n");
+    for (size_t log_bytes = 20; log_bytes <= 30; log_bytes += 5) {
+        const size_t n = size_t(1) << log_bytes;
+        do_tree_hash_iteration("tree_hash", n, [&](const bool parallel) {
+            tree.hash(out.data(), in.data(), n, parallel);
+        });
+    }
+    for (int i = 1; i < argc; i++) {
+        const string path = argv[i];
+        ifstream ifs(path, ios::binary | ios::ate);
+        const size_t n = ifs.tellg();
+        do_tree_hash_iteration(path, n, [&](const bool parallel) {
+            tree.hash_file(out.data(), path, parallel);
+        });
+    }
+    dummy_call(out.data());
+    return 0;
+}
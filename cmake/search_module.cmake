@@ -16,3 +16,6 @@ if(EXISTS ${BOOST_ROOT_MacPorts})
   set(BOOST_ROOT ${BOOST_ROOT_MacPorts})
 endif()
 find_package(Boost REQUIRED)
+
+# NOTE: Optional, SHA-256 baseline of the benchmarks.
+find_package(OpenSSL)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <cassert>
 #include <cstdint>
 #include <iomanip>
 #include <ostream>
@@ -18,6 +19,12 @@ inline auto bytes_to_blocks(const size_t num_bytes);
 inline auto allocate_byte_size(const size_t num_bytes);
 } // namespace aes128
 
+namespace aes256 {
+constexpr size_t block_bytes = 16;
+constexpr size_t key_bytes = 32;
+constexpr size_t num_rounds = 14;
+} // namespace aes256
+
 class AES128_CTR;
 class AES128 {
     uint8_t expanded_keys_[aes128::block_bytes * 2 * aes128::num_rounds];
@@ -35,16 +42,19 @@ public:
     void dec(void *out, const void *in) const noexcept;
     void dec(void *out, const void *in, const size_t num_blocks) const noexcept;
     auto ctr_stream(void *out, const uint64_t num_blocks,
-                    const uint64_t start_count) const noexcept
+                    const uint64_t start_count,
+                    const uint64_t stream_id = 0) const noexcept
         -> decltype(num_blocks + start_count);
     auto ctr_byte_stream(void *out, const uint64_t num_bytes,
-                         const uint64_t start_count) const noexcept
+                         const uint64_t start_count,
+                         const uint64_t stream_id = 0) const noexcept
         -> decltype(num_bytes + start_count);
 };
 
 class AES128_CTR {
     AES128 cipher_;
     uint64_t counter_;
+    uint64_t stream_id_;
 
 public:
     explicit AES128_CTR(const void *key) noexcept;
@@ -53,6 +63,28 @@ public:
     void operator()(void *out, const size_t num_bytes) noexcept;
     void set_counter(const uint64_t counter) noexcept { counter_ = counter; };
     auto get_counter() const noexcept { return counter_; };
+    /**
+     * Stream stream_id of the same key, starting at counter 0.
+     * The stream ID is the upper 64 bits of the counter block, so distinct
+     * streams never share a counter block. A generator is itself the
+     * stream get_stream_id(), 0 unless split, so splitting it into its own
+     * ID would replay its keystream from counter 0 and is not allowed.
+     * MMO128_CTR and AESPRF128_CTR split and jump in the same way.
+     */
+    auto split(const uint64_t stream_id) const noexcept
+    {
+        assert(stream_id != stream_id_);
+        auto x = *this;
+        x.counter_ = 0;
+        x.stream_id_ = stream_id;
+        return x;
+    }
+    /**
+     * Skip num_blocks blocks, i.e., the same as generating and discarding
+     * num_blocks * aes128::block_bytes bytes.
+     */
+    void jump(const uint64_t num_blocks) noexcept { counter_ += num_blocks; }
+    auto get_stream_id() const noexcept { return stream_id_; };
 };
 
 AES128::key_t gen_key();
@@ -78,21 +110,35 @@ public:
     void operator()(void *out, const void *in,
                     const size_t num_blocks) const noexcept;
     auto ctr_stream(void *out, const uint64_t num_blocks,
-                    const uint64_t start_count) const noexcept
+                    const uint64_t start_count,
+                    const uint64_t stream_id = 0) const noexcept
         -> decltype(num_blocks + start_count);
     auto ctr_byte_stream(void *out, const uint64_t num_bytes,
-                         const uint64_t start_count) const noexcept
+                         const uint64_t start_count,
+                         const uint64_t stream_id = 0) const noexcept
         -> decltype(num_bytes + start_count);
+    /**
+     * Tweakable circular correlation robust hash of num_blocks blocks,
+     * H(x, i) = pi(sigma(x) xor i) xor sigma(x), where i is the 64-bit
+     * tweaks[k] of block k and sigma(xl || xr) = (xl xor xr) || xl.
+     * Blocks are hashed in batches of 8 in parallel.
+     */
+    void tccr(void *out, const void *in, const uint64_t *tweaks,
+              const size_t num_blocks) const noexcept;
 };
 
 class MMO128_CTR {
     MMO128 prf_;
     uint64_t counter_;
+    uint64_t stream_id_;
 
 public:
-    explicit MMO128_CTR(const void *key) noexcept : prf_(key), counter_(0) {}
+    explicit MMO128_CTR(const void *key) noexcept
+        : prf_(key), counter_(0), stream_id_(0)
+    {
+    }
     explicit MMO128_CTR(const AES128::key_t &key) noexcept
-        : prf_(key), counter_{0}
+        : prf_(key), counter_{0}, stream_id_{0}
     {
     }
     MMO128_CTR() noexcept : MMO128_CTR(aes128::zero_key) {}
@@ -100,6 +146,17 @@ public:
     void operator()(void *out, const size_t num_bytes) noexcept;
     void set_counter(const uint64_t counter) noexcept { counter_ = counter; };
     auto get_counter() const noexcept { return counter_; };
+    // NOTE: See AES128_CTR::split and AES128_CTR::jump.
+    auto split(const uint64_t stream_id) const noexcept
+    {
+        assert(stream_id != stream_id_);
+        auto x = *this;
+        x.counter_ = 0;
+        x.stream_id_ = stream_id;
+        return x;
+    }
+    void jump(const uint64_t num_blocks) noexcept { counter_ += num_blocks; }
+    auto get_stream_id() const noexcept { return stream_id_; };
 };
 
 class AESPRF128_CTR;
@@ -123,26 +180,40 @@ public:
     void operator()(void *out, const void *in,
                     const size_t num_blocks) const noexcept;
     auto ctr_stream(void *out, const uint64_t num_blocks,
-                    const uint64_t start_count) const noexcept
+                    const uint64_t start_count,
+                    const uint64_t stream_id = 0) const noexcept
         -> decltype(num_blocks + start_count);
     auto ctr_byte_stream(void *out, const uint64_t num_bytes,
-                         const uint64_t start_count) const noexcept
+                         const uint64_t start_count,
+                         const uint64_t stream_id = 0) const noexcept
         -> decltype(num_bytes + start_count);
 };
 
 class AESPRF128_CTR {
     AESPRF128 prf_;
     uint64_t counter_;
+    uint64_t stream_id_;
 
 public:
     explicit AESPRF128_CTR(const void *key) noexcept;
     explicit AESPRF128_CTR(const AES128::key_t &key) noexcept
-        : prf_(key), counter_(0){};
+        : prf_(key), counter_(0), stream_id_(0){};
     AESPRF128_CTR() noexcept : AESPRF128_CTR(aes128::zero_key) {}
     friend std::ostream &operator<<(std::ostream &ost, const AESPRF128_CTR &x);
     void operator()(void *out, const size_t num_bytes) noexcept;
     void set_counter(const uint64_t counter) noexcept { counter_ = counter; };
     auto get_counter() const noexcept { return counter_; };
+    // NOTE: See AES128_CTR::split and AES128_CTR::jump.
+    auto split(const uint64_t stream_id) const noexcept
+    {
+        assert(stream_id != stream_id_);
+        auto x = *this;
+        x.counter_ = 0;
+        x.stream_id_ = stream_id;
+        return x;
+    }
+    void jump(const uint64_t num_blocks) noexcept { counter_ += num_blocks; }
+    auto get_stream_id() const noexcept { return stream_id_; };
 };
 } // namespace clt
 
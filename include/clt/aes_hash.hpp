@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+#include "aes-ni.hpp"
+
+namespace clt {
+namespace aes_hash {
+constexpr size_t max_rounds = 4;
+// NOTE: Independent chains of 16 bytes each, so a block of 64 bytes is
+// absorbed by 4 AESENC chains in parallel.
+constexpr size_t num_lanes = 4;
+constexpr size_t block_bytes = num_lanes * aes128::block_bytes;
+// NOTE: Keys hashed in parallel by the batched interface.
+constexpr size_t batch_width = 8;
+// NOTE: Default seed, the hexadecimal digits of pi following
+// cuckoo::default_key.
+constexpr uint8_t default_seed[aes128::key_bytes] = {
+    0xba, 0x7c, 0x90, 0x45, 0xf1, 0x2c, 0x7f, 0x99,
+    0x24, 0xa1, 0x99, 0x47, 0xb3, 0x91, 0x6c, 0xf7};
+} // namespace aes_hash
+
+template <size_t Rounds = 2> class AESRoundHash {
+    /**
+     * Non-cryptographic hash of byte strings for hash tables and sharding,
+     * in the spirit of aHash and Meow hash; it is NOT collision resistant
+     * against adversarial inputs.
+     * The round keys k_0, ..., k_10 are the AES-128 key schedule of the
+     * seed. Input is absorbed by blocks of 64 bytes into 4 lanes initialized
+     * to k_0, ..., k_3, where lane j absorbs the 16-byte chunk c by
+     * s_j = AESENC(... AESENC(s_j xor c, k_1) ..., k_Rounds).
+     * The last block of 0 to 64 bytes is read by overlapping loads, the
+     * lanes in use are folded by AESENC into one, and the length is xored
+     * before Rounds AESENC rounds and AESENCLAST with k_{10 - Rounds}, ...,
+     * k_10.
+     * References:
+     * - "aHash"
+     * https://github.com/tkaitchuck/aHash
+     * - Muratori, "Meow hash"
+     * https://github.com/cmuratori/meow_hash
+     */
+    static_assert((1 <= Rounds) && (Rounds <= aes_hash::max_rounds));
+    uint8_t expanded_keys_[aes128::block_bytes * (aes128::num_rounds + 1)];
+
+public:
+    using digest_t = AES128::block_t;
+    explicit AESRoundHash(
+        const void *seed = aes_hash::default_seed) noexcept;
+    template <size_t R>
+    friend std::ostream &operator<<(std::ostream &ost,
+                                    const AESRoundHash<R> &x);
+    const uint8_t *expanded_keys() const noexcept { return expanded_keys_; }
+    /**
+     * 128-bit digest of num_bytes bytes of in.
+     */
+    void hash128(void *out, const void *in,
+                 const size_t num_bytes) const noexcept;
+    /**
+     * The lower 64 bits of hash128.
+     */
+    uint64_t hash64(const void *in, const size_t num_bytes) const noexcept;
+    /**
+     * hash64 of num_keys consecutive keys of key_bytes bytes each, by
+     * batches of aes_hash::batch_width keys in parallel.
+     */
+    void hash64(uint64_t *out, const void *keys, const size_t key_bytes,
+                const size_t num_keys) const noexcept;
+};
+
+template <size_t Rounds = 2> class AESRoundHashStream {
+    /**
+     * Streaming interface of AESRoundHash with the same digests: blocks of
+     * 64 bytes are absorbed once more input follows them, so the last
+     * block is always in the buffer.
+     */
+    AESRoundHash<Rounds> hash_;
+    AES128::block_t states_[aes_hash::num_lanes];
+    uint8_t buffer_[aes_hash::block_bytes];
+    size_t buffered_;
+    uint64_t num_bytes_;
+
+public:
+    explicit AESRoundHashStream(
+        const void *seed = aes_hash::default_seed) noexcept;
+    template <size_t R>
+    friend std::ostream &operator<<(std::ostream &ost,
+                                    const AESRoundHashStream<R> &x);
+    auto num_bytes() const noexcept { return num_bytes_; }
+    void update(const void *in, const size_t num_bytes) noexcept;
+    void digest128(void *out) const noexcept;
+    uint64_t digest64() const noexcept;
+};
+
+template <size_t R>
+inline std::ostream &operator<<(std::ostream &ost, const AESRoundHash<R> &x)
+{
+    ost << fmt::format("AESRoundHash<{:d}>[seed=[{:>02x}]]", R,
+                       fmt::join(x.expanded_keys_,
+                                 x.expanded_keys_ + aes128::key_bytes, ":"));
+    return ost;
+}
+
+template <size_t R>
+inline std::ostream &operator<<(std::ostream &ost,
+                                const AESRoundHashStream<R> &x)
+{
+    ost << fmt::format("AESRoundHashStream<{:d}>[num_bytes={:d}]", R,
+                       x.num_bytes_);
+    return ost;
+}
+} // namespace clt
+
+#include "detail/aes_hash_impl.hpp"
@@ -3,6 +3,8 @@
 #include <iostream>
 #include <chrono>
 #include <functional>
+#include <algorithm>
+#include <cmath>
 
 #include <fmt/format.h>
 #include <fmt/ostream.h>
@@ -43,6 +45,7 @@ double measure_walltime_milli(const std::function<void()> &func);
 double measure_walltime_micro(const std::function<void()> &func);
 double measure_walltime_nano(const std::function<void()> &func);
 double measure_static(const std::function<void()> &func);
+size_t peak_rss_bytes();
 
 inline bool print_throughput_call_once(const std::string &unit_label = "bytes")
 {
@@ -110,6 +113,22 @@ template <class T> typename T::value_type median(T &vs)
     }
 }
 
+/**
+ * Nearest-rank quantile for q in [0, 1]. Sorts vs in place.
+ */
+template <class T> typename T::value_type quantile(T &vs, const double q)
+{
+    using std::begin;
+    using std::end;
+    using std::size;
+    using std::sort;
+
+    sort(begin(vs), end(vs));
+    const auto n = size(vs);
+    const auto rank = static_cast<size_t>(std::ceil(q * n));
+    return vs[(rank == 0) ? 0 : (rank - 1)];
+}
+
 } // namespace bench
 } // namespace clt
 
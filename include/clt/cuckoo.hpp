@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "aes-ni.hpp"
+
+namespace clt {
+namespace cuckoo {
+// NOTE: 32 bits of the AES output per hash function.
+constexpr size_t max_hashes = 4;
+constexpr size_t default_num_hashes = 3;
+// NOTE: Evictions of an insertion before the homeless item goes to the
+// stash.
+constexpr size_t max_evictions = 512;
+// NOTE: Items whose bins are prefetched ahead of insertion.
+constexpr size_t prefetch_distance = 16;
+// NOTE: Fixed public key of the hash functions, the hexadecimal digits of pi
+// following gc::default_hash_key.
+constexpr uint8_t default_key[aes128::key_bytes] = {
+    0x2f, 0xfd, 0x72, 0xdb, 0xd0, 0x1a, 0xdf, 0xb7,
+    0xb8, 0xe1, 0xaf, 0xed, 0x6a, 0x26, 0x7e, 0x96};
+// NOTE: Entries of bins are the item index and the hash function packed as
+// (index << 2) | function, or empty.
+constexpr uint64_t empty = UINT64_MAX;
+constexpr uint64_t pack(const uint64_t index, const size_t func) noexcept
+{
+    return (index << 2) | func;
+}
+constexpr uint64_t index_of(const uint64_t entry) noexcept
+{
+    return entry >> 2;
+}
+constexpr size_t func_of(const uint64_t entry) noexcept { return entry & 3; }
+} // namespace cuckoo
+
+class MultiHash {
+    /**
+     * num_hashes bin indices in [0, num_bins) of 128-bit items from one AES
+     * call per item: AES128_k(x) with a fixed key is split into 32-bit words
+     * w_0, ..., w_3, and bin h is (w_h * num_bins) >> 32.
+     * Items are encrypted in batches of 8 in parallel.
+     * References:
+     * - Lemire, "Fast Random Integer Generation in an Interval"
+     * https://arxiv.org/abs/1805.10941
+     */
+    uint8_t expanded_keys_[aes128::block_bytes * (aes128::num_rounds + 1)];
+    uint64_t num_bins_;
+    size_t num_hashes_;
+
+public:
+    MultiHash(const uint64_t num_bins,
+              const size_t num_hashes = cuckoo::default_num_hashes,
+              const void *key = cuckoo::default_key);
+    friend std::ostream &operator<<(std::ostream &ost, const MultiHash &x);
+    auto num_bins() const noexcept { return num_bins_; }
+    auto num_hashes() const noexcept { return num_hashes_; }
+    /**
+     * Bins of items[i] into out[num_hashes * i + h] for h in
+     * [0, num_hashes), in parallel by OpenMP if parallel is true.
+     */
+    void operator()(uint32_t *out, const void *items, const size_t num_items,
+                    const bool parallel = false) const noexcept;
+};
+
+class CuckooTable {
+    /**
+     * Cuckoo hashing of items into bins of at most one item each.
+     * An item goes to the first empty bin among its num_hashes bins;
+     * otherwise it evicts the occupant of one of them, which moves to its
+     * next hash function in turn. An item still homeless after
+     * cuckoo::max_evictions evictions goes to the stash.
+     * Bins of the item cuckoo::prefetch_distance items ahead are
+     * prefetched.
+     * References:
+     * - Pagh, Rodler, "Cuckoo Hashing"
+     * https://doi.org/10.1016/j.jalgor.2003.12.002
+     * - Pinkas, Schneider, Zohner, "Scalable Private Set Intersection Based
+     * on OT Extension"
+     * https://eprint.iacr.org/2016/930
+     */
+    MultiHash hash_;
+    std::vector<uint64_t> bins_;
+    std::vector<uint64_t> stash_;
+
+public:
+    CuckooTable(const uint64_t num_bins,
+                const size_t num_hashes = cuckoo::default_num_hashes,
+                const void *key = cuckoo::default_key)
+        : hash_(num_bins, num_hashes, key)
+    {
+    }
+    friend std::ostream &operator<<(std::ostream &ost, const CuckooTable &x);
+    const auto &hash() const noexcept { return hash_; }
+    /**
+     * Packed entries of bins, or cuckoo::empty.
+     */
+    const auto &bins() const noexcept { return bins_; }
+    /**
+     * Indices of the items in the stash.
+     */
+    const auto &stash() const noexcept { return stash_; }
+    /**
+     * Insert num_items 128-bit items, replacing the previous ones.
+     * Items are hashed in parallel by OpenMP if parallel is true.
+     */
+    void build(const void *items, const size_t num_items,
+               const bool parallel = false);
+};
+
+class SimpleHashing {
+    /**
+     * Simple hashing of items into every one of their num_hashes bins, the
+     * other side of cuckoo hashing in PSI. Bins are in the CSR layout: bin b
+     * is entries()[offsets()[b], offsets()[b + 1]) in the order of items,
+     * and an item is repeated if two of its hash functions collide.
+     */
+    MultiHash hash_;
+    std::vector<uint64_t> offsets_;
+    std::vector<uint64_t> entries_;
+
+public:
+    SimpleHashing(const uint64_t num_bins,
+                  const size_t num_hashes = cuckoo::default_num_hashes,
+                  const void *key = cuckoo::default_key)
+        : hash_(num_bins, num_hashes, key)
+    {
+    }
+    friend std::ostream &operator<<(std::ostream &ost,
+                                    const SimpleHashing &x);
+    const auto &hash() const noexcept { return hash_; }
+    const auto &offsets() const noexcept { return offsets_; }
+    /**
+     * Packed entries of all bins.
+     */
+    const auto &entries() const noexcept { return entries_; }
+    uint64_t max_bin_size() const noexcept;
+    /**
+     * Insert num_items 128-bit items, replacing the previous ones.
+     * Items are hashed in parallel by OpenMP if parallel is true.
+     */
+    void build(const void *items, const size_t num_items,
+               const bool parallel = false);
+};
+
+inline std::ostream &operator<<(std::ostream &ost, const MultiHash &x)
+{
+    ost << fmt::format("MultiHash[num_bins={:d},num_hashes={:d}]",
+                       x.num_bins_, x.num_hashes_);
+    return ost;
+}
+
+inline std::ostream &operator<<(std::ostream &ost, const CuckooTable &x)
+{
+    ost << fmt::format("CuckooTable[num_bins={:d},num_hashes={:d},"
+                       "stash={:d}]",
+                       x.hash_.num_bins(), x.hash_.num_hashes(),
+                       x.stash_.size());
+    return ost;
+}
+
+inline std::ostream &operator<<(std::ostream &ost, const SimpleHashing &x)
+{
+    ost << fmt::format("SimpleHashing[num_bins={:d},num_hashes={:d},"
+                       "entries={:d}]",
+                       x.hash_.num_bins(), x.hash_.num_hashes(),
+                       x.entries_.size());
+    return ost;
+}
+} // namespace clt
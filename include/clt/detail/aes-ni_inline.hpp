@@ -42,7 +42,7 @@ inline std::ostream &operator<<(std::ostream &ost, const AES128 &x)
     return ost;
 }
 inline AES128_CTR::AES128_CTR(const void *key) noexcept
-    : cipher_(key), counter_(0)
+    : cipher_(key), counter_(0), stream_id_(0)
 {
 }
 inline std::ostream &operator<<(std::ostream &ost, const AES128_CTR &x)
@@ -52,7 +52,8 @@ inline std::ostream &operator<<(std::ostream &ost, const AES128_CTR &x)
     constexpr size_t num_exp_keys =
         sizeof(x.cipher_.expanded_keys_) / aes128::block_bytes;
     ost << "AES128_CTR[";
-    ost << fmt::format("counter={:d},", x.counter_);
+    ost << fmt::format("counter={:d},stream_id={:d},", x.counter_,
+                       x.stream_id_);
     for (size_t i = 0; i < num_exp_keys; i++) {
         ost << fmt::format(
             "[{:>02x}]",
@@ -65,7 +66,7 @@ inline std::ostream &operator<<(std::ostream &ost, const AES128_CTR &x)
 }
 inline void AES128_CTR::operator()(void *out, const size_t num_bytes) noexcept
 {
-    counter_ = cipher_.ctr_byte_stream(out, num_bytes, counter_);
+    counter_ = cipher_.ctr_byte_stream(out, num_bytes, counter_, stream_id_);
 }
 
 inline std::ostream &operator<<(std::ostream &ost, const MMO128 &x)
@@ -89,7 +90,8 @@ inline std::ostream &operator<<(std::ostream &ost, const MMO128_CTR &x)
     constexpr size_t num_exp_keys =
         sizeof(x.prf_.expanded_keys_) / aes128::block_bytes;
     ost << "MMO128_CTR[";
-    ost << fmt::format("counter={:d},", x.counter_);
+    ost << fmt::format("counter={:d},stream_id={:d},", x.counter_,
+                       x.stream_id_);
     for (size_t i = 0; i < num_exp_keys; i++) {
         ost << fmt::format(
             "[{:>02x}]",
@@ -102,7 +104,7 @@ inline std::ostream &operator<<(std::ostream &ost, const MMO128_CTR &x)
 }
 inline void MMO128_CTR::operator()(void *out, const size_t num_bytes) noexcept
 {
-    counter_ = prf_.ctr_byte_stream(out, num_bytes, counter_);
+    counter_ = prf_.ctr_byte_stream(out, num_bytes, counter_, stream_id_);
 }
 
 inline std::ostream &operator<<(std::ostream &ost, const AESPRF128 &x)
@@ -121,7 +123,7 @@ inline std::ostream &operator<<(std::ostream &ost, const AESPRF128 &x)
     return ost;
 }
 inline AESPRF128_CTR::AESPRF128_CTR(const void *key) noexcept
-    : prf_(key), counter_(0)
+    : prf_(key), counter_(0), stream_id_(0)
 {
 }
 inline std::ostream &operator<<(std::ostream &ost, const AESPRF128_CTR &x)
@@ -130,7 +132,8 @@ inline std::ostream &operator<<(std::ostream &ost, const AESPRF128_CTR &x)
     constexpr size_t num_exp_keys =
         sizeof(x.prf_.expanded_keys_) / aes128::block_bytes;
     ost << "AESPRF128_CTR[";
-    ost << fmt::format("counter={:d},", x.counter_);
+    ost << fmt::format("counter={:d},stream_id={:d},", x.counter_,
+                       x.stream_id_);
     for (size_t i = 0; i < num_exp_keys; i++) {
         ost << fmt::format(
             "[{:>02x}]",
@@ -144,6 +147,6 @@ inline std::ostream &operator<<(std::ostream &ost, const AESPRF128_CTR &x)
 inline void AESPRF128_CTR::operator()(void *out,
                                       const size_t num_bytes) noexcept
 {
-    counter_ = prf_.ctr_byte_stream(out, num_bytes, counter_);
+    counter_ = prf_.ctr_byte_stream(out, num_bytes, counter_, stream_id_);
 }
 } // namespace clt
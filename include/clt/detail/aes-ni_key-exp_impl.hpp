@@ -31,6 +31,35 @@ inline void aes128_key_expansion_impl(__m128i *keys)
 
 template <> inline void aes128_key_expansion_impl<10, 0>(__m128i *) {}
 
+/**
+ * AES-256 round keys keys[N], ..., keys[14] from keys[0], keys[1], the two
+ * halves of the key, where keys[2 i] uses RotWord and rcon and keys[2 i + 1]
+ * only SubWord.
+ * NOTE: SubWord is AESENCLAST of the last word broadcast to all columns, on
+ * which ShiftRows is the identity; AESKEYGENASSIST has a much lower
+ * throughput, which bounds hashing with a key schedule per block.
+ */
+template <size_t N> inline void aes256_key_expansion_impl(__m128i *keys)
+{
+    static_assert(2 <= N);
+    if constexpr (N <= aes256::num_rounds) {
+        if constexpr ((N % 2) == 0) {
+            const auto rot_word = _mm_setr_epi8(13, 14, 15, 12, 13, 14, 15, 12,
+                                                13, 14, 15, 12, 13, 14, 15, 12);
+            const auto key_ass = _mm_aesenclast_si128(
+                _mm_shuffle_epi8(keys[N - 1], rot_word),
+                _mm_set1_epi32(rcon_array[N / 2 - 1]));
+            keys[N] = aes128_key_expansion_shift_xor(keys[N - 2], key_ass);
+        } else {
+            const auto key_ass = _mm_aesenclast_si128(
+                _mm_shuffle_epi32(keys[N - 1], _MM_SHUFFLE(3, 3, 3, 3)),
+                _mm_setzero_si128());
+            keys[N] = aes128_key_expansion_shift_xor(keys[N - 2], key_ass);
+        }
+        aes256_key_expansion_impl<N + 1>(keys);
+    }
+}
+
 template <size_t N> inline void aes128_key_expansion_imc_impl(__m128i *keys)
 {
     static_assert(0 <= N);
@@ -40,5 +69,14 @@ template <size_t N> inline void aes128_key_expansion_imc_impl(__m128i *keys)
 }
 
 template <> inline void aes128_key_expansion_imc_impl<9>(__m128i *) {}
+
+inline void aes128_load_expkey_for_enc(__m128i *keys,
+                                       const uint8_t *in) noexcept
+{
+    const auto *p_in = reinterpret_cast<const __m128i *>(in);
+    for (size_t i = 0; i < (aes128::num_rounds + 1); i++) {
+        keys[i] = _mm_loadu_si128(p_in + i);
+    }
+}
 } // namespace internal
 } // namespace clt
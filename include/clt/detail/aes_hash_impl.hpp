@@ -0,0 +1,268 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+
+#include <x86intrin.h>
+
+#include "../aes_hash.hpp"
+
+namespace clt {
+namespace internal {
+template <size_t R>
+inline __m128i aes_hash_absorb(__m128i s, const __m128i c,
+                               const __m128i *keys) noexcept
+{
+    s = _mm_xor_si128(s, c);
+    for (size_t r = 1; r <= R; r++) {
+        s = _mm_aesenc_si128(s, keys[r]);
+    }
+    return s;
+}
+
+inline void aes_hash_init(__m128i *ss, const __m128i *keys) noexcept
+{
+    std::copy_n(keys, aes_hash::num_lanes, ss);
+}
+
+template <size_t R>
+inline void aes_hash_absorb_block(__m128i *ss, const uint8_t *p,
+                                  const __m128i *keys) noexcept
+{
+    const auto *p_in = reinterpret_cast<const __m128i *>(p);
+    for (size_t j = 0; j < aes_hash::num_lanes; j++) {
+        ss[j] = aes_hash_absorb<R>(ss[j], _mm_loadu_si128(p_in + j), keys);
+    }
+}
+
+/**
+ * Chunk of n < 16 bytes by two overlapping loads, injective for a fixed n.
+ */
+inline __m128i aes_hash_load_small(const uint8_t *p, const size_t n) noexcept
+{
+    if (n >= 8) {
+        uint64_t lo, hi;
+        std::memcpy(&lo, p, sizeof(lo));
+        std::memcpy(&hi, p + n - 8, sizeof(hi));
+        return _mm_set_epi64x(hi, lo);
+    } else if (n >= 4) {
+        uint32_t lo, hi;
+        std::memcpy(&lo, p, sizeof(lo));
+        std::memcpy(&hi, p + n - 4, sizeof(hi));
+        return _mm_set_epi64x(hi, lo);
+    } else if (n > 0) {
+        return _mm_cvtsi32_si128(p[0] | (p[n / 2] << 8) | (p[n - 1] << 16));
+    } else {
+        return _mm_setzero_si128();
+    }
+}
+
+/**
+ * Last block of n <= 64 bytes, chunk j into lane j, where the last chunk
+ * overlaps the previous one.
+ */
+template <size_t R>
+inline void aes_hash_absorb_final(__m128i *ss, const uint8_t *p,
+                                  const size_t n, const __m128i *keys) noexcept
+{
+    if (n < aes128::block_bytes) {
+        ss[0] = aes_hash_absorb<R>(ss[0], aes_hash_load_small(p, n), keys);
+        return;
+    }
+    const auto *p_in = reinterpret_cast<const __m128i *>(p);
+    const size_t num_chunks = (n + aes128::block_bytes - 1) /
+                              aes128::block_bytes;
+    for (size_t j = 0; (j + 1) < num_chunks; j++) {
+        ss[j] = aes_hash_absorb<R>(ss[j], _mm_loadu_si128(p_in + j), keys);
+    }
+    const auto c = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(p + n - aes128::block_bytes));
+    ss[num_chunks - 1] = aes_hash_absorb<R>(ss[num_chunks - 1], c, keys);
+}
+
+/**
+ * The lanes in use folded into one, xored with the length.
+ */
+inline __m128i aes_hash_fold(__m128i *ss, const uint64_t num_bytes) noexcept
+{
+    const size_t num_lanes =
+        (num_bytes > aes_hash::block_bytes)
+            ? aes_hash::num_lanes
+            : std::max<size_t>(1, (num_bytes + aes128::block_bytes - 1) /
+                                      aes128::block_bytes);
+    if (num_lanes > 3) {
+        ss[2] = _mm_aesenc_si128(ss[2], ss[3]);
+    }
+    if (num_lanes > 2) {
+        ss[0] = _mm_aesenc_si128(ss[0], ss[2]);
+    }
+    if (num_lanes > 1) {
+        ss[0] = _mm_aesenc_si128(ss[0], ss[1]);
+    }
+    return _mm_xor_si128(ss[0], _mm_cvtsi64_si128(num_bytes));
+}
+
+template <size_t R>
+inline __m128i aes_hash_impl(const uint8_t *p, const size_t num_bytes,
+                             const __m128i *keys) noexcept
+{
+    __m128i ss[aes_hash::num_lanes];
+    aes_hash_init(ss, keys);
+    size_t n = num_bytes;
+    for (; n > aes_hash::block_bytes; n -= aes_hash::block_bytes) {
+        aes_hash_absorb_block<R>(ss, p, keys);
+        p += aes_hash::block_bytes;
+    }
+    aes_hash_absorb_final<R>(ss, p, n, keys);
+    auto m = aes_hash_fold(ss, num_bytes);
+    single::aes128_enc_impl<aes128::num_rounds - R>(m, keys);
+    return m;
+}
+} // namespace internal
+
+template <size_t Rounds>
+AESRoundHash<Rounds>::AESRoundHash(const void *seed) noexcept
+{
+    __m128i keys[aes128::num_rounds + 1];
+    static_assert(sizeof(keys) == sizeof(expanded_keys_));
+    keys[0] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(seed));
+    internal::aes128_key_expansion_impl<0>(keys);
+    auto *p_out = reinterpret_cast<__m128i *>(expanded_keys_);
+    for (size_t i = 0; i < std::size(keys); i++) {
+        _mm_storeu_si128(p_out + i, keys[i]);
+    }
+}
+
+template <size_t Rounds>
+void AESRoundHash<Rounds>::hash128(void *out, const void *in,
+                                   const size_t num_bytes) const noexcept
+{
+    __m128i keys[aes128::num_rounds + 1];
+    internal::aes128_load_expkey_for_enc(keys, expanded_keys_);
+    const auto m = internal::aes_hash_impl<Rounds>(
+        reinterpret_cast<const uint8_t *>(in), num_bytes, keys);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), m);
+}
+
+template <size_t Rounds>
+uint64_t AESRoundHash<Rounds>::hash64(const void *in,
+                                      const size_t num_bytes) const noexcept
+{
+    __m128i keys[aes128::num_rounds + 1];
+    internal::aes128_load_expkey_for_enc(keys, expanded_keys_);
+    return _mm_cvtsi128_si64(internal::aes_hash_impl<Rounds>(
+        reinterpret_cast<const uint8_t *>(in), num_bytes, keys));
+}
+
+template <size_t Rounds>
+void AESRoundHash<Rounds>::hash64(uint64_t *out, const void *keys,
+                                  const size_t key_bytes,
+                                  const size_t num_keys) const noexcept
+{
+    constexpr size_t W = aes_hash::batch_width;
+    __m128i rkeys[aes128::num_rounds + 1];
+    internal::aes128_load_expkey_for_enc(rkeys, expanded_keys_);
+    const auto *p_keys = reinterpret_cast<const uint8_t *>(keys);
+    size_t i = 0;
+    for (; (i + W) <= num_keys; i += W) {
+        // NOTE: W keys in lock step, so that their AESENC chains are
+        // independent.
+        const auto *p = p_keys + key_bytes * i;
+        __m128i ss[W][aes_hash::num_lanes], ms[W];
+        for (size_t k = 0; k < W; k++) {
+            internal::aes_hash_init(ss[k], rkeys);
+        }
+        size_t n = key_bytes;
+        for (; n > aes_hash::block_bytes; n -= aes_hash::block_bytes) {
+            for (size_t k = 0; k < W; k++) {
+                internal::aes_hash_absorb_block<Rounds>(
+                    ss[k], p + key_bytes * k, rkeys);
+            }
+            p += aes_hash::block_bytes;
+        }
+        for (size_t k = 0; k < W; k++) {
+            internal::aes_hash_absorb_final<Rounds>(ss[k], p + key_bytes * k,
+                                                    n, rkeys);
+            ms[k] = internal::aes_hash_fold(ss[k], key_bytes);
+        }
+        using internal::sfinae::aes128_enc_impl;
+        using internal::sfinae::width_round_t;
+        aes128_enc_impl(ms, width_round_t<W, aes128::num_rounds - Rounds>{},
+                        rkeys);
+        for (size_t k = 0; k < W; k++) {
+            out[i + k] = _mm_cvtsi128_si64(ms[k]);
+        }
+    }
+    for (; i < num_keys; i++) {
+        out[i] = _mm_cvtsi128_si64(internal::aes_hash_impl<Rounds>(
+            p_keys + key_bytes * i, key_bytes, rkeys));
+    }
+}
+
+template <size_t Rounds>
+AESRoundHashStream<Rounds>::AESRoundHashStream(const void *seed) noexcept
+    : hash_(seed), buffered_(0), num_bytes_(0)
+{
+    std::copy_n(hash_.expanded_keys(), sizeof(states_),
+                reinterpret_cast<uint8_t *>(states_));
+}
+
+template <size_t Rounds>
+void AESRoundHashStream<Rounds>::update(const void *in,
+                                        const size_t num_bytes) noexcept
+{
+    __m128i keys[aes128::num_rounds + 1], ss[aes_hash::num_lanes];
+    internal::aes128_load_expkey_for_enc(keys, hash_.expanded_keys());
+    const auto *p_states = reinterpret_cast<const __m128i *>(states_);
+    for (size_t j = 0; j < aes_hash::num_lanes; j++) {
+        ss[j] = _mm_loadu_si128(p_states + j);
+    }
+    const auto *p = reinterpret_cast<const uint8_t *>(in);
+    size_t n = num_bytes;
+    while (n > 0) {
+        if (buffered_ == aes_hash::block_bytes) {
+            internal::aes_hash_absorb_block<Rounds>(ss, buffer_, keys);
+            buffered_ = 0;
+        }
+        if (buffered_ == 0) {
+            // NOTE: Whole blocks followed by more input skip the buffer.
+            for (; n > aes_hash::block_bytes; n -= aes_hash::block_bytes) {
+                internal::aes_hash_absorb_block<Rounds>(ss, p, keys);
+                p += aes_hash::block_bytes;
+            }
+        }
+        const size_t m = std::min(n, aes_hash::block_bytes - buffered_);
+        std::copy_n(p, m, buffer_ + buffered_);
+        buffered_ += m;
+        p += m;
+        n -= m;
+    }
+    for (size_t j = 0; j < aes_hash::num_lanes; j++) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(states_) + j, ss[j]);
+    }
+    num_bytes_ += num_bytes;
+}
+
+template <size_t Rounds>
+void AESRoundHashStream<Rounds>::digest128(void *out) const noexcept
+{
+    __m128i keys[aes128::num_rounds + 1], ss[aes_hash::num_lanes];
+    internal::aes128_load_expkey_for_enc(keys, hash_.expanded_keys());
+    const auto *p_states = reinterpret_cast<const __m128i *>(states_);
+    for (size_t j = 0; j < aes_hash::num_lanes; j++) {
+        ss[j] = _mm_loadu_si128(p_states + j);
+    }
+    internal::aes_hash_absorb_final<Rounds>(ss, buffer_, buffered_, keys);
+    auto m = internal::aes_hash_fold(ss, num_bytes_);
+    internal::single::aes128_enc_impl<aes128::num_rounds - Rounds>(m, keys);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), m);
+}
+
+template <size_t Rounds>
+uint64_t AESRoundHashStream<Rounds>::digest64() const noexcept
+{
+    uint64_t digest[2];
+    digest128(digest);
+    return digest[0];
+}
+} // namespace clt
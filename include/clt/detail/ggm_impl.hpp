@@ -0,0 +1,36 @@
+#pragma once
+
+#include <x86intrin.h>
+
+#include "../aes-ni.hpp"
+
+namespace clt {
+namespace internal {
+/**
+ * Children ls[k] = MMO_kl(ss[k]), rs[k] = MMO_kr(ss[k]) for k in [0, W).
+ */
+template <size_t W>
+inline void ggm_children(__m128i *ls, __m128i *rs, const __m128i *ss,
+                         const __m128i *keys_l, const __m128i *keys_r) noexcept
+{
+    // NOTE: Rounds of the two keys are interleaved, i.e., 2 W independent
+    // blocks in flight.
+    for (size_t k = 0; k < W; k++) {
+        ls[k] = _mm_xor_si128(ss[k], keys_l[0]);
+        rs[k] = _mm_xor_si128(ss[k], keys_r[0]);
+    }
+    for (size_t r = 1; r < aes128::num_rounds; r++) {
+        for (size_t k = 0; k < W; k++) {
+            ls[k] = _mm_aesenc_si128(ls[k], keys_l[r]);
+            rs[k] = _mm_aesenc_si128(rs[k], keys_r[r]);
+        }
+    }
+    for (size_t k = 0; k < W; k++) {
+        ls[k] = _mm_xor_si128(
+            _mm_aesenclast_si128(ls[k], keys_l[aes128::num_rounds]), ss[k]);
+        rs[k] = _mm_xor_si128(
+            _mm_aesenclast_si128(rs[k], keys_r[aes128::num_rounds]), ss[k]);
+    }
+}
+} // namespace internal
+} // namespace clt
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <array>
+#include <utility>
+
+#include <x86intrin.h>
+
+#include "../simpira.hpp"
+
+namespace clt {
+namespace internal {
+inline __m128i simpira_f(const __m128i x, const int c, const int b) noexcept
+{
+    const auto rc = _mm_setr_epi32(c ^ b, 0x10 ^ c ^ b, 0x20 ^ c ^ b,
+                                   0x30 ^ c ^ b);
+    return _mm_aesenc_si128(_mm_aesenc_si128(x, rc), _mm_setzero_si128());
+}
+
+/**
+ * The F functions of round r of Algorithm 1 of Simpira v2 as pairs (i, j)
+ * of x_j ^= F_c(x_i), in the order of the counter c.
+ */
+template <size_t B>
+constexpr std::array<std::pair<size_t, size_t>, B / 2>
+simpira_feistels(const size_t r) noexcept
+{
+    if constexpr (B == 2) {
+        return {{{r % 2, (r + 1) % 2}}};
+    } else if constexpr (B == 4) {
+        return {{{r % 4, (r + 1) % 4}, {(r + 2) % 4, (r + 3) % 4}}};
+    } else {
+        constexpr size_t s[] = {0, 1, 6, 5, 4, 3};
+        constexpr size_t t[] = {2, 7};
+        return {{{s[r % 6], s[(r + 1) % 6]},
+                 {t[r % 2], s[(r + 5) % 6]},
+                 {s[(r + 4) % 6], s[(r + 3) % 6]},
+                 {s[(r + 2) % 6], t[(r + 1) % 2]}}};
+    }
+}
+
+/**
+ * The F functions of round R of W states in lock step, which are
+ * independent; indices and round constants are compile-time constants.
+ * A round reads and writes disjoint blocks, so it is its own inverse.
+ */
+template <size_t B, size_t W, size_t R>
+inline void simpira_round(__m128i (*xs)[B]) noexcept
+{
+    constexpr auto feistels = simpira_feistels<B>(R);
+    for (size_t j = 0; j < B / 2; j++) {
+        const int c = 1 + R * (B / 2) + j;
+        for (size_t k = 0; k < W; k++) {
+            auto &x = xs[k][feistels[j].second];
+            x = _mm_xor_si128(x, simpira_f(xs[k][feistels[j].first], c, B));
+        }
+    }
+}
+
+template <size_t B, size_t W, bool Inverse, size_t... R>
+inline void simpira_apply_impl(__m128i (*xs)[B],
+                               std::index_sequence<R...>) noexcept
+{
+    constexpr size_t n = simpira::num_rounds(B);
+    if constexpr (Inverse) {
+        (simpira_round<B, W, n - 1 - R>(xs), ...);
+    } else {
+        (simpira_round<B, W, R>(xs), ...);
+    }
+}
+
+/**
+ * W states in lock step.
+ */
+template <size_t B, size_t W, bool Inverse>
+inline void simpira_apply_impl(__m128i (*xs)[B]) noexcept
+{
+    constexpr size_t n = simpira::num_rounds(B);
+    simpira_apply_impl<B, W, Inverse>(xs, std::make_index_sequence<n>{});
+}
+
+template <size_t B, size_t W, bool Inverse>
+inline void simpira_batch(__m128i *p_out, const __m128i *p_in) noexcept
+{
+    __m128i xs[W][B];
+    for (size_t k = 0; k < W; k++) {
+        for (size_t j = 0; j < B; j++) {
+            xs[k][j] = _mm_loadu_si128(p_in + B * k + j);
+        }
+    }
+    simpira_apply_impl<B, W, Inverse>(xs);
+    for (size_t k = 0; k < W; k++) {
+        for (size_t j = 0; j < B; j++) {
+            _mm_storeu_si128(p_out + B * k + j, xs[k][j]);
+        }
+    }
+}
+
+template <size_t B, bool Inverse>
+inline void simpira_apply(void *out, const void *in,
+                          const size_t num_states) noexcept
+{
+    constexpr size_t W = simpira::batch_width(B);
+    const auto *p_in = reinterpret_cast<const __m128i *>(in);
+    auto *p_out = reinterpret_cast<__m128i *>(out);
+    const size_t num_batches = num_states / W;
+    for (size_t b = 0; b < num_batches; b++) {
+        simpira_batch<B, W, Inverse>(p_out + B * W * b, p_in + B * W * b);
+    }
+    for (size_t i = W * num_batches; i < num_states; i++) {
+        simpira_batch<B, 1, Inverse>(p_out + B * i, p_in + B * i);
+    }
+}
+
+/**
+ * W states of the tweakable Even-Mansour cipher in lock step, from the
+ * tweak of the first one.
+ */
+template <size_t B, size_t W, bool Inverse>
+inline void wide_block_cipher_impl(__m128i *p_out, const __m128i *p_in,
+                                   const uint64_t tweak, const __m128i *keys,
+                                   const __m128i *whitening) noexcept
+{
+    __m128i ds[W], xs[W][B];
+    for (size_t k = 0; k < W; k++) {
+        ds[k] = _mm_set_epi64x(0, tweak + k);
+    }
+    using internal::sfinae::aes128_enc_impl;
+    using internal::sfinae::width_round_t;
+    aes128_enc_impl(ds, width_round_t<W, 0>{}, keys);
+    for (size_t k = 0; k < W; k++) {
+        for (size_t j = 0; j < B; j++) {
+            const auto mask = _mm_xor_si128(whitening[j], ds[k]);
+            xs[k][j] = _mm_xor_si128(_mm_loadu_si128(p_in + B * k + j), mask);
+        }
+    }
+    simpira_apply_impl<B, W, Inverse>(xs);
+    for (size_t k = 0; k < W; k++) {
+        for (size_t j = 0; j < B; j++) {
+            const auto mask = _mm_xor_si128(whitening[j], ds[k]);
+            _mm_storeu_si128(p_out + B * k + j, _mm_xor_si128(xs[k][j], mask));
+        }
+    }
+}
+
+template <size_t B, bool Inverse>
+inline void wide_block_cipher_apply(void *out, const void *in,
+                                    const size_t num_states,
+                                    const uint64_t tweak,
+                                    const uint8_t *expanded_keys,
+                                    const uint8_t *whitening) noexcept
+{
+    constexpr size_t W = simpira::batch_width(B);
+    __m128i keys[aes128::num_rounds + 1], ls[B];
+    aes128_load_expkey_for_enc(keys, expanded_keys);
+    for (size_t j = 0; j < B; j++) {
+        ls[j] = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(whitening) + j);
+    }
+    const auto *p_in = reinterpret_cast<const __m128i *>(in);
+    auto *p_out = reinterpret_cast<__m128i *>(out);
+    const size_t num_batches = num_states / W;
+    for (size_t b = 0; b < num_batches; b++) {
+        wide_block_cipher_impl<B, W, Inverse>(
+            p_out + B * W * b, p_in + B * W * b, tweak + W * b, keys, ls);
+    }
+    for (size_t i = W * num_batches; i < num_states; i++) {
+        wide_block_cipher_impl<B, 1, Inverse>(p_out + B * i, p_in + B * i,
+                                              tweak + i, keys, ls);
+    }
+}
+} // namespace internal
+
+template <size_t Blocks>
+void Simpira<Blocks>::permute(void *out, const void *in,
+                              const size_t num_states) noexcept
+{
+    internal::simpira_apply<Blocks, false>(out, in, num_states);
+}
+
+template <size_t Blocks>
+void Simpira<Blocks>::inverse(void *out, const void *in,
+                              const size_t num_states) noexcept
+{
+    internal::simpira_apply<Blocks, true>(out, in, num_states);
+}
+
+template <size_t Blocks>
+WideBlockCipher<Blocks>::WideBlockCipher(const void *key) noexcept
+{
+    __m128i keys[aes128::num_rounds + 1];
+    static_assert(sizeof(keys) == sizeof(expanded_keys_));
+    keys[0] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(key));
+    internal::aes128_key_expansion_impl<0>(keys);
+    auto *p_keys = reinterpret_cast<__m128i *>(expanded_keys_);
+    for (size_t i = 0; i < std::size(keys); i++) {
+        _mm_storeu_si128(p_keys + i, keys[i]);
+    }
+    __m128i ls[Blocks];
+    for (size_t j = 0; j < Blocks; j++) {
+        ls[j] = _mm_set_epi64x(1, j);
+    }
+    using internal::sfinae::aes128_enc_impl;
+    using internal::sfinae::width_round_t;
+    aes128_enc_impl(ls, width_round_t<Blocks, 0>{}, keys);
+    auto *p_whitening = reinterpret_cast<__m128i *>(whitening_);
+    for (size_t j = 0; j < Blocks; j++) {
+        _mm_storeu_si128(p_whitening + j, ls[j]);
+    }
+}
+
+template <size_t Blocks>
+void WideBlockCipher<Blocks>::enc(void *out, const void *in,
+                                  const size_t num_states,
+                                  const uint64_t tweak) const noexcept
+{
+    internal::wide_block_cipher_apply<Blocks, false>(
+        out, in, num_states, tweak, expanded_keys_, whitening_);
+}
+
+template <size_t Blocks>
+void WideBlockCipher<Blocks>::dec(void *out, const void *in,
+                                  const size_t num_states,
+                                  const uint64_t tweak) const noexcept
+{
+    internal::wide_block_cipher_apply<Blocks, true>(
+        out, in, num_states, tweak, expanded_keys_, whitening_);
+}
+} // namespace clt
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace clt {
+namespace distribution {
+// NOTE: Values generated per call of the generator; 16 KiB of keystream
+// stays in L1/L2 between generation and conversion.
+constexpr size_t chunk_elems = 1 << 11;
+
+/**
+ * Conversions of random bits, in place if out == in.
+ * - uniform: [0, 1) by filling the mantissa of [1, 2) and subtracting 1,
+ * i.e., multiples of 2^-52 (double) or 2^-23 (float).
+ * - normal: standard normal by Box-Muller, num_elems must be even.
+ * - exponential: rate 1 by -log(u) with u in (0, 1].
+ * Vectorized by AVX-512 or AVX2 when enabled at compile time.
+ */
+void bits_to_uniform(double *out, const uint64_t *in,
+                     const size_t num_elems) noexcept;
+void bits_to_uniform(float *out, const uint32_t *in,
+                     const size_t num_elems) noexcept;
+void bits_to_normal(double *out, const uint64_t *in,
+                    const size_t num_elems) noexcept;
+void bits_to_exponential(double *out, const uint64_t *in,
+                         const size_t num_elems) noexcept;
+
+namespace internal {
+template <class T, class U, class Gen, class Conv>
+inline void fill_by_chunks(Gen &gen, T *out, const size_t num_elems,
+                           Conv &&conv)
+{
+    static_assert(sizeof(T) == sizeof(U));
+    for (size_t i = 0; i < num_elems; i += chunk_elems) {
+        const size_t n = std::min(chunk_elems, num_elems - i);
+        gen(out + i, sizeof(T) * n);
+        conv(out + i, reinterpret_cast<const U *>(out + i), n);
+    }
+}
+} // namespace internal
+} // namespace distribution
+
+/**
+ * Fill out with num_elems variates using the byte generator gen, e.g.,
+ * AES128_CTR, AESPRF128_CTR or AESPRF128_SharedCTR.
+ * The keystream is written into out chunk by chunk and converted in place.
+ */
+template <class Gen>
+inline void fill_uniform(Gen &gen, double *out, const size_t num_elems)
+{
+    distribution::internal::fill_by_chunks<double, uint64_t>(
+        gen, out, num_elems,
+        [](double *o, const uint64_t *in, const size_t n) {
+            distribution::bits_to_uniform(o, in, n);
+        });
+}
+
+template <class Gen>
+inline void fill_uniform(Gen &gen, float *out, const size_t num_elems)
+{
+    distribution::internal::fill_by_chunks<float, uint32_t>(
+        gen, out, num_elems, [](float *o, const uint32_t *in, const size_t n) {
+            distribution::bits_to_uniform(o, in, n);
+        });
+}
+
+template <class Gen>
+inline void fill_normal(Gen &gen, double *out, const size_t num_elems)
+{
+    const size_t num_pairs = num_elems / 2;
+    distribution::internal::fill_by_chunks<double, uint64_t>(
+        gen, out, 2 * num_pairs,
+        [](double *o, const uint64_t *in, const size_t n) {
+            distribution::bits_to_normal(o, in, n);
+        });
+    if ((num_elems % 2) == 1) {
+        std::array<uint64_t, 2> bits;
+        gen(bits.data(), sizeof(bits));
+        std::array<double, 2> last;
+        distribution::bits_to_normal(last.data(), bits.data(), last.size());
+        out[num_elems - 1] = last[0];
+    }
+}
+
+template <class Gen>
+inline void fill_exponential(Gen &gen, double *out, const size_t num_elems)
+{
+    distribution::internal::fill_by_chunks<double, uint64_t>(
+        gen, out, num_elems,
+        [](double *o, const uint64_t *in, const size_t n) {
+            distribution::bits_to_exponential(o, in, n);
+        });
+}
+} // namespace clt
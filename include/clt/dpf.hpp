@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "aes-ni.hpp"
+#include "ggm.hpp"
+
+namespace clt {
+namespace dpf {
+// NOTE: Fixed public key of the conversion of leaf seeds to outputs, the
+// hexadecimal digits of pi following ggm::default_key_right.
+constexpr uint8_t default_key_value[aes128::key_bytes] = {
+    0x45, 0x28, 0x21, 0xe6, 0x38, 0xd0, 0x13, 0x77,
+    0xbe, 0x54, 0x66, 0xcf, 0x34, 0xe9, 0x0c, 0x6c};
+
+struct Key {
+    using block_t = AES128::block_t;
+    // NOTE: Party 0 or 1, also the control bit of the root.
+    uint8_t party;
+    block_t seed;
+    // NOTE: Correction words of levels 1, 2, ..., with the lowest bit
+    // cleared, and their control bits, bit 0 for the left and bit 1 for the
+    // right child.
+    std::vector<block_t> cw_seeds;
+    std::vector<uint8_t> cw_bits;
+    block_t cw_out;
+};
+} // namespace dpf
+
+class DPF {
+    /**
+     * Two-party distributed point function of f(x) = beta if x = alpha and
+     * 0 otherwise, for x in [0, 2^log_domain), where outputs are elements of
+     * elem_bits bits: XOR shares of bits for elem_bits = 1, and additive
+     * shares in Z_{2^elem_bits} for elem_bits = 8, 16, 32, 64.
+     * The tree stops 128 / elem_bits elements above the leaves (early
+     * termination), and each of its 2^(log_domain - nu) leaves is converted
+     * to one block of 128 / elem_bits = 2^nu packed elements, element x in
+     * lane x mod 2^nu.
+     * Nodes carry their control bit in the lowest bit, so a level is
+     * expanded by the interleaved GGM kernel with masked correction words.
+     * References:
+     * - Boyle, Gilboa, Ishai, "Function Secret Sharing: Improvements and
+     * Extensions", Figure 1
+     * https://eprint.iacr.org/2018/707
+     */
+    uint8_t expanded_keys_left_[aes128::block_bytes * (aes128::num_rounds + 1)];
+    uint8_t
+        expanded_keys_right_[aes128::block_bytes * (aes128::num_rounds + 1)];
+    uint8_t
+        expanded_keys_value_[aes128::block_bytes * (aes128::num_rounds + 1)];
+    size_t log_domain_;
+    size_t elem_bits_;
+    size_t depth_;
+
+public:
+    using block_t = AES128::block_t;
+    DPF(const size_t log_domain, const size_t elem_bits);
+    friend std::ostream &operator<<(std::ostream &ost, const DPF &x);
+    auto log_domain() const noexcept { return log_domain_; }
+    auto elem_bits() const noexcept { return elem_bits_; }
+    auto depth() const noexcept { return depth_; }
+    /**
+     * Bytes of the output of eval_full, i.e., 2^log_domain * elem_bits / 8.
+     */
+    size_t full_bytes() const noexcept
+    {
+        return aes128::block_bytes << depth_;
+    }
+    /**
+     * Keys of both parties from the root seeds seed0, seed1.
+     */
+    std::pair<dpf::Key, dpf::Key> gen(const uint64_t alpha,
+                                      const uint64_t beta, const void *seed0,
+                                      const void *seed1) const;
+    /**
+     * Keys of both parties from random root seeds.
+     */
+    std::pair<dpf::Key, dpf::Key> gen(const uint64_t alpha,
+                                      const uint64_t beta) const;
+    /**
+     * Share of f(x), the lowest elem_bits bits.
+     */
+    uint64_t eval(const dpf::Key &key, const uint64_t x) const noexcept;
+    /**
+     * Shares of f(x) for every x into out of full_bytes() bytes, by levels
+     * breadth first and subtrees of 2^ggm::subtree_depth leaves in parallel
+     * by OpenMP if parallel is true.
+     */
+    void eval_full(const dpf::Key &key, void *out,
+                   const bool parallel = false) const noexcept;
+};
+
+inline std::ostream &operator<<(std::ostream &ost, const DPF &x)
+{
+    ost << fmt::format("DPF[log_domain={:d},elem_bits={:d},depth={:d}]",
+                       x.log_domain_, x.elem_bits_, x.depth_);
+    return ost;
+}
+} // namespace clt
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+#include "aes-ni.hpp"
+
+namespace clt {
+namespace drbg {
+// NOTE: seedlen of CTR_DRBG with AES-128, i.e., keylen + blocklen.
+constexpr size_t seed_bytes = aes128::key_bytes + aes128::block_bytes;
+// NOTE: Limits of SP 800-90A Table 3.
+constexpr uint64_t max_reseed_interval = uint64_t(1) << 48;
+constexpr size_t max_request_bytes = size_t(1) << 16;
+constexpr uint64_t default_reseed_interval = uint64_t(1) << 20;
+} // namespace drbg
+
+class AES128_CTR_DRBG {
+    /**
+     * CTR_DRBG with AES-128 and without derivation function.
+     * References:
+     * - NIST SP 800-90A Rev. 1, "Recommendation for Random Number Generation
+     * Using Deterministic Random Bit Generators", Section 10.2.1
+     * https://doi.org/10.6028/NIST.SP.800-90Ar1
+     */
+    uint8_t expanded_keys_[aes128::block_bytes * (aes128::num_rounds + 1)];
+    uint64_t v_hi_;
+    uint64_t v_lo_;
+    uint64_t reseed_counter_;
+    uint64_t reseed_interval_;
+
+    void update(const uint8_t *provided_data) noexcept;
+    void set_key(const uint8_t *key) noexcept;
+
+public:
+    /**
+     * Instantiate with seed_bytes of entropy input and at most seed_bytes of
+     * personalization string.
+     */
+    AES128_CTR_DRBG(const void *entropy_input, const void *personalization,
+                    const size_t personalization_bytes,
+                    const uint64_t reseed_interval =
+                        drbg::default_reseed_interval) noexcept;
+    /**
+     * Instantiate with entropy input from rng::rng_global.
+     */
+    AES128_CTR_DRBG();
+    ~AES128_CTR_DRBG();
+    // NOTE: A copy would emit the same output as the original.
+    AES128_CTR_DRBG(const AES128_CTR_DRBG &) = delete;
+    AES128_CTR_DRBG &operator=(const AES128_CTR_DRBG &) = delete;
+    friend std::ostream &operator<<(std::ostream &ost,
+                                    const AES128_CTR_DRBG &x);
+    void reseed(const void *entropy_input, const void *additional_input,
+                const size_t additional_bytes) noexcept;
+    void reseed(const void *additional_input = nullptr,
+                const size_t additional_bytes = 0);
+    /**
+     * Generate at most drbg::max_request_bytes.
+     * Reseeds from rng::rng_global if the reseed interval is exceeded or
+     * prediction resistance is requested.
+     */
+    void generate(void *out, const size_t num_bytes,
+                  const void *additional_input = nullptr,
+                  const size_t additional_bytes = 0,
+                  const bool prediction_resistance = false);
+    /**
+     * Generate any number of bytes by repeated generate.
+     * Returns false if reseeding fails.
+     */
+    bool operator()(void *out, const size_t num_bytes) noexcept;
+    auto get_reseed_counter() const noexcept { return reseed_counter_; }
+};
+
+/**
+ * Per-thread instance, seeded from rng::rng_global on first use and
+ * reseeded in a child process after fork.
+ */
+AES128_CTR_DRBG &thread_local_drbg();
+
+inline std::ostream &operator<<(std::ostream &ost, const AES128_CTR_DRBG &x)
+{
+    ost << fmt::format("AES128_CTR_DRBG[reseed_counter={:d},"
+                       "reseed_interval={:d}]",
+                       x.reseed_counter_, x.reseed_interval_);
+    return ost;
+}
+} // namespace clt
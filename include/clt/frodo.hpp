@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+#include "aes-ni.hpp"
+
+namespace clt {
+namespace frodo {
+constexpr size_t seed_bytes = aes128::key_bytes;
+// NOTE: Entries of 16 bits per AES128 block.
+constexpr size_t entries_per_block = aes128::block_bytes / sizeof(uint16_t);
+// NOTE: Blocks encrypted in parallel per row.
+constexpr size_t batch_width = 8;
+} // namespace frodo
+
+class FrodoMatrixAES128 {
+    /**
+     * Expansion of the public n x n matrix A over Z_q, q = 2^log_q, from
+     * seedA as in FrodoKEM with AES128: entries j, ..., j + 7 of row i are
+     * the little-endian 16-bit words of AES128_seedA(<i>_16 || <j>_16 ||
+     * 0^96), reduced mod q. n must be a multiple of 8 less than 2^16.
+     * The input blocks are built in registers, so no temporary row of
+     * plaintexts is needed.
+     * References:
+     * - FrodoKEM specification, Section 2.2.5
+     * https://frodokem.org/files/FrodoKEM-specification-20210604.pdf
+     */
+    uint8_t expanded_keys_[aes128::block_bytes * (aes128::num_rounds + 1)];
+    size_t n_;
+    size_t log_q_;
+
+public:
+    FrodoMatrixAES128(const void *seed_a, const size_t n, const size_t log_q);
+    friend std::ostream &operator<<(std::ostream &ost,
+                                    const FrodoMatrixAES128 &x);
+    auto n() const noexcept { return n_; }
+    auto log_q() const noexcept { return log_q_; }
+    /**
+     * Rows [first_row, first_row + num_rows) into out of num_rows * n
+     * entries, e.g., a few rows at a time to keep A out of memory.
+     */
+    void expand_rows(uint16_t *out, const size_t first_row,
+                     const size_t num_rows) const noexcept;
+    /**
+     * The whole matrix into out of n * n entries, rows in parallel by OpenMP
+     * if parallel is true.
+     */
+    void expand(uint16_t *out, const bool parallel = false) const noexcept;
+};
+
+inline std::ostream &operator<<(std::ostream &ost, const FrodoMatrixAES128 &x)
+{
+    ost << fmt::format("FrodoMatrixAES128[n={:d},log_q={:d}]", x.n_,
+                       x.log_q_);
+    return ost;
+}
+} // namespace clt
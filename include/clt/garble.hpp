@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "aes-ni.hpp"
+
+namespace clt {
+namespace gc {
+// NOTE: Fixed public key of the hash, the hexadecimal digits of pi following
+// ot::default_hash_key.
+constexpr uint8_t default_hash_key[aes128::key_bytes] = {
+    0x92, 0x16, 0xd5, 0xd9, 0x89, 0x79, 0xfb, 0x1b,
+    0xd1, 0x31, 0x0b, 0xa6, 0x98, 0xdf, 0xb5, 0xac};
+// NOTE: Blocks of the garbled table of an AND gate.
+constexpr size_t and_table_blocks = 2;
+
+enum class GateType : uint8_t { XOR, AND, INV, EQW };
+
+struct Gate {
+    GateType type;
+    // NOTE: in1 is unused by INV and EQW.
+    uint32_t in0;
+    uint32_t in1;
+    uint32_t out;
+};
+} // namespace gc
+
+class Circuit {
+    /**
+     * Boolean circuit in Bristol Fashion: input wires come first, output
+     * wires last, and gates are XOR, AND, INV and EQW.
+     * Gates are rescheduled into layers by AND depth: layer l holds the AND
+     * gates of depth l, whose inputs are all in earlier layers, followed by
+     * the linear gates of depth l in their original order. The hashes of
+     * the AND gates of a layer are thus independent and computed in
+     * batches.
+     * References:
+     * - "'Bristol Fashion' MPC Circuits"
+     * https://nigelsmart.github.io/MPC-Circuits/
+     */
+    size_t num_wires_;
+    std::vector<size_t> input_sizes_;
+    std::vector<size_t> output_sizes_;
+    std::vector<gc::Gate> gates_;
+    // NOTE: Layer l is the AND gates [offsets_[2 l], offsets_[2 l + 1]) and
+    // the linear gates [offsets_[2 l + 1], offsets_[2 l + 2]).
+    std::vector<size_t> offsets_;
+    size_t num_and_gates_;
+
+public:
+    /**
+     * Parse a circuit, throw std::runtime_error if it is malformed.
+     */
+    explicit Circuit(std::istream &ist);
+    static Circuit from_file(const std::string &path);
+    friend std::ostream &operator<<(std::ostream &ost, const Circuit &x);
+    auto num_wires() const noexcept { return num_wires_; }
+    auto num_gates() const noexcept { return gates_.size(); }
+    auto num_and_gates() const noexcept { return num_and_gates_; }
+    auto num_layers() const noexcept { return offsets_.size() / 2; }
+    size_t num_inputs() const noexcept;
+    size_t num_outputs() const noexcept;
+    const auto &input_sizes() const noexcept { return input_sizes_; }
+    const auto &output_sizes() const noexcept { return output_sizes_; }
+    const auto &gates() const noexcept { return gates_; }
+    const auto &offsets() const noexcept { return offsets_; }
+    /**
+     * Bytes of the garbled tables, gc::and_table_blocks per AND gate.
+     */
+    size_t table_bytes() const noexcept
+    {
+        return aes128::block_bytes * gc::and_table_blocks * num_and_gates_;
+    }
+    /**
+     * Plain evaluation with one byte per bit for inputs and outputs.
+     */
+    void eval(uint8_t *out, const uint8_t *in) const;
+};
+
+class HalfGatesGarbler {
+    /**
+     * Garbler of half gates with free XOR and point-and-permute: labels of
+     * bit 1 are labels of bit 0 xor delta, and the lowest bit of delta is
+     * set. An AND gate costs 4 hashes and a table of 2 blocks.
+     * The hash is MMO128::tccr with a fixed key, the tweaks of the j-th AND
+     * gate are 2 j and 2 j + 1.
+     * References:
+     * - Zahur, Rosulek, Evans, "Two Halves Make a Whole"
+     * https://eprint.iacr.org/2014/756
+     * - Guo et al., "Efficient and Secure Multiparty Computation from
+     * Fixed-Key Block Ciphers"
+     * https://eprint.iacr.org/2019/074
+     */
+    MMO128 hash_;
+    AESPRF128 prg_;
+    AES128::block_t delta_;
+    uint64_t counter_;
+
+public:
+    using block_t = AES128::block_t;
+    /**
+     * delta and input labels are generated from seed.
+     */
+    explicit HalfGatesGarbler(const void *seed) noexcept;
+    HalfGatesGarbler() : HalfGatesGarbler(gen_key().data()) {}
+    friend std::ostream &operator<<(std::ostream &ost,
+                                    const HalfGatesGarbler &x);
+    const auto &delta() const noexcept { return delta_; }
+    /**
+     * Garble circuit into tables of circuit.table_bytes() bytes, the labels
+     * of bit 0 of the num_inputs() input wires and the num_outputs()
+     * decoding bits.
+     */
+    void garble(const Circuit &circuit, void *tables, void *input_labels,
+                uint8_t *decoding);
+    /**
+     * Labels of the bits in[i] from the labels of bit 0, i.e., the messages
+     * the evaluator obtains by OT or directly from the garbler.
+     */
+    void encode(void *out, const void *input_labels, const uint8_t *in,
+                const size_t num_bits) const noexcept;
+};
+
+class HalfGatesEvaluator {
+    /**
+     * Evaluator of circuits garbled by HalfGatesGarbler: an AND gate costs
+     * 2 hashes.
+     */
+    MMO128 hash_;
+
+public:
+    HalfGatesEvaluator() noexcept : hash_(gc::default_hash_key) {}
+    friend std::ostream &operator<<(std::ostream &ost,
+                                    const HalfGatesEvaluator &x);
+    /**
+     * Labels of the num_outputs() output wires from tables and the labels of
+     * the num_inputs() input wires.
+     */
+    void evaluate(const Circuit &circuit, const void *tables,
+                  const void *input_labels, void *output_labels) const;
+    /**
+     * Output bits, the lowest bits of labels xor decoding bits.
+     */
+    static void decode(uint8_t *out, const void *output_labels,
+                       const uint8_t *decoding,
+                       const size_t num_bits) noexcept;
+};
+
+inline std::ostream &operator<<(std::ostream &ost, const Circuit &x)
+{
+    ost << fmt::format("Circuit[wires={:d},gates={:d},and_gates={:d},"
+                       "layers={:d}]",
+                       x.num_wires_, x.gates_.size(), x.num_and_gates_,
+                       x.num_layers());
+    return ost;
+}
+
+inline std::ostream &operator<<(std::ostream &ost, const HalfGatesGarbler &x)
+{
+    ost << fmt::format("HalfGatesGarbler[counter={:d}]", x.counter_);
+    return ost;
+}
+
+inline std::ostream &operator<<(std::ostream &ost, const HalfGatesEvaluator &)
+{
+    ost << "HalfGatesEvaluator[]";
+    return ost;
+}
+} // namespace clt
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include <fmt/format.h>
+
+namespace clt {
+namespace gaussian {
+// NOTE: Samples are bounded by ceil(tail_cut * sigma), and further by the
+// table precision.
+constexpr double default_tail_cut = 12.0;
+// NOTE: Probabilities of the table are multiples of 2^-precision_bits.
+constexpr size_t precision_bits = 63;
+// NOTE: Random words drawn from the generator per call.
+constexpr size_t chunk_elems = 1 << 10;
+} // namespace gaussian
+
+class DiscreteGaussianCDT {
+    /**
+     * Constant-time sampler of the discrete Gaussian over the integers
+     * centered at 0, i.e., Pr[x] proportional to exp(-x^2 / (2 sigma^2)) for
+     * |x| <= bound, by a cumulative distribution table (CDT) of |x|.
+     * Each sample consumes one 64-bit word: the top bit is the sign and the
+     * other 63 bits are compared against every entry of the table, so the
+     * running time and memory accesses do not depend on the sample.
+     * References:
+     * - Bos et al., "Frodo: Take off the ring! Practical, Quantum-Secure Key
+     * Exchange from LWE", Section 5.1
+     * https://eprint.iacr.org/2016/659
+     */
+    double sigma_;
+    // NOTE: The largest |x| of nonzero probability in the table.
+    int32_t bound_;
+    // NOTE: cdt_[k] = Pr[|x| <= k] * 2^63 for k in [0, bound).
+    std::vector<uint64_t> cdt_;
+
+public:
+    explicit DiscreteGaussianCDT(
+        const double sigma, const double tail_cut = gaussian::default_tail_cut);
+    friend std::ostream &operator<<(std::ostream &ost,
+                                    const DiscreteGaussianCDT &x);
+    auto sigma() const noexcept { return sigma_; }
+    auto bound() const noexcept { return bound_; }
+    const auto &cdt() const noexcept { return cdt_; }
+    /**
+     * Pr[x] of the sampled distribution, as represented by the table.
+     */
+    double probability(const int32_t x) const noexcept;
+    /**
+     * Map num_samples random words to samples.
+     */
+    void sample(int32_t *out, const uint64_t *random_words,
+                const size_t num_samples) const noexcept;
+    /**
+     * Draw the random words from the byte generator gen, e.g., AES128_CTR or
+     * AESPRF128_CTR.
+     */
+    template <class Gen>
+    void operator()(Gen &gen, int32_t *out, const size_t num_samples) const
+    {
+        std::array<uint64_t, gaussian::chunk_elems> words;
+        for (size_t i = 0; i < num_samples; i += words.size()) {
+            const size_t n = std::min(words.size(), num_samples - i);
+            gen(words.data(), sizeof(uint64_t) * n);
+            sample(out + i, words.data(), n);
+        }
+    }
+};
+
+inline std::ostream &operator<<(std::ostream &ost, const DiscreteGaussianCDT &x)
+{
+    ost << fmt::format("DiscreteGaussianCDT[sigma={},bound={:d}]", x.sigma_,
+                       x.bound_);
+    return ost;
+}
+} // namespace clt
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "aes-ni.hpp"
+
+namespace clt {
+namespace ggm {
+// NOTE: Nodes expanded in parallel, i.e., 2 * batch_width AES blocks.
+constexpr size_t batch_width = 8;
+// NOTE: Deeper trees are expanded by subtrees of 2^subtree_depth leaves
+// (16 KiB), so each subtree stays in L1 from its root to its leaves.
+constexpr size_t subtree_depth = 10;
+// NOTE: Fixed public keys of the left and right children, the hexadecimal
+// digits of pi.
+constexpr uint8_t default_key_left[aes128::key_bytes] = {
+    0x24, 0x3f, 0x6a, 0x88, 0x85, 0xa3, 0x08, 0xd3,
+    0x13, 0x19, 0x8a, 0x2e, 0x03, 0x70, 0x73, 0x44};
+constexpr uint8_t default_key_right[aes128::key_bytes] = {
+    0xa4, 0x09, 0x38, 0x22, 0x29, 0x9f, 0x31, 0xd0,
+    0x08, 0x2e, 0xfa, 0x98, 0xec, 0x4e, 0x6c, 0x89};
+} // namespace ggm
+
+class GGMTree {
+    /**
+     * GGM tree over 128-bit seeds with the length-doubling PRG
+     * G(s) = (MMO_kl(s), MMO_kr(s)), where MMO_k(s) = AES128_k(s) xor s
+     * with fixed keys kl, kr, e.g., for distributed point functions,
+     * puncturable PRFs and silent OT.
+     * Leaf i of a tree of depth d is reached from the root by the bits of i
+     * from the most significant one, 0 for left and 1 for right.
+     * Expansion is in place: nodes of level l occupy the first 2^l blocks of
+     * the buffer, and each level is expanded from the last node backward by
+     * batches of ggm::batch_width nodes.
+     * References:
+     * - Goldreich, Goldwasser, Micali, "How to Construct Random Functions"
+     * https://doi.org/10.1145/6490.6503
+     * - Guo et al., "Efficient and Secure Multiparty Computation from
+     * Fixed-Key Block Ciphers"
+     * https://eprint.iacr.org/2019/074
+     */
+    uint8_t expanded_keys_left_[aes128::block_bytes * (aes128::num_rounds + 1)];
+    uint8_t
+        expanded_keys_right_[aes128::block_bytes * (aes128::num_rounds + 1)];
+
+public:
+    using block_t = AES128::block_t;
+    GGMTree(const void *key_left, const void *key_right) noexcept;
+    GGMTree() noexcept : GGMTree(ggm::default_key_left, ggm::default_key_right)
+    {
+    }
+    friend std::ostream &operator<<(std::ostream &ost, const GGMTree &x);
+    /**
+     * Children out[2 i], out[2 i + 1] of in[i] for i in [0, num_nodes).
+     * out and in must not overlap.
+     */
+    void expand_level(void *out, const void *in,
+                      const size_t num_nodes) const noexcept;
+    /**
+     * 2^depth leaves from the root buff[0], in place.
+     * Subtrees below level depth - ggm::subtree_depth are expanded by OpenMP
+     * threads if parallel is true.
+     */
+    void expand(void *buff, const size_t depth,
+                const bool parallel = false) const noexcept;
+    /**
+     * Leaf index of the tree of depth from root.
+     */
+    void derive(void *out, const void *root, const size_t depth,
+                const uint64_t index) const noexcept;
+    /**
+     * Punctured key of leaf index: depth seeds, where copath[l] is the
+     * sibling of the path to index at level l + 1.
+     */
+    void puncture(void *copath, const void *root, const size_t depth,
+                  const uint64_t index) const noexcept;
+    /**
+     * 2^depth leaves from the punctured key, leaves[index] is set to zero.
+     */
+    void expand_punctured(void *leaves, const void *copath, const size_t depth,
+                          const uint64_t index,
+                          const bool parallel = false) const noexcept;
+    /**
+     * Call func(first_leaf, leaves, num_leaves) for consecutive chunks of
+     * 2^min(depth, ggm::subtree_depth) leaves without materializing the
+     * whole tree, chunks in parallel by OpenMP if parallel is true.
+     */
+    template <class Func>
+    void expand_chunks(const void *root, const size_t depth, Func &&func,
+                       const bool parallel = false) const
+    {
+        const size_t chunk_depth = std::min(depth, ggm::subtree_depth);
+        std::vector<block_t> top(size_t(1) << (depth - chunk_depth));
+        std::copy_n(reinterpret_cast<const uint8_t *>(root),
+                    aes128::block_bytes, top[0].data());
+        expand(top.data(), depth - chunk_depth, parallel);
+        const size_t num_chunks = top.size();
+#pragma omp parallel if (parallel)
+        {
+            std::vector<block_t> chunk(size_t(1) << chunk_depth);
+#pragma omp for schedule(static)
+            for (size_t i = 0; i < num_chunks; i++) {
+                chunk[0] = top[i];
+                expand(chunk.data(), chunk_depth);
+                func(i << chunk_depth, chunk.data(), chunk.size());
+            }
+        }
+    }
+};
+
+inline std::ostream &operator<<(std::ostream &ost, const GGMTree &x)
+{
+    ost << fmt::format("GGMTree[left=[{:>02x}],right=[{:>02x}]]",
+                       fmt::join(x.expanded_keys_left_,
+                                 x.expanded_keys_left_ + aes128::key_bytes,
+                                 ":"),
+                       fmt::join(x.expanded_keys_right_,
+                                 x.expanded_keys_right_ + aes128::key_bytes,
+                                 ":"));
+    return ost;
+}
+} // namespace clt
+
+#include "detail/ggm_impl.hpp"
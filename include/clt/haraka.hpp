@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+#include "aes-ni.hpp"
+
+namespace clt {
+namespace haraka {
+constexpr size_t num_rounds = 5;
+// NOTE: 2 AES rounds per block and round, 4 blocks for Haraka-512.
+constexpr size_t num_constants = 2 * 4 * num_rounds;
+constexpr size_t digest_bytes = 32;
+// NOTE: Rate of Haraka-S over the 512-bit permutation.
+constexpr size_t sponge_rate = 32;
+// NOTE: Messages hashed in parallel by the batch APIs, then 4 and 1 for the
+// rest.
+constexpr size_t batch_width = 8;
+} // namespace haraka
+
+class Haraka {
+    /**
+     * Haraka v2: Haraka-256 and Haraka-512 hash 256-bit and 512-bit inputs
+     * to 256 bits by 5 rounds of 2 AESENC per block followed by a mixing of
+     * 32-bit words, and a feed-forward; Haraka-512 truncates to 4 halves.
+     * Haraka-S is the sponge of SPHINCS+ over the 512-bit permutation with
+     * rate 32 bytes and padding 0x1f ... 0x80.
+     * Round constants are those of the specification, or tweaked by a seed
+     * as in SPHINCS+-Haraka, i.e., the first 640 bytes of Haraka-S(seed).
+     * References:
+     * - Koelbl, Lauridsen, Mendel, Rechberger, "Haraka v2 - Efficient
+     * Short-Input Hashing for Post-Quantum Applications"
+     * https://eprint.iacr.org/2016/098
+     * - "SPHINCS+ Submission to the NIST post-quantum project, v.3.1"
+     * https://sphincs.org/data/sphincs+-r3.1-specification.pdf
+     */
+    uint8_t round_constants_[aes128::block_bytes * haraka::num_constants];
+
+public:
+    Haraka() noexcept;
+    /**
+     * Round constants tweaked by seed of seed_bytes bytes.
+     */
+    Haraka(const void *seed, const size_t seed_bytes) noexcept;
+    friend std::ostream &operator<<(std::ostream &ost, const Haraka &x);
+    /**
+     * Haraka-256 of num_msgs inputs of 32 bytes into out of 32 bytes each.
+     */
+    void hash256(void *out, const void *in,
+                 const size_t num_msgs = 1) const noexcept;
+    /**
+     * Haraka-512 of num_msgs inputs of 64 bytes into out of 32 bytes each.
+     */
+    void hash512(void *out, const void *in,
+                 const size_t num_msgs = 1) const noexcept;
+    /**
+     * The 512-bit permutation of Haraka-512 without the feed-forward.
+     */
+    void perm512(void *out, const void *in) const noexcept;
+    /**
+     * Haraka-S of in_bytes bytes into out_bytes bytes.
+     */
+    void sponge(void *out, const size_t out_bytes, const void *in,
+                const size_t in_bytes) const noexcept;
+};
+
+inline std::ostream &operator<<(std::ostream &ost, const Haraka &x)
+{
+    ost << fmt::format("Haraka[rc0=[{:>02x}]]",
+                       fmt::join(x.round_constants_,
+                                 x.round_constants_ + aes128::block_bytes,
+                                 ":"));
+    return ost;
+}
+} // namespace clt
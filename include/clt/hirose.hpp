@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+#include "aes-ni.hpp"
+
+namespace clt {
+namespace hirose {
+// NOTE: The state G || H of two blocks is the digest.
+constexpr size_t digest_bytes = 2 * aes256::block_bytes;
+// NOTE: Message bytes per compression, the second half of the AES-256 key.
+constexpr size_t block_bytes = aes256::key_bytes - aes256::block_bytes;
+// NOTE: Messages hashed in parallel by the batched interface.
+constexpr size_t batch_width = 4;
+// NOTE: Default IV, the hexadecimal digits of pi following
+// aes_hash::default_seed.
+constexpr uint8_t default_iv[digest_bytes] = {
+    0x08, 0x01, 0xf2, 0xe2, 0x85, 0x8e, 0xfc, 0x16, 0x63, 0x69, 0x20,
+    0xd8, 0x71, 0x57, 0x4e, 0x69, 0xa4, 0x58, 0xfe, 0xa3, 0xf4, 0x93,
+    0x3d, 0x7e, 0x0d, 0x95, 0x74, 0x8f, 0x72, 0x8e, 0xb6, 0x58};
+} // namespace hirose
+
+class Hirose256 {
+    /**
+     * 256-bit hash from the double-block-length compression function of
+     * Hirose over AES-256: with the state G || H and a message block M of
+     * 16 bytes, the key is K = H || M and
+     * G' = E_K(G) xor G, H' = E_K(G xor c) xor G xor c,
+     * where c is the all-ones block. Both encryptions share the key
+     * schedule and are computed in lock step.
+     * Messages are padded by Merkle-Damgard strengthening: 0x80, zeros, and
+     * the length in bits as a big-endian 64-bit integer.
+     * References:
+     * - Hirose, "Some Plausible Constructions of Double-Block-Length Hash
+     * Functions"
+     * https://doi.org/10.1007/11799313_14
+     * - NIST, "FIPS 197, Advanced Encryption Standard (AES)"
+     * https://doi.org/10.6028/NIST.FIPS.197-upd1
+     */
+    uint8_t iv_[hirose::digest_bytes];
+
+public:
+    explicit Hirose256(const void *iv = hirose::default_iv) noexcept;
+    friend std::ostream &operator<<(std::ostream &ost, const Hirose256 &x);
+    /**
+     * The compression function on the state G || H of 32 bytes in place
+     * and a message block of 16 bytes.
+     */
+    static void compress(void *state, const void *block) noexcept;
+    /**
+     * Digest of 32 bytes of num_bytes bytes of in.
+     */
+    void hash(void *out, const void *in, const size_t num_bytes) const noexcept;
+    /**
+     * hash of num_msgs consecutive messages of msg_bytes bytes each into out
+     * of 32 bytes each, by batches of hirose::batch_width messages in
+     * parallel.
+     */
+    void hash(void *out, const void *in, const size_t msg_bytes,
+              const size_t num_msgs) const noexcept;
+};
+
+inline std::ostream &operator<<(std::ostream &ost, const Hirose256 &x)
+{
+    ost << fmt::format("Hirose256[iv=[{:>02x}]]",
+                       fmt::join(x.iv_, x.iv_ + hirose::digest_bytes, ":"));
+    return ost;
+}
+} // namespace clt
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "aes-ni.hpp"
+
+namespace clt {
+namespace ot {
+constexpr size_t num_base_ots = 128;
+// NOTE: The number of OTs per call must be a multiple of batch_ots, the
+// width of the transposed tiles.
+constexpr size_t batch_ots = 128;
+// NOTE: OTs per chunk; the 128 columns of a chunk (64 KiB) and its rows stay
+// in L2.
+constexpr size_t chunk_ots = 1 << 12;
+// NOTE: Fixed public key of the hash, the hexadecimal digits of pi following
+// dpf::default_key_value.
+constexpr uint8_t default_hash_key[aes128::key_bytes] = {
+    0xc0, 0xac, 0x29, 0xb7, 0xc9, 0x7c, 0x50, 0xdd,
+    0x3f, 0x84, 0xd5, 0xb5, 0xb5, 0x47, 0x09, 0x17};
+
+/**
+ * Transpose of the bit matrix of 128 rows of num_cols bits, where row i
+ * starts at in + i * row_stride bytes, into num_cols rows of 128 bits.
+ * Bits are in little-endian order within bytes, and num_cols must be a
+ * multiple of batch_ots.
+ */
+void transpose_128xn(void *out, const void *in, const size_t row_stride,
+                     const size_t num_cols) noexcept;
+} // namespace ot
+
+class IKNPSender {
+    /**
+     * Sender of random OT extension by IKNP: the j-th OT outputs
+     * H(j, q_j) and H(j, q_j xor delta), where q_j are the rows of the
+     * columns expanded from the base OT seeds and corrected by u from the
+     * receiver, and H(j, x) = MMO(x xor j) with a fixed key.
+     * The base OTs are not included: delta is the choice bits and
+     * base_seeds are the 128 received seeds of the base OTs.
+     * References:
+     * - Ishai, Kilian, Nissim, Petrank, "Extending Oblivious Transfers
+     * Efficiently"
+     * https://doi.org/10.1007/978-3-540-45146-4_9
+     * - Guo et al., "Efficient and Secure Multiparty Computation from
+     * Fixed-Key Block Ciphers"
+     * https://eprint.iacr.org/2019/074
+     */
+    std::vector<AESPRF128> prgs_;
+    AES128::block_t delta_;
+    uint8_t
+        expanded_hash_keys_[aes128::block_bytes * (aes128::num_rounds + 1)];
+    // NOTE: Counter of the column streams and index of the next OT.
+    uint64_t counter_;
+    uint64_t num_ots_;
+
+public:
+    IKNPSender(const void *delta, const void *base_seeds);
+    friend std::ostream &operator<<(std::ostream &ost, const IKNPSender &x);
+    auto get_num_ots() const noexcept { return num_ots_; }
+    /**
+     * num_ots pairs of 128-bit messages into out0, out1 from u of
+     * 128 columns of num_ots bits.
+     */
+    void extend(void *out0, void *out1, const void *u, const size_t num_ots);
+};
+
+class IKNPReceiver {
+    /**
+     * Receiver of random OT extension by IKNP, paired with IKNPSender:
+     * base_seeds0, base_seeds1 are the 128 seed pairs sent by the base OTs.
+     */
+    std::vector<AESPRF128> prgs0_, prgs1_;
+    uint8_t
+        expanded_hash_keys_[aes128::block_bytes * (aes128::num_rounds + 1)];
+    uint64_t counter_;
+    uint64_t num_ots_;
+
+public:
+    IKNPReceiver(const void *base_seeds0, const void *base_seeds1);
+    friend std::ostream &operator<<(std::ostream &ost, const IKNPReceiver &x);
+    auto get_num_ots() const noexcept { return num_ots_; }
+    /**
+     * num_ots messages chosen by the bits of choices into out, and u of
+     * 128 columns of num_ots bits to be sent to the sender.
+     */
+    void extend(void *out, void *u, const void *choices, const size_t num_ots);
+};
+
+inline std::ostream &operator<<(std::ostream &ost, const IKNPSender &x)
+{
+    ost << fmt::format("IKNPSender[counter={:d},num_ots={:d}]", x.counter_,
+                       x.num_ots_);
+    return ost;
+}
+
+inline std::ostream &operator<<(std::ostream &ost, const IKNPReceiver &x)
+{
+    ost << fmt::format("IKNPReceiver[counter={:d},num_ots={:d}]", x.counter_,
+                       x.num_ots_);
+    return ost;
+}
+} // namespace clt
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#include "aes-ni.hpp"
+
+namespace clt {
+namespace pool {
+// NOTE: A request of at most slot_bytes consumes exactly one slot.
+constexpr size_t slot_bytes = 64;
+constexpr size_t default_num_slots = 1 << 12;
+// NOTE: Consumers wake the producer every refill_batch_slots slots, and the
+// producer generates at most this many slots per AES call.
+constexpr size_t refill_batch_slots = 1 << 6;
+// NOTE: The fallback path uses counters with the top bit set, so it never
+// overlaps the counters of the producer.
+constexpr uint64_t fallback_counter_base = uint64_t(1) << 63;
+} // namespace pool
+
+class RandomPool {
+    /**
+     * Pool of random bytes for consumers needing a few bytes at a time.
+     * A background thread fills a ring of slots by AESPRF128::ctr_stream,
+     * and consumers take a slot by a CAS on the head, i.e., a bounded
+     * single-producer/multi-consumer queue with per-slot sequence numbers.
+     * When the ring runs dry, the consumer generates the bytes itself.
+     * NOTE: Not fork-safe; the producer thread does not exist in a child.
+     * References:
+     * - Vyukov, "Bounded MPMC queue"
+     * https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+     */
+    struct alignas(64) Sequence {
+        std::atomic<uint64_t> value;
+    };
+
+    AESPRF128 prf_;
+    const size_t num_slots_;
+    std::vector<uint8_t> bytes_;
+    std::unique_ptr<Sequence[]> seqs_;
+    alignas(64) std::atomic<uint64_t> head_;
+    alignas(64) std::atomic<uint32_t> wake_;
+    std::atomic<bool> sleeping_;
+    std::atomic<bool> stop_;
+    alignas(64) std::atomic<uint64_t> fallback_counter_;
+    std::atomic<uint64_t> num_fallbacks_;
+    std::thread producer_;
+
+    void produce() noexcept;
+    void wake_producer() noexcept;
+    void fallback(void *out, const size_t num_bytes) noexcept;
+
+public:
+    explicit RandomPool(const AES128::key_t &key,
+                        const size_t num_slots = pool::default_num_slots);
+    /**
+     * Key from rng::rng_global.
+     */
+    explicit RandomPool(const size_t num_slots = pool::default_num_slots);
+    RandomPool(const RandomPool &) = delete;
+    RandomPool &operator=(const RandomPool &) = delete;
+    ~RandomPool();
+    friend std::ostream &operator<<(std::ostream &ost, const RandomPool &x);
+    /**
+     * Thread-safe. Requests larger than pool::slot_bytes bypass the ring.
+     */
+    void operator()(void *out, const size_t num_bytes) noexcept;
+    auto num_slots() const noexcept { return num_slots_; }
+    auto num_fallbacks() const noexcept
+    {
+        return num_fallbacks_.load(std::memory_order_relaxed);
+    }
+};
+
+inline std::ostream &operator<<(std::ostream &ost, const RandomPool &x)
+{
+    ost << fmt::format("RandomPool[num_slots={:d},num_fallbacks={:d}]",
+                       x.num_slots_, x.num_fallbacks());
+    return ost;
+}
+} // namespace clt
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "aes-ni.hpp"
+
+namespace clt {
+namespace prp {
+// NOTE: Number of indices evaluated in parallel in batched evaluation.
+constexpr size_t batch_width = 8;
+size_t default_num_rounds(const uint64_t domain_size) noexcept;
+} // namespace prp
+
+class SwapOrNot {
+    /**
+     * Small-domain PRP over [0, n) based on AES128 (Swap-or-Not).
+     * Each index is evaluated independently in O(1) memory without
+     * materializing the whole permutation.
+     * References:
+     * - Hoang, Morris, Rogaway, "An Enciphering Scheme Based on a Card
+     * Shuffle"
+     * https://eprint.iacr.org/2012/776
+     */
+    uint8_t expanded_keys_[aes128::block_bytes * (aes128::num_rounds + 1)];
+    uint64_t domain_size_;
+    std::vector<uint64_t> round_keys_;
+
+public:
+    using index_t = uint64_t;
+    SwapOrNot(const void *key, const uint64_t domain_size,
+              const size_t num_rounds);
+    SwapOrNot(const void *key, const uint64_t domain_size)
+        : SwapOrNot(key, domain_size, prp::default_num_rounds(domain_size))
+    {
+    }
+    SwapOrNot(const AES128::key_t &key, const uint64_t domain_size)
+        : SwapOrNot(key.data(), domain_size)
+    {
+    }
+    friend std::ostream &operator<<(std::ostream &ost, const SwapOrNot &x);
+    auto domain_size() const noexcept { return domain_size_; }
+    auto num_rounds() const noexcept { return round_keys_.size(); }
+    index_t forward(const index_t i) const noexcept;
+    index_t inverse(const index_t j) const noexcept;
+    void forward(index_t *out, const index_t *in,
+                 const size_t num_indices) const noexcept;
+    void inverse(index_t *out, const index_t *in,
+                 const size_t num_indices) const noexcept;
+    index_t operator()(const index_t i) const noexcept { return forward(i); }
+};
+
+inline std::ostream &operator<<(std::ostream &ost, const SwapOrNot &x)
+{
+    ost << fmt::format("SwapOrNot[domain_size={:d},num_rounds={:d}]",
+                       x.domain_size_, x.num_rounds());
+    return ost;
+}
+} // namespace clt
@@ -3,19 +3,83 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <ostream>
+
+#include "aes-ni.hpp"
 
 namespace clt {
 namespace rng {
 // NOTE: https://software.intel.com/sites/landingpage/IntrinsicsGuide/#expand=4546,4539,4539&text=rdrand
 
-void rdrand(uint16_t *out, const size_t num_elems) noexcept;
-void rdrand(uint32_t *out, const size_t num_elems) noexcept;
-void rdrand(uint64_t *out, const size_t num_elems) noexcept;
+// NOTE: Intel DRNG guide: RDRAND failing 10 times in a row indicates a
+// hardware failure, while RDSEED may fail transiently under contention.
+constexpr size_t rdrand_max_retries = 10;
+constexpr size_t rdseed_max_retries = 1024;
+
+/**
+ * Fill num_elems elements by RDRAND.
+ * Returns false if a step fails rdrand_max_retries times in a row.
+ */
+bool rdrand(uint16_t *out, const size_t num_elems) noexcept;
+bool rdrand(uint32_t *out, const size_t num_elems) noexcept;
+bool rdrand(uint64_t *out, const size_t num_elems) noexcept;
 using generic_rdrand_t = uint64_t;
-template <class T> void rdrand(T *out, const size_t num_elems) noexcept
+template <class T> bool rdrand(T *out, const size_t num_elems) noexcept
 {
     assert(sizeof(T) * num_elems >= sizeof(generic_rdrand_t));
-    rdrand(reinterpret_cast<uint64_t *>(out), num_elems);
+    return rdrand(reinterpret_cast<uint64_t *>(out), num_elems);
+}
+
+/**
+ * Fill num_elems elements by RDSEED.
+ * Returns false if a step fails rdseed_max_retries times in a row.
+ */
+bool rdseed(uint16_t *out, const size_t num_elems) noexcept;
+bool rdseed(uint32_t *out, const size_t num_elems) noexcept;
+bool rdseed(uint64_t *out, const size_t num_elems) noexcept;
+
+/**
+ * Fill num_elems elements by RDSEED, falling back to RDRAND, then to
+ * rng_global if the instructions are not available or keep failing.
+ */
+bool hardware_seed(uint64_t *out, const size_t num_elems) noexcept;
+
+namespace hybrid {
+constexpr uint64_t default_reseed_interval_blocks = uint64_t(1) << 16;
+} // namespace hybrid
+
+class HybridRandom {
+    /**
+     * AES128 in counter mode keyed by hardware_seed and rekeyed every
+     * reseed_interval_blocks blocks and after fork.
+     * Not thread-safe; use one instance per thread.
+     */
+    AES128 cipher_;
+    uint64_t counter_;
+    uint64_t reseed_interval_blocks_;
+    uint64_t fork_generation_;
+    uint64_t num_reseeds_;
+
+    bool reseed() noexcept;
+
+public:
+    /**
+     * Throws std::runtime_error if seeding fails.
+     */
+    explicit HybridRandom(const uint64_t reseed_interval_blocks =
+                              hybrid::default_reseed_interval_blocks);
+    friend std::ostream &operator<<(std::ostream &ost, const HybridRandom &x);
+    bool operator()(void *out, const size_t num_bytes) noexcept;
+    auto get_counter() const noexcept { return counter_; }
+    auto get_num_reseeds() const noexcept { return num_reseeds_; }
+};
+
+inline std::ostream &operator<<(std::ostream &ost, const HybridRandom &x)
+{
+    ost << fmt::format("HybridRandom[counter={:d},reseed_interval={:d},"
+                       "num_reseeds={:d}]",
+                       x.counter_, x.reseed_interval_blocks_, x.num_reseeds_);
+    return ost;
 }
 } // namespace rng
 } // namespace clt
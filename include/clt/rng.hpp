@@ -44,7 +44,30 @@ public:
     bool operator()(void *buff, const size_t byte_size);
 };
 
-extern RandomDevice rng_global;
+class SystemRandom {
+    /**
+     * Thread-safe entropy source of the OS.
+     * Small requests are served from a per-thread buffer refilled by
+     * getrandom(2), large requests go to getrandom(2) directly.
+     * The per-thread buffers are discarded in a child process after fork.
+     * NOTE: Falls back to /dev/urandom guarded by a mutex when getrandom(2)
+     * is not available.
+     */
+public:
+    static constexpr size_t buffer_bytes = 256;
+    SystemRandom() noexcept;
+    SystemRandom(const SystemRandom &) = delete;
+    SystemRandom &operator=(const SystemRandom &) = delete;
+    bool operator()(void *buff, const size_t byte_size) const noexcept;
+};
+
+extern SystemRandom rng_global;
+
+/**
+ * Number of fork(2) calls seen in the ancestry of this process.
+ * Per-thread generator states compare it to detect that they were cloned.
+ */
+uint64_t fork_generation() noexcept;
 
 template <class T> inline void init(T *buff, const size_t num_elems)
 {
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <ostream>
+
+#include "aes-ni.hpp"
+
+namespace clt {
+template <class Prf> class SharedCTR {
+    /**
+     * Counter-mode generator over Prf (AES128, MMO128 or AESPRF128) that is
+     * safe to share across threads.
+     * Each call reserves a disjoint range of counters by fetch_add and then
+     * generates the keystream without any lock, so no counter is ever used
+     * twice. For a single thread the output is the same as the *_CTR class.
+     * NOTE: A partial last block consumes a whole counter, as in
+     * ctr_byte_stream.
+     */
+    Prf prf_;
+    alignas(64) std::atomic<uint64_t> counter_;
+
+public:
+    explicit SharedCTR(const void *key) noexcept : prf_(key), counter_(0) {}
+    explicit SharedCTR(const AES128::key_t &key) noexcept
+        : SharedCTR(key.data())
+    {
+    }
+    SharedCTR() noexcept : SharedCTR(aes128::zero_key) {}
+    SharedCTR(const SharedCTR &) = delete;
+    SharedCTR &operator=(const SharedCTR &) = delete;
+    template <class T>
+    friend std::ostream &operator<<(std::ostream &ost,
+                                    const SharedCTR<T> &x);
+    void operator()(void *out, const size_t num_bytes) noexcept
+    {
+        const uint64_t num_blocks = aes128::bytes_to_blocks(num_bytes);
+        const auto start =
+            counter_.fetch_add(num_blocks, std::memory_order_relaxed);
+        // NOTE: 2^64 blocks are never reached in practice.
+        assert((start + num_blocks) >= start);
+        prf_.ctr_byte_stream(out, num_bytes, start);
+    }
+    /**
+     * Not thread-safe against concurrent operator().
+     */
+    void set_counter(const uint64_t counter) noexcept
+    {
+        counter_.store(counter, std::memory_order_relaxed);
+    }
+    auto get_counter() const noexcept
+    {
+        return counter_.load(std::memory_order_relaxed);
+    }
+};
+
+using AES128_SharedCTR = SharedCTR<AES128>;
+using MMO128_SharedCTR = SharedCTR<MMO128>;
+using AESPRF128_SharedCTR = SharedCTR<AESPRF128>;
+
+template <class T>
+inline std::ostream &operator<<(std::ostream &ost, const SharedCTR<T> &x)
+{
+    ost << fmt::format("SharedCTR[counter={:d},", x.get_counter());
+    ost << x.prf_ << "]";
+    return ost;
+}
+} // namespace clt
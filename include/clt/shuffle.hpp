@@ -1,10 +1,22 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <climits>
 #include <numeric>
+#include <ranges>
 #include <vector>
 #include <tuple>
 #include <functional>
+#include <limits>
+#include <type_traits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include <x86intrin.h>
 
 #include <gmpxx.h>
 
@@ -20,14 +32,16 @@ inline void mpz_set_ui64(mpz_class &out, const uint64_t in)
 
 inline mpz_class factorial(const uint64_t n)
 {
-    mpz_class fact = 1;
-    for (mpz_class i = 2; mpz_cmp_ui(i.get_mpz_t(), n) <= 0; i++) {
-        fact *= i;
-    }
+    static_assert(sizeof(uint64_t) == sizeof(unsigned long int));
+    mpz_class fact;
+    mpz_fac_ui(fact.get_mpz_t(), n);
     return fact;
 }
 
 namespace rng {
+// NOTE: 4 KiB of random indices per refill.
+constexpr size_t shuffle_rounding_chunk_elems = 512;
+
 template <class T, class Func>
 inline void shuffle_rejection(T *inplace, const size_t n, Func &&rng)
 {
@@ -42,16 +56,20 @@ template <class T, class Func>
 inline void shuffle_rounding(T *inplace, const size_t n, Func &&rng)
 {
     // NOTE: FY shuffle.
+    // NOTE: Random indices are drawn chunk by chunk from the RNG, so the extra
+    // memory is a fixed-size buffer regardless of n.
     using index_internal_t = uint64_t;
     assert(n < (index_internal_t(1) << 32));
-    static_assert((2 * sizeof(T)) <= sizeof(index_internal_t));
-    constexpr auto elem_bytes = sizeof(index_internal_t);
-    const auto random_bytes = n * elem_bytes;
-    std::vector<index_internal_t> random_indices(n);
-    rng(random_indices.data(), random_bytes);
-    for (size_t i = 1; i < n; i++) {
-        const auto j = random_indices[n - i] % (n - i + 1);
-        std::swap(inplace[j], inplace[n - i]);
+    constexpr size_t chunk_elems = shuffle_rounding_chunk_elems;
+    std::array<index_internal_t, chunk_elems> random_indices;
+    size_t i = 1;
+    while (i < n) {
+        const size_t num_elems = std::min(chunk_elems, n - i);
+        rng(random_indices.data(), num_elems * sizeof(index_internal_t));
+        for (size_t k = 0; k < num_elems; k++, i++) {
+            const auto j = random_indices[k] % (n - i + 1);
+            std::swap(inplace[j], inplace[n - i]);
+        }
     }
 }
 
@@ -68,18 +86,337 @@ inline void shuffle(std::vector<T> &inplace, Func &&rng)
 }
 } // namespace rng
 
-struct Permutation {
-    using index_t = uint64_t;
+namespace internal {
+template <class T> inline auto bit_at(const std::vector<T> &in, const size_t at)
+{
+    const size_t elem_bit_size = sizeof(T) * CHAR_BIT;
+    const size_t position = at / elem_bit_size;
+    const size_t bit_position = at % elem_bit_size;
+    const auto data = in[position];
+    const auto mask = T(1) << bit_position;
+    return data & mask;
+}
+
+// NOTE: Below this size, thread start-up costs more than the gather itself.
+constexpr size_t permutation_parallel_threshold = size_t(1) << 16;
+// NOTE: Distance in elements between the prefetched and the accessed index.
+constexpr size_t permutation_prefetch_distance = 16;
+// NOTE: Steps of the leader search of the parallel in-place permutation,
+// beyond which a cycle is left to the serial pass.
+constexpr size_t permutation_max_leader_walk = 64;
+// NOTE: Roughly an L2 cache, used as the window of blocked gather/scatter.
+constexpr size_t permutation_block_bytes = size_t(1) << 20;
+
+template <class T> inline void prefetch(const T *p)
+{
+    _mm_prefetch(reinterpret_cast<const char *>(p), _MM_HINT_T0);
+}
+
+/**
+ * Stable counting sort of positions [0, n) by key(i) / block_elems, where
+ * block_elems is rounded down to a power of 2.
+ * Returns the bucket offsets and the sorted positions.
+ * Within each bucket, positions are in increasing order.
+ */
+template <class KeyFunc>
+inline auto bucket_positions(const size_t n, const size_t block_elems,
+                             KeyFunc &&key)
+{
+    size_t shift = 0;
+    while ((size_t(2) << shift) <= block_elems) {
+        shift++;
+    }
+    const size_t num_buckets = int_ceiling(n, size_t(1) << shift);
+    std::vector<size_t> offsets(num_buckets + 1, 0);
+    std::vector<size_t> positions(n);
+#ifdef _OPENMP
+    const size_t num_workers =
+        (n >= permutation_parallel_threshold) ? omp_get_max_threads() : 1;
+#else
+    const size_t num_workers = 1;
+#endif
+    std::vector<size_t> counts(num_workers * num_buckets, 0);
+    const size_t chunk = int_ceiling(n, num_workers);
+#pragma omp parallel for num_threads(num_workers) schedule(static, 1)
+    for (size_t t = 0; t < num_workers; t++) {
+        auto *p_counts = counts.data() + t * num_buckets;
+        const size_t end = std::min(n, (t + 1) * chunk);
+        for (size_t i = t * chunk; i < end; i++) {
+            p_counts[key(i) >> shift]++;
+        }
+    }
+    size_t acc = 0;
+    for (size_t b = 0; b < num_buckets; b++) {
+        offsets[b] = acc;
+        for (size_t t = 0; t < num_workers; t++) {
+            const auto c = counts[t * num_buckets + b];
+            counts[t * num_buckets + b] = acc;
+            acc += c;
+        }
+    }
+    offsets[num_buckets] = acc;
+    assert(acc == n);
+#pragma omp parallel for num_threads(num_workers) schedule(static, 1)
+    for (size_t t = 0; t < num_workers; t++) {
+        auto *p_cursors = counts.data() + t * num_buckets;
+        const size_t end = std::min(n, (t + 1) * chunk);
+        for (size_t i = t * chunk; i < end; i++) {
+            positions[p_cursors[key(i) >> shift]++] = i;
+        }
+    }
+    return std::make_tuple(std::move(offsets), std::move(positions));
+}
+} // namespace internal
+
+template <class T, class U>
+inline void apply_permutation(T *out, const T *in, const U *perm,
+                              const size_t n)
+{
+    // NOTE: Gather, out[i] = in[perm[i]].
+    assert(out != in);
+    constexpr size_t d = internal::permutation_prefetch_distance;
+#pragma omp parallel for if (n >= internal::permutation_parallel_threshold)
+    for (size_t i = 0; i < n; i++) {
+        if (i + d < n) {
+            internal::prefetch(in + perm[i + d]);
+        }
+        out[i] = in[perm[i]];
+    }
+}
+
+template <class T, class U>
+inline void scatter_permutation(T *out, const T *in, const U *perm,
+                                const size_t n)
+{
+    // NOTE: Scatter, out[perm[i]] = in[i], i.e., apply the inverse of perm.
+    assert(out != in);
+    constexpr size_t d = internal::permutation_prefetch_distance;
+#pragma omp parallel for if (n >= internal::permutation_parallel_threshold)
+    for (size_t i = 0; i < n; i++) {
+        if (i + d < n) {
+            internal::prefetch(out + perm[i + d]);
+        }
+        out[perm[i]] = in[i];
+    }
+}
+
+template <class T, class U>
+inline void apply_permutation_blocked(
+    T *out, const T *in, const U *perm, const size_t n,
+    const size_t block_elems =
+        std::max<size_t>(1, internal::permutation_block_bytes / sizeof(T)))
+{
+    /**
+     * Gather whose source reads stay inside one cache-sized window at a time.
+     * NOTE: Needs n extra words for the bucketed positions. This pays off
+     * only when in[] is much larger than the last-level cache.
+     */
+    assert(out != in);
+    assert(block_elems > 0);
+    const auto buckets = internal::bucket_positions(
+        n, block_elems, [perm](const size_t i) { return perm[i]; });
+    const auto &offsets = std::get<0>(buckets);
+    const auto &positions = std::get<1>(buckets);
+    const size_t num_buckets = offsets.size() - 1;
+    const bool is_parallel = n >= internal::permutation_parallel_threshold;
+#pragma omp parallel for schedule(dynamic) if (is_parallel)
+    for (size_t b = 0; b < num_buckets; b++) {
+        for (size_t k = offsets[b]; k < offsets[b + 1]; k++) {
+            const auto i = positions[k];
+            out[i] = in[perm[i]];
+        }
+    }
+}
+
+template <class T, class U>
+inline void apply_permutation_inplace(T *inplace, const U *perm,
+                                      const size_t n)
+{
+    /**
+     * Same as apply_permutation, but overwrites the input by following the
+     * cycles of perm.
+     * NOTE: The extra memory is a visited bitmap of n bits.
+     */
+    constexpr size_t word_bits = sizeof(uint64_t) * CHAR_BIT;
+    std::vector<uint64_t> visited(int_ceiling(n, word_bits), 0);
+    for (size_t s = 0; s < n; s++) {
+        if (internal::bit_at(visited, s)) {
+            continue;
+        }
+        T tmp = std::move(inplace[s]);
+        size_t j = s;
+        while (true) {
+            visited[j / word_bits] |= uint64_t(1) << (j % word_bits);
+            const size_t k = perm[j];
+            if (k == s) {
+                inplace[j] = std::move(tmp);
+                break;
+            }
+            inplace[j] = std::move(inplace[k]);
+            j = k;
+        }
+    }
+}
+
+template <class T, class U>
+inline void apply_permutation_inplace_parallel(T *inplace, const U *perm,
+                                               const size_t n)
+{
+    /**
+     * Parallel version of apply_permutation_inplace.
+     * Each cycle of length at most internal::permutation_max_leader_walk is
+     * rotated by the thread owning its smallest index (the leader), which
+     * is found by walking the cycle until a smaller or an already visited
+     * index appears. Longer cycles are left unvisited and rotated by a
+     * serial pass, so the total work is O(n) whatever the cycle structure,
+     * e.g., a cyclic shift is one cycle of length n.
+     * NOTE: Scales when perm has many short independent cycles.
+     */
+    constexpr size_t word_bits = sizeof(uint64_t) * CHAR_BIT;
+    constexpr size_t max_walk = internal::permutation_max_leader_walk;
+    std::vector<uint64_t> visited(int_ceiling(n, word_bits), 0);
+    auto is_visited = [&visited](const size_t j) {
+        const std::atomic_ref<uint64_t> word(visited[j / word_bits]);
+        const auto bits = word.load(std::memory_order_relaxed);
+        return (bits >> (j % word_bits)) & 1;
+    };
+    auto set_visited = [&visited](const size_t j) {
+        std::atomic_ref<uint64_t> word(visited[j / word_bits]);
+        word.fetch_or(uint64_t(1) << (j % word_bits),
+                      std::memory_order_relaxed);
+    };
+    auto rotate = [&](const size_t s) {
+        T tmp = std::move(inplace[s]);
+        size_t j = s;
+        while (true) {
+            set_visited(j);
+            const size_t k = perm[j];
+            if (k == s) {
+                inplace[j] = std::move(tmp);
+                break;
+            }
+            inplace[j] = std::move(inplace[k]);
+            j = k;
+        }
+    };
+    const bool is_parallel = n >= internal::permutation_parallel_threshold;
+#pragma omp parallel for schedule(dynamic, 1024) if (is_parallel)
+    for (size_t s = 0; s < n; s++) {
+        if (is_visited(s)) {
+            continue;
+        }
+        bool is_leader = true;
+        size_t num_steps = 0;
+        for (size_t j = perm[s]; j != s; j = perm[j]) {
+            if ((j < s) || is_visited(j) || (++num_steps >= max_walk)) {
+                is_leader = false;
+                break;
+            }
+        }
+        if (is_leader) {
+            rotate(s);
+        }
+    }
+    // NOTE: Cycles longer than max_walk have no leader and are still
+    // entirely unvisited.
+    for (size_t s = 0; s < n; s++) {
+        if (!is_visited(s)) {
+            rotate(s);
+        }
+    }
+}
+
+template <class T, class U>
+inline void apply_permutation_inplace(std::vector<T> &inplace,
+                                      const std::vector<U> &perm)
+{
+    assert(std::size(inplace) == std::size(perm));
+    apply_permutation_inplace(inplace.data(), perm.data(), std::size(perm));
+}
+
+template <class T, class U>
+inline auto apply_permutation(const std::vector<T> &in,
+                              const std::vector<U> &perm)
+{
+    assert(std::size(in) == std::size(perm));
+    std::vector<T> out(std::size(in));
+    apply_permutation(out.data(), in.data(), perm.data(), std::size(in));
+    return out;
+}
+
+template <class T>
+inline void inverse_permutation(T *out, const T *in, const size_t n)
+{
+    // NOTE: Direct scatter in O(n), out[in[i]] = i.
+    static_assert(std::is_integral_v<T>);
+    assert(out != in);
+    constexpr size_t d = internal::permutation_prefetch_distance;
+#pragma omp parallel for if (n >= internal::permutation_parallel_threshold)
+    for (size_t i = 0; i < n; i++) {
+        if (i + d < n) {
+            internal::prefetch(out + in[i + d]);
+        }
+        out[in[i]] = static_cast<T>(i);
+    }
+}
+
+template <class T>
+inline void inverse_permutation_blocked(
+    T *out, const T *in, const size_t n,
+    const size_t block_elems =
+        std::max<size_t>(1, internal::permutation_block_bytes / sizeof(T)))
+{
+    /**
+     * Scatter whose destination writes stay inside one cache-sized window at
+     * a time.
+     * NOTE: Needs n extra words for the bucketed positions.
+     */
+    static_assert(std::is_integral_v<T>);
+    assert(out != in);
+    assert(block_elems > 0);
+    const auto buckets = internal::bucket_positions(
+        n, block_elems, [in](const size_t i) { return in[i]; });
+    const auto &offsets = std::get<0>(buckets);
+    const auto &positions = std::get<1>(buckets);
+    const size_t num_buckets = offsets.size() - 1;
+    const bool is_parallel = n >= internal::permutation_parallel_threshold;
+#pragma omp parallel for schedule(dynamic) if (is_parallel)
+    for (size_t b = 0; b < num_buckets; b++) {
+        for (size_t k = offsets[b]; k < offsets[b + 1]; k++) {
+            const auto i = positions[k];
+            out[in[i]] = static_cast<T>(i);
+        }
+    }
+}
+
+template <class T> inline auto inverse_permutation(const std::vector<T> &in)
+{
+    std::vector<T> out(std::size(in));
+    inverse_permutation(out.data(), in.data(), std::size(in));
+    return out;
+}
+
+template <class IndexType = uint64_t> struct BasicPermutation {
+    /**
+     * NOTE: IndexType selects the storage width. 32-bit indices halve the
+     * memory and bandwidth for degrees up to 2^32.
+     */
+    static_assert(std::is_integral_v<IndexType>);
+    static_assert(std::is_unsigned_v<IndexType>);
+    using index_t = IndexType;
     using perm_t = std::vector<index_t>;
     perm_t indices_;
-    Permutation() = default;
-    explicit Permutation(const size_t degree)
+    BasicPermutation() = default;
+    explicit BasicPermutation(const size_t degree)
     {
+        assert((degree == 0) ||
+               ((degree - 1) <= std::numeric_limits<index_t>::max()));
         indices_.resize(degree);
         std::iota(indices_.begin(), indices_.end(), 0);
     }
     auto size() const { return indices_.size(); }
-    friend auto operator==(const Permutation &lhs, const Permutation &rhs)
+    friend auto operator==(const BasicPermutation &lhs,
+                           const BasicPermutation &rhs)
     {
         if (lhs.size() != rhs.size()) {
             return false;
@@ -87,15 +424,12 @@ struct Permutation {
         return std::equal(lhs.indices_.begin(), lhs.indices_.end(),
                           rhs.indices_.begin());
     }
-    friend auto operator!=(const Permutation &lhs, const Permutation &rhs)
+    friend auto operator!=(const BasicPermutation &lhs,
+                           const BasicPermutation &rhs)
     {
-        if (lhs.size() == rhs.size()) {
-            return false;
-        }
-        return !std::equal(lhs.indices_.begin(), lhs.indices_.end(),
-                           rhs.indices_.begin());
+        return !(lhs == rhs);
     }
-    friend auto &operator<<(std::ostream &ost, const Permutation &x)
+    friend auto &operator<<(std::ostream &ost, const BasicPermutation &x)
     {
         const auto n = x.indices_.size();
         ost << "[";
@@ -112,48 +446,43 @@ struct Permutation {
     }
     auto &operator[](const index_t i) { return indices_[i]; }
     auto operator[](const index_t i) const { return indices_[i]; }
-    auto apply(const Permutation &in) const
+    auto apply(const BasicPermutation &in) const
     {
         const size_t n = indices_.size();
-        Permutation out;
-        out.indices_.reserve(n);
-        for (size_t i = 0; i < n; i++) {
-            out.indices_.emplace_back(in[indices_[i]]);
-        }
+        BasicPermutation out;
+        out.indices_.resize(n);
+        apply_permutation(out.indices_.data(), in.indices_.data(),
+                          indices_.data(), n);
         return out;
     }
     template <class T> auto apply(const T &in) const
     {
         const size_t n = indices_.size();
         T out(in);
-        for (size_t i = 0; i < n; i++) {
-            out[i] = in[indices_[i]];
+        if constexpr (std::ranges::contiguous_range<T>) {
+            // NOTE: The prefetching gather, in parallel for large inputs.
+            apply_permutation(std::ranges::data(out), std::ranges::data(in),
+                              indices_.data(), n);
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                out[i] = in[indices_[i]];
+            }
         }
         return out;
     }
-    friend auto operator*(const Permutation &lhs, const Permutation &rhs)
+    friend auto operator*(const BasicPermutation &lhs,
+                          const BasicPermutation &rhs)
     {
         assert(lhs.indices_.size() == rhs.indices_.size());
-        Permutation out = lhs.apply(rhs);
+        BasicPermutation out = lhs.apply(rhs);
         return out;
     }
     auto inverse() const
     {
-        const size_t n = indices_.size();
-        using tuple_t = std::tuple<index_t, index_t>;
-        std::vector<tuple_t> t_vec;
-        t_vec.reserve(n);
-        for (size_t i = 0; i < n; i++) {
-            t_vec.emplace_back(indices_[i], i);
-        }
-        std::sort(t_vec.begin(), t_vec.end(),
-                  [](const tuple_t &lhs, const tuple_t &rhs) -> bool {
-                      return std::get<0>(lhs) < std::get<0>(rhs);
-                  });
-        Permutation out;
-        for (size_t i = 0; i < n; i++) {
-            out.indices_.emplace_back(std::get<1>(t_vec[i]));
-        }
+        BasicPermutation out;
+        out.indices_.resize(indices_.size());
+        inverse_permutation(out.indices_.data(), indices_.data(),
+                            indices_.size());
         return out;
     }
     void pivot(const index_t i, const index_t j)
@@ -167,66 +496,14 @@ struct Permutation {
     }
 };
 
-template <class T, class U>
-inline void apply_permutation(T *out, const T *in, const U *perm,
-                              const size_t n)
-{
-    assert(out != in);
-    for (size_t i = 0; i < n; i++) {
-        out[i] = in[perm[i]];
-    }
-}
-
-template <class T, class U>
-inline auto apply_permutation(const std::vector<T> &in,
-                              const std::vector<U> &perm)
-{
-    assert(std::size(in) == std::size(perm));
-    std::vector<T> out(std::size(in));
-    apply_permutation(out.data(), in.data(), perm.data(), std::size(in));
-    return out;
-}
-
-template <class T>
-inline void inverse_permutation(T *out, const T *in, const size_t n)
-{
-    using tuple_t = std::tuple<T, uint32_t>;
-    std::vector<tuple_t> t_vec;
-    t_vec.reserve(n);
-    for (size_t i = 0; i < n; i++) {
-        t_vec.emplace_back(in[i], i);
-    }
-    std::sort(t_vec.begin(), t_vec.end(),
-              [](const tuple_t &lhs, const tuple_t &rhs) -> bool {
-                  return std::get<0>(lhs) < std::get<0>(rhs);
-              });
-    for (size_t i = 0; i < n; i++) {
-        out[i] = std::get<1>(t_vec[i]);
-    }
-}
-
-template <class T> inline auto inverse_permutation(const std::vector<T> &in)
-{
-    std::vector<T> out(std::size(in));
-    inverse_permutation(out.data(), in.data(), std::size(in));
-    return out;
-}
+using Permutation = BasicPermutation<uint64_t>;
+using Permutation32 = BasicPermutation<uint32_t>;
 
 using permutation_t = Permutation::perm_t;
-mpz_class rank(const permutation_t &pi);
-permutation_t unrank(const mpz_class &r, const size_t degree);
-
-namespace internal {
-template <class T> inline auto bit_at(const std::vector<T> &in, const size_t at)
-{
-    const size_t elem_bit_size = sizeof(T) * CHAR_BIT;
-    const size_t position = at / elem_bit_size;
-    const size_t bit_position = at % elem_bit_size;
-    const auto data = in[position];
-    const auto mask = T(1) << bit_position;
-    return data & mask;
-}
-} // namespace internal
+// NOTE: Instantiated for uint32_t and uint64_t indices.
+template <class T> mpz_class rank(const std::vector<T> &pi);
+template <class T = uint64_t>
+std::vector<T> unrank(const mpz_class &r, const size_t degree);
 
 template <class T, class RngFunc>
 inline void shuffle_RS(std::vector<T> &inplace, RngFunc &&rng)
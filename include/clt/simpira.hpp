@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+#include "aes-ni.hpp"
+
+namespace clt {
+namespace simpira {
+// NOTE: Widths of 2, 4 and 8 blocks, i.e., 256, 512 and 1024 bits.
+constexpr bool is_valid_width(const size_t num_blocks) noexcept
+{
+    return (num_blocks == 2) || (num_blocks == 4) || (num_blocks == 8);
+}
+constexpr size_t num_rounds(const size_t num_blocks) noexcept
+{
+    return (num_blocks == 8) ? 18 : 15;
+}
+// NOTE: States permuted in lock step by the batched interface, so that
+// about 8 F functions are independent per round.
+constexpr size_t batch_width(const size_t num_blocks) noexcept
+{
+    return 16 / num_blocks;
+}
+} // namespace simpira
+
+template <size_t Blocks> class Simpira {
+    /**
+     * Simpira v2 over states of Blocks 128-bit blocks x_0, ..., x_{Blocks-1}
+     * by Algorithm 1 of the paper: a round applies x_j ^= F_c(x_i) for
+     * Blocks / 2 pairs (i, j), with a counter c starting at 1, where
+     * F_c(x) = AESENC(AESENC(x, C), 0) with the round constant
+     * C = (c ^ b, 0x10 ^ c ^ b, 0x20 ^ c ^ b, 0x30 ^ c ^ b) of 32-bit words
+     * and b = Blocks.
+     * References:
+     * - Gueron, Mouha, "Simpira v2: A Family of Efficient Permutations Using
+     * the AES Round Function"
+     * https://eprint.iacr.org/2016/122
+     */
+    static_assert(simpira::is_valid_width(Blocks));
+
+public:
+    static constexpr size_t num_blocks = Blocks;
+    static constexpr size_t state_bytes = aes128::block_bytes * Blocks;
+    static constexpr size_t num_rounds = simpira::num_rounds(Blocks);
+    static constexpr size_t batch_width = simpira::batch_width(Blocks);
+    /**
+     * The permutation of num_states consecutive states of state_bytes
+     * bytes each, by batches of batch_width states.
+     */
+    static void permute(void *out, const void *in,
+                        const size_t num_states = 1) noexcept;
+    static void inverse(void *out, const void *in,
+                        const size_t num_states = 1) noexcept;
+};
+
+template <size_t Blocks> class WideBlockCipher {
+    /**
+     * Tweakable block cipher of Blocks 128-bit blocks by the one-round
+     * tweakable Even-Mansour construction over Simpira<Blocks>:
+     * E_{K,T}(x) = P(x ^ M_T) ^ M_T with the mask
+     * M_T = (L_0 ^ d_T, ..., L_{Blocks - 1} ^ d_T), where
+     * L_j = AES128_K(1 || j) and d_T = AES128_K(0 || T) for 64-bit halves.
+     * The tweak differences of masks are almost xor universal, so it is a
+     * tweakable PRP up to about 2^64 queries, limited by the 128-bit d_T,
+     * when Simpira<Blocks> is modeled as an ideal permutation.
+     * References:
+     * - Cogliati, Lampe, Seurin, "Tweaking Even-Mansour Ciphers"
+     * https://eprint.iacr.org/2015/539
+     */
+    uint8_t expanded_keys_[aes128::block_bytes * (aes128::num_rounds + 1)];
+    uint8_t whitening_[Simpira<Blocks>::state_bytes];
+
+public:
+    static constexpr size_t state_bytes = Simpira<Blocks>::state_bytes;
+    explicit WideBlockCipher(const void *key) noexcept;
+    template <size_t B>
+    friend std::ostream &operator<<(std::ostream &ost,
+                                    const WideBlockCipher<B> &x);
+    /**
+     * Encryption of num_states consecutive states, where state i uses the
+     * tweak tweak + i, as sectors of a disk.
+     */
+    void enc(void *out, const void *in, const size_t num_states = 1,
+             const uint64_t tweak = 0) const noexcept;
+    void dec(void *out, const void *in, const size_t num_states = 1,
+             const uint64_t tweak = 0) const noexcept;
+};
+
+template <size_t B>
+inline std::ostream &operator<<(std::ostream &ost,
+                                const WideBlockCipher<B> &x)
+{
+    ost << fmt::format("WideBlockCipher<{:d}>[key=[{:>02x}]]", B,
+                       fmt::join(x.expanded_keys_,
+                                 x.expanded_keys_ + aes128::key_bytes, ":"));
+    return ost;
+}
+} // namespace clt
+
+#include "detail/simpira_impl.hpp"
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "aes-ni.hpp"
+
+namespace clt {
+/**
+ * Run func(i, ctr) for i in [0, num_tasks) in parallel by OpenMP, where ctr
+ * is base.split(first_stream_id + i).
+ * Each task owns its stream, so the output does not depend on the number of
+ * threads or the schedule. The streams must not include the one of base,
+ * otherwise a task replays the keystream of base.
+ * CTR is any class with split, e.g., AES128_CTR, MMO128_CTR, AESPRF128_CTR.
+ */
+template <class CTR, class Func>
+inline void parallel_for_streams(const CTR &base, const size_t num_tasks,
+                                 Func &&func, const uint64_t first_stream_id)
+{
+    assert((base.get_stream_id() < first_stream_id) ||
+           (base.get_stream_id() - first_stream_id >= num_tasks));
+#pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < num_tasks; i++) {
+        auto ctr = base.split(first_stream_id + i);
+        func(i, ctr);
+    }
+}
+
+/**
+ * The streams following the one of base, so base stays usable alongside
+ * the tasks.
+ */
+template <class CTR, class Func>
+inline void parallel_for_streams(const CTR &base, const size_t num_tasks,
+                                 Func &&func)
+{
+    parallel_for_streams(base, num_tasks, std::forward<Func>(func),
+                         base.get_stream_id() + 1);
+}
+} // namespace clt
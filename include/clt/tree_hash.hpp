@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "aes-ni.hpp"
+#include "hirose.hpp"
+
+namespace clt {
+namespace tree_hash {
+constexpr size_t digest_bytes = hirose::digest_bytes;
+// NOTE: Bytes of a leaf, a multiple of hirose::block_bytes, so that a leaf
+// costs leaf_bytes / 16 + 1 compressions and a node 5.
+constexpr size_t default_leaf_bytes = 1 << 13;
+// NOTE: Domain tags of leaves, nodes and the root, hashed with the IV into
+// their own IVs.
+enum class Domain : uint8_t { Leaf = 0, Node = 1, Root = 2 };
+} // namespace tree_hash
+
+class TreeHash {
+    /**
+     * Tree mode of Hirose256 for large inputs: the input is split into
+     * leaves of leaf_bytes bytes, the last one possibly shorter and at
+     * least one leaf, and the digests of leaves are combined pairwise level
+     * by level, where the last digest of a level of odd size goes up
+     * unchanged; the root is the hash of the top digest and the length in
+     * bytes as a little-endian 64-bit integer.
+     * Leaves, nodes and the root use distinct IVs, Hirose256 of the IV of
+     * the domain tag, so a leaf is never confused with a node.
+     * Leaves and the nodes of a level are hashed by batches of
+     * hirose::batch_width, in parallel by OpenMP if parallel is true.
+     * References:
+     * - Bertoni, Daemen, Peeters, Van Assche, "Sufficient conditions for
+     * sound tree and sequential hashing modes"
+     * https://eprint.iacr.org/2009/210
+     * - O'Connor, Aumasson, Neves, Wilcox-O'Hearn, "BLAKE3"
+     * https://github.com/BLAKE3-team/BLAKE3-specs
+     */
+    Hirose256 leaf_, node_, root_;
+    size_t leaf_bytes_;
+
+public:
+    explicit TreeHash(const size_t leaf_bytes = tree_hash::default_leaf_bytes,
+                      const void *iv = hirose::default_iv);
+    friend std::ostream &operator<<(std::ostream &ost, const TreeHash &x);
+    auto leaf_bytes() const noexcept { return leaf_bytes_; }
+    size_t num_leaves(const uint64_t num_bytes) const noexcept;
+    /**
+     * Digests of the num_leaves(num_bytes) leaves of in into out of 32
+     * bytes each.
+     */
+    void hash_leaves(void *out, const void *in, const uint64_t num_bytes,
+                     const bool parallel = false) const noexcept;
+    /**
+     * Digest of 32 bytes of the subtree of num_digests digests of leaves or
+     * subtrees, in place.
+     */
+    void hash_nodes(void *digests, const size_t num_digests,
+                    const bool parallel = false) const;
+    /**
+     * Digest of 32 bytes of the top digest of the tree of an input of
+     * num_bytes bytes.
+     */
+    void hash_root(void *out, const void *top,
+                   const uint64_t num_bytes) const noexcept;
+    void hash(void *out, const void *in, const uint64_t num_bytes,
+              const bool parallel = false) const;
+    /**
+     * hash of the file at path, mapped by mmap; throw std::runtime_error if
+     * it cannot be read.
+     */
+    void hash_file(void *out, const std::string &path,
+                   const bool parallel = false) const;
+};
+
+class TreeHashStream {
+    /**
+     * Streaming interface of TreeHash with the same digests: whole leaves
+     * are hashed once they are complete, and subtrees of 2^k leaves are
+     * merged at once, so that only a stack of their digests is kept.
+     */
+    TreeHash hash_;
+    std::vector<uint8_t> buffer_;
+    size_t buffered_;
+    // NOTE: Digests of subtrees of decreasing sizes, the binary expansion
+    // of num_leaves_.
+    std::vector<uint8_t> stack_;
+    uint64_t num_leaves_;
+    uint64_t num_bytes_;
+
+    void push(const uint8_t *digest);
+
+public:
+    explicit TreeHashStream(
+        const size_t leaf_bytes = tree_hash::default_leaf_bytes,
+        const void *iv = hirose::default_iv);
+    friend std::ostream &operator<<(std::ostream &ost,
+                                    const TreeHashStream &x);
+    auto num_bytes() const noexcept { return num_bytes_; }
+    /**
+     * Absorb num_bytes bytes of in, whose whole leaves are hashed in
+     * parallel by OpenMP if parallel is true.
+     */
+    void update(const void *in, const size_t num_bytes,
+                const bool parallel = false);
+    void finalize(void *out) const;
+};
+
+inline std::ostream &operator<<(std::ostream &ost, const TreeHash &x)
+{
+    ost << fmt::format("TreeHash[leaf_bytes={:d}]", x.leaf_bytes_);
+    return ost;
+}
+
+inline std::ostream &operator<<(std::ostream &ost, const TreeHashStream &x)
+{
+    ost << fmt::format("TreeHashStream[leaf_bytes={:d},num_bytes={:d}]",
+                       x.hash_.leaf_bytes(), x.num_bytes_);
+    return ost;
+}
+} // namespace clt
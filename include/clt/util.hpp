@@ -120,6 +120,11 @@ template <class T> auto all_xor(T &vec)
     return v;
 }
 
+/**
+ * Zeroize secret material without being elided as a dead store.
+ */
+void secure_wipe(void *p, const size_t num_bytes) noexcept;
+
 inline auto int_ceiling(const size_t n, const size_t d)
 {
     const auto q = n / d;
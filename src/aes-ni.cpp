@@ -42,17 +42,6 @@ AES128::AES128(const void *key) noexcept
     }
 }
 
-namespace internal {
-inline void aes128_load_expkey_for_enc(__m128i *keys,
-                                       const uint8_t *in) noexcept
-{
-    const auto *p_in = reinterpret_cast<const __m128i *>(in);
-    for (size_t i = 0; i < (aes128::num_rounds + 1); i++) {
-        keys[i] = _mm_loadu_si128(p_in + i);
-    }
-}
-} // namespace internal
-
 void AES128::enc(void *out, const void *in) const noexcept
 {
     using internal::single::aes128_enc_impl;
@@ -103,13 +92,14 @@ void AES128::enc(void *out, const void *in,
 }
 
 auto AES128::ctr_stream(void *out, const uint64_t num_blocks,
-                        const uint64_t start_count) const noexcept
+                        const uint64_t start_count,
+                        const uint64_t stream_id) const noexcept
     -> decltype(num_blocks + start_count)
 {
     // _mm256_zeroall();
     __m128i keys[11];
     internal::aes128_load_expkey_for_enc(keys, expanded_keys_);
-    auto ctr = _mm_cvtsi64_si128(start_count);
+    auto ctr = _mm_set_epi64x(stream_id, start_count);
     const auto inc_v = _mm_cvtsi64_si128(1);
     for (size_t i = 0; i < num_blocks; i++) {
         __m128i m = ctr;
@@ -123,15 +113,17 @@ auto AES128::ctr_stream(void *out, const uint64_t num_blocks,
 }
 
 auto AES128::ctr_byte_stream(void *out, const uint64_t num_bytes,
-                             const uint64_t start_count) const noexcept
+                             const uint64_t start_count,
+                             const uint64_t stream_id) const noexcept
     -> decltype(num_bytes + start_count)
 {
     const auto num_blocks = num_bytes / aes128::block_bytes;
     const auto rem_bytes = num_bytes % aes128::block_bytes;
-    const auto counter = ctr_stream(out, num_blocks, start_count);
+    const auto counter =
+        ctr_stream(out, num_blocks, start_count, stream_id);
     if (rem_bytes > 0) {
         std::array<uint8_t, aes128::block_bytes> m;
-        const auto counter_ = ctr_stream(m.data(), 1, counter);
+        const auto counter_ = ctr_stream(m.data(), 1, counter, stream_id);
         assert(counter_ == counter + 1);
         auto *const ptr_rem_out =
             reinterpret_cast<uint8_t *>(out) + num_blocks * aes128::block_bytes;
@@ -247,13 +239,14 @@ void MMO128::operator()(void *out, const void *in,
 }
 
 auto MMO128::ctr_stream(void *out, const uint64_t num_blocks,
-                        const uint64_t start_count) const noexcept
+                        const uint64_t start_count,
+                        const uint64_t stream_id) const noexcept
     -> decltype(num_blocks + start_count)
 {
     // _mm256_zeroall();
     __m128i keys[11];
     internal::aes128_load_expkey_for_enc(keys, expanded_keys_);
-    auto ctr = _mm_cvtsi64_si128(start_count);
+    auto ctr = _mm_set_epi64x(stream_id, start_count);
     const auto inc_v = _mm_cvtsi64_si128(1);
     for (size_t i = 0; i < num_blocks; i++) {
         __m128i m = ctr;
@@ -267,15 +260,17 @@ auto MMO128::ctr_stream(void *out, const uint64_t num_blocks,
 }
 
 auto MMO128::ctr_byte_stream(void *out, const uint64_t num_bytes,
-                             const uint64_t start_count) const noexcept
+                             const uint64_t start_count,
+                             const uint64_t stream_id) const noexcept
     -> decltype(num_bytes + start_count)
 {
     const auto num_blocks = num_bytes / aes128::block_bytes;
     const auto rem_bytes = num_bytes % aes128::block_bytes;
-    const auto counter = ctr_stream(out, num_blocks, start_count);
+    const auto counter =
+        ctr_stream(out, num_blocks, start_count, stream_id);
     if (rem_bytes > 0) {
         std::array<uint8_t, aes128::block_bytes> m;
-        const auto counter_ = ctr_stream(m.data(), 1, counter);
+        const auto counter_ = ctr_stream(m.data(), 1, counter, stream_id);
         assert(counter_ == counter + 1);
         auto *const ptr_rem_out =
             reinterpret_cast<uint8_t *>(out) + num_blocks * aes128::block_bytes;
@@ -286,6 +281,44 @@ auto MMO128::ctr_byte_stream(void *out, const uint64_t num_bytes,
     }
 }
 
+inline __m128i mmo128_sigma(const __m128i x) noexcept
+{
+    // NOTE: A linear orthomorphism, (xl, xr) -> (xr, xl xor xr) in lanes.
+    return _mm_xor_si128(_mm_shuffle_epi32(x, 0x4e),
+                         _mm_and_si128(x, _mm_set_epi64x(-1, 0)));
+}
+
+void MMO128::tccr(void *out, const void *in, const uint64_t *tweaks,
+                  const size_t num_blocks) const noexcept
+{
+    constexpr size_t W = 8;
+    __m128i keys[11];
+    internal::aes128_load_expkey_for_enc(keys, expanded_keys_);
+    const auto *p_in = reinterpret_cast<const __m128i *>(in);
+    auto *p_out = reinterpret_cast<__m128i *>(out);
+    size_t i = 0;
+    for (; (i + W) <= num_blocks; i += W) {
+        __m128i xs[W], ms[W];
+        for (size_t k = 0; k < W; k++) {
+            xs[k] = mmo128_sigma(_mm_loadu_si128(p_in + i + k));
+            ms[k] = _mm_xor_si128(xs[k], _mm_cvtsi64_si128(tweaks[i + k]));
+        }
+        using internal::sfinae::aes128_enc_impl;
+        using internal::sfinae::width_round_t;
+        aes128_enc_impl(ms, width_round_t<W, 0>{}, keys);
+        for (size_t k = 0; k < W; k++) {
+            _mm_storeu_si128(p_out + i + k, _mm_xor_si128(ms[k], xs[k]));
+        }
+    }
+    for (; i < num_blocks; i++) {
+        const auto x = mmo128_sigma(_mm_loadu_si128(p_in + i));
+        auto m = _mm_xor_si128(x, _mm_cvtsi64_si128(tweaks[i]));
+        using internal::single::aes128_enc_impl;
+        aes128_enc_impl<0>(m, keys);
+        _mm_storeu_si128(p_out + i, _mm_xor_si128(m, x));
+    }
+}
+
 AESPRF128::AESPRF128(const void *key) noexcept
 {
     __m128i keys[aes128::num_rounds + 1];
@@ -327,13 +360,14 @@ void AESPRF128::operator()(void *out, const void *in,
 }
 
 auto AESPRF128::ctr_stream(void *out, const uint64_t num_blocks,
-                           const uint64_t start_count) const noexcept
+                           const uint64_t start_count,
+                           const uint64_t stream_id) const noexcept
     -> decltype(num_blocks + start_count)
 {
     // _mm256_zeroall();
     __m128i keys[11];
     internal::aes128_load_expkey_for_enc(keys, expanded_keys_);
-    auto ctr = _mm_cvtsi64_si128(start_count);
+    auto ctr = _mm_set_epi64x(stream_id, start_count);
     const auto inc_v = _mm_cvtsi64_si128(1);
     for (size_t i = 0; i < num_blocks; i++) {
         __m128i m = ctr;
@@ -346,15 +380,17 @@ auto AESPRF128::ctr_stream(void *out, const uint64_t num_blocks,
 }
 
 auto AESPRF128::ctr_byte_stream(void *out, const uint64_t num_bytes,
-                                const uint64_t start_count) const noexcept
+                                const uint64_t start_count,
+                                const uint64_t stream_id) const noexcept
     -> decltype(num_bytes + start_count)
 {
     const auto num_blocks = num_bytes / aes128::block_bytes;
     const auto rem_bytes = num_bytes % aes128::block_bytes;
-    const auto counter = ctr_stream(out, num_blocks, start_count);
+    const auto counter =
+        ctr_stream(out, num_blocks, start_count, stream_id);
     if (rem_bytes > 0) {
         std::array<uint8_t, aes128::block_bytes> m;
-        const auto counter_ = ctr_stream(m.data(), 1, counter);
+        const auto counter_ = ctr_stream(m.data(), 1, counter, stream_id);
         assert(counter_ == counter + 1);
         auto *const ptr_rem_out =
             reinterpret_cast<uint8_t *>(out) + num_blocks * aes128::block_bytes;
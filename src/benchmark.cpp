@@ -1,5 +1,7 @@
 #include <tuple>
 
+#include <sys/resource.h>
+
 #include <clt/benchmark.hpp>
 
 namespace clt {
@@ -75,5 +77,20 @@ double measure_static(const function<void()> &func)
     return measure_walltime<microseconds>(func);
 }
 
+size_t peak_rss_bytes()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    // NOTE: ru_maxrss is in bytes on macOS.
+    return usage.ru_maxrss;
+#else
+    // NOTE: ru_maxrss is in kilobytes on Linux.
+    return usage.ru_maxrss * size_t(1024);
+#endif
+}
+
 } // namespace bench
 } // namespace clt
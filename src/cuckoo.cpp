@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include <x86intrin.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/cuckoo.hpp>
+
+namespace clt {
+namespace internal {
+inline void multi_hash_reduce(uint32_t *out, const __m128i m,
+                              const uint64_t num_bins,
+                              const size_t num_hashes) noexcept
+{
+    uint32_t words[cuckoo::max_hashes];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(words), m);
+    for (size_t h = 0; h < num_hashes; h++) {
+        out[h] = (uint64_t(words[h]) * num_bins) >> 32;
+    }
+}
+} // namespace internal
+
+MultiHash::MultiHash(const uint64_t num_bins, const size_t num_hashes,
+                     const void *key)
+    : num_bins_(num_bins), num_hashes_(num_hashes)
+{
+    if ((num_bins == 0) || (num_bins > (uint64_t(1) << 32))) {
+        throw std::invalid_argument(
+            fmt::format("MultiHash: invalid number of bins {:d}.", num_bins));
+    }
+    if ((num_hashes < 2) || (num_hashes > cuckoo::max_hashes)) {
+        throw std::invalid_argument(fmt::format(
+            "MultiHash: invalid number of hashes {:d}.", num_hashes));
+    }
+    __m128i keys[aes128::num_rounds + 1];
+    static_assert(sizeof(keys) == sizeof(expanded_keys_));
+    keys[0] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(key));
+    internal::aes128_key_expansion_impl<0>(keys);
+    auto *p_out = reinterpret_cast<__m128i *>(expanded_keys_);
+    for (size_t i = 0; i < std::size(keys); i++) {
+        _mm_storeu_si128(p_out + i, keys[i]);
+    }
+}
+
+void MultiHash::operator()(uint32_t *out, const void *items,
+                           const size_t num_items,
+                           [[maybe_unused]] const bool parallel) const noexcept
+{
+    constexpr size_t W = 8;
+    __m128i keys[aes128::num_rounds + 1];
+    internal::aes128_load_expkey_for_enc(keys, expanded_keys_);
+    const auto *p_in = reinterpret_cast<const __m128i *>(items);
+    const size_t num_batches = num_items / W;
+#pragma omp parallel for schedule(static) if (parallel)
+    for (size_t b = 0; b < num_batches; b++) {
+        __m128i ms[W];
+        for (size_t k = 0; k < W; k++) {
+            ms[k] = _mm_loadu_si128(p_in + W * b + k);
+        }
+        using internal::sfinae::aes128_enc_impl;
+        using internal::sfinae::width_round_t;
+        aes128_enc_impl(ms, width_round_t<W, 0>{}, keys);
+        for (size_t k = 0; k < W; k++) {
+            internal::multi_hash_reduce(out + num_hashes_ * (W * b + k),
+                                        ms[k], num_bins_, num_hashes_);
+        }
+    }
+    for (size_t i = W * num_batches; i < num_items; i++) {
+        auto m = _mm_loadu_si128(p_in + i);
+        using internal::single::aes128_enc_impl;
+        aes128_enc_impl<0>(m, keys);
+        internal::multi_hash_reduce(out + num_hashes_ * i, m, num_bins_,
+                                    num_hashes_);
+    }
+}
+
+void CuckooTable::build(const void *items, const size_t num_items,
+                        const bool parallel)
+{
+    const size_t k = hash_.num_hashes();
+    std::vector<uint32_t> hashes(k * num_items);
+    hash_(hashes.data(), items, num_items, parallel);
+    bins_.assign(hash_.num_bins(), cuckoo::empty);
+    stash_.clear();
+    for (size_t i = 0; i < num_items; i++) {
+        if ((i + cuckoo::prefetch_distance) < num_items) {
+            const auto *h = hashes.data() + k * (i + cuckoo::prefetch_distance);
+            for (size_t j = 0; j < k; j++) {
+                __builtin_prefetch(bins_.data() + h[j], 1);
+            }
+        }
+        uint64_t entry = cuckoo::pack(i, 0);
+        bool placed = false;
+        for (size_t step = 0; !placed && (step <= cuckoo::max_evictions);
+             step++) {
+            const auto *h = hashes.data() + k * cuckoo::index_of(entry);
+            for (size_t j = 0; j < k; j++) {
+                if (bins_[h[j]] == cuckoo::empty) {
+                    bins_[h[j]] = cuckoo::pack(cuckoo::index_of(entry), j);
+                    placed = true;
+                    break;
+                }
+            }
+            if (!placed) {
+                // NOTE: Evict the occupant of the bin of the current hash
+                // function, which tries its next one.
+                std::swap(entry, bins_[h[cuckoo::func_of(entry)]]);
+                entry = cuckoo::pack(cuckoo::index_of(entry),
+                                     (cuckoo::func_of(entry) + 1) % k);
+            }
+        }
+        if (!placed) {
+            stash_.push_back(cuckoo::index_of(entry));
+        }
+    }
+}
+
+uint64_t SimpleHashing::max_bin_size() const noexcept
+{
+    uint64_t max_size = 0;
+    for (size_t b = 0; (b + 1) < offsets_.size(); b++) {
+        max_size = std::max(max_size, offsets_[b + 1] - offsets_[b]);
+    }
+    return max_size;
+}
+
+void SimpleHashing::build(const void *items, const size_t num_items,
+                          const bool parallel)
+{
+    const size_t k = hash_.num_hashes();
+    std::vector<uint32_t> hashes(k * num_items);
+    hash_(hashes.data(), items, num_items, parallel);
+    // NOTE: Counting sort of (item, function) by bin.
+    offsets_.assign(hash_.num_bins() + 1, 0);
+    for (const auto b : hashes) {
+        offsets_[b + 1]++;
+    }
+    for (size_t b = 1; b < offsets_.size(); b++) {
+        offsets_[b] += offsets_[b - 1];
+    }
+    entries_.resize(k * num_items);
+    std::vector<uint64_t> next(offsets_.begin(), offsets_.end() - 1);
+    for (size_t i = 0; i < num_items; i++) {
+        for (size_t j = 0; j < k; j++) {
+            entries_[next[hashes[k * i + j]]++] = cuckoo::pack(i, j);
+        }
+    }
+}
+} // namespace clt
@@ -0,0 +1,294 @@
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#include <x86intrin.h>
+
+#include <clt/distribution.hpp>
+
+/**
+ * NOTE: log, sin and cos of the vectorized paths are the polynomial and
+ * rational approximations of the Cephes Math Library (log.c, sin.c), which
+ * are accurate to a few ulps on the reduced ranges used here.
+ */
+
+namespace clt {
+namespace distribution {
+namespace internal {
+constexpr uint64_t double_one_bits = 0x3ff0000000000000;
+constexpr uint32_t float_one_bits = 0x3f800000;
+constexpr double two_pi = 6.283185307179586476925286766559;
+
+inline uint64_t load_bits(const uint64_t *in) noexcept
+{
+    uint64_t x;
+    std::memcpy(&x, in, sizeof(x));
+    return x;
+}
+
+// NOTE: [0, 1)
+inline double uniform(const uint64_t x) noexcept
+{
+    return std::bit_cast<double>((x >> 12) | double_one_bits) - 1.0;
+}
+
+// NOTE: (0, 1], for the argument of log.
+inline double uniform_open(const uint64_t x) noexcept
+{
+    return 2.0 - std::bit_cast<double>((x >> 12) | double_one_bits);
+}
+
+inline void box_muller(double &z0, double &z1, const uint64_t x0,
+                       const uint64_t x1) noexcept
+{
+    const double r = std::sqrt(-2.0 * std::log(uniform_open(x0)));
+    const double theta = two_pi * uniform(x1);
+    z0 = r * std::cos(theta);
+    z1 = r * std::sin(theta);
+}
+
+#if defined(__AVX2__)
+inline __m256d uniform_pd(const __m256i x) noexcept
+{
+    const auto one_bits = _mm256_set1_epi64x(double_one_bits);
+    const auto m = _mm256_or_si256(_mm256_srli_epi64(x, 12), one_bits);
+    return _mm256_sub_pd(_mm256_castsi256_pd(m), _mm256_set1_pd(1.0));
+}
+
+inline __m256d uniform_open_pd(const __m256i x) noexcept
+{
+    const auto one_bits = _mm256_set1_epi64x(double_one_bits);
+    const auto m = _mm256_or_si256(_mm256_srli_epi64(x, 12), one_bits);
+    return _mm256_sub_pd(_mm256_set1_pd(2.0), _mm256_castsi256_pd(m));
+}
+
+inline __m256d fmadd_pd(const __m256d a, const __m256d b,
+                        const __m256d c) noexcept
+{
+#if defined(__FMA__)
+    return _mm256_fmadd_pd(a, b, c);
+#else
+    return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+}
+
+template <size_t N>
+inline __m256d polevl_pd(const __m256d x, const double (&coefs)[N]) noexcept
+{
+    auto y = _mm256_set1_pd(coefs[0]);
+    for (size_t i = 1; i < N; i++) {
+        y = fmadd_pd(y, x, _mm256_set1_pd(coefs[i]));
+    }
+    return y;
+}
+
+// NOTE: polevl with the leading coefficient 1 omitted.
+template <size_t N>
+inline __m256d p1evl_pd(const __m256d x, const double (&coefs)[N]) noexcept
+{
+    auto y = _mm256_add_pd(x, _mm256_set1_pd(coefs[0]));
+    for (size_t i = 1; i < N; i++) {
+        y = fmadd_pd(y, x, _mm256_set1_pd(coefs[i]));
+    }
+    return y;
+}
+
+// NOTE: Natural logarithm of positive normal numbers.
+inline __m256d log_pd(const __m256d x) noexcept
+{
+    constexpr double log_p[] = {
+        1.01875663804580931796E-4, 4.97494994976747001425E-1,
+        4.70579119878881725854E0,  1.44989225341610930846E1,
+        1.79368678507819816313E1,  7.70838733755885391666E0,
+    };
+    constexpr double log_q[] = {
+        1.12873587189167450590E1, 4.52279145837532221105E1,
+        8.29875266912776603211E1, 7.11544750618563894466E1,
+        2.31251620126765340583E1,
+    };
+    constexpr double sqrt_half = 0.70710678118654752440;
+    constexpr double exp2_52 = 4503599627370496.0;
+    // NOTE: x = m * 2^e with m in [0.5, 1).
+    const auto bits = _mm256_castpd_si256(x);
+    const auto e_bits = _mm256_or_si256(
+        _mm256_srli_epi64(bits, 52), _mm256_set1_epi64x(0x4330000000000000));
+    auto e = _mm256_sub_pd(_mm256_castsi256_pd(e_bits),
+                           _mm256_set1_pd(exp2_52 + 1022.0));
+    const auto m_bits = _mm256_or_si256(
+        _mm256_and_si256(bits, _mm256_set1_epi64x(0x000fffffffffffff)),
+        _mm256_set1_epi64x(0x3fe0000000000000));
+    auto m = _mm256_castsi256_pd(m_bits);
+    // NOTE: m in [sqrt(1/2), sqrt(2)) and then m - 1.
+    const auto is_small =
+        _mm256_cmp_pd(m, _mm256_set1_pd(sqrt_half), _CMP_LT_OQ);
+    e = _mm256_sub_pd(e, _mm256_and_pd(is_small, _mm256_set1_pd(1.0)));
+    m = _mm256_add_pd(_mm256_sub_pd(m, _mm256_set1_pd(1.0)),
+                      _mm256_and_pd(is_small, m));
+    const auto z = _mm256_mul_pd(m, m);
+    auto y = _mm256_div_pd(polevl_pd(m, log_p), p1evl_pd(m, log_q));
+    y = _mm256_mul_pd(m, _mm256_mul_pd(z, y));
+    y = fmadd_pd(e, _mm256_set1_pd(-2.121944400546905827679E-4), y);
+    y = fmadd_pd(z, _mm256_set1_pd(-0.5), y);
+    const auto r = _mm256_add_pd(m, y);
+    return fmadd_pd(e, _mm256_set1_pd(0.693359375), r);
+}
+
+// NOTE: sin(2 pi v) and cos(2 pi v) for v in [0, 1).
+inline void sincos_2pi_pd(const __m256d v, __m256d &s, __m256d &c) noexcept
+{
+    constexpr double sin_coefs[] = {
+        1.58962301576546568060E-10, -2.50507477628578072866E-8,
+        2.75573136213857245213E-6,  -1.98412698295895385996E-4,
+        8.33333333332211858878E-3,  -1.66666666666666307295E-1,
+    };
+    constexpr double cos_coefs[] = {
+        -1.13585365213876817300E-11, 2.08757008419747316778E-9,
+        -2.75573141792967388112E-7,  2.48015872888517045348E-5,
+        -1.38888888888730564116E-3,  4.16666666666665929218E-2,
+    };
+    constexpr double half_pi = 1.57079632679489661923;
+    constexpr double exp2_52 = 4503599627370496.0;
+    // NOTE: 2 pi v = (q + r) pi / 2 with integer q in [0, 4] and
+    // r in [-1/2, 1/2], where 4 v - q is exact.
+    const auto t = _mm256_mul_pd(v, _mm256_set1_pd(4.0));
+    const auto q = _mm256_round_pd(t, _MM_FROUND_TO_NEAREST_INT |
+                                          _MM_FROUND_NO_EXC);
+    const auto x = _mm256_mul_pd(_mm256_sub_pd(t, q), _mm256_set1_pd(half_pi));
+    const auto qi = _mm256_castpd_si256(
+        _mm256_add_pd(q, _mm256_set1_pd(exp2_52)));
+    const auto x2 = _mm256_mul_pd(x, x);
+    const auto sin_x = fmadd_pd(_mm256_mul_pd(x, x2),
+                                polevl_pd(x2, sin_coefs), x);
+    const auto cos_x = _mm256_add_pd(
+        fmadd_pd(x2, _mm256_set1_pd(-0.5), _mm256_set1_pd(1.0)),
+        _mm256_mul_pd(_mm256_mul_pd(x2, x2), polevl_pd(x2, cos_coefs)));
+    // NOTE: Quadrants 1 and 3 swap sin and cos; the signs follow
+    // sin: +, +, -, - and cos: +, -, -, + for q = 0, 1, 2, 3.
+    const auto one = _mm256_set1_epi64x(1);
+    const auto swap = _mm256_castsi256_pd(
+        _mm256_cmpeq_epi64(_mm256_and_si256(qi, one), one));
+    const auto sin_sign = _mm256_slli_epi64(
+        _mm256_and_si256(qi, _mm256_set1_epi64x(2)), 62);
+    const auto cos_sign = _mm256_slli_epi64(
+        _mm256_and_si256(_mm256_add_epi64(qi, one), _mm256_set1_epi64x(2)),
+        62);
+    s = _mm256_xor_pd(_mm256_blendv_pd(sin_x, cos_x, swap),
+                      _mm256_castsi256_pd(sin_sign));
+    c = _mm256_xor_pd(_mm256_blendv_pd(cos_x, sin_x, swap),
+                      _mm256_castsi256_pd(cos_sign));
+}
+#endif
+} // namespace internal
+
+void bits_to_uniform(double *out, const uint64_t *in,
+                     const size_t num_elems) noexcept
+{
+    size_t i = 0;
+#if defined(__AVX512F__)
+    // NOTE: The zero-masking shifts avoid a false -Wmaybe-uninitialized of
+    // GCC 12 on _mm512_undefined_epi32 in the unmasked ones.
+    const auto one_bits = _mm512_set1_epi64(internal::double_one_bits);
+    for (; (i + 8) <= num_elems; i += 8) {
+        const auto x = _mm512_loadu_si512(in + i);
+        const auto m =
+            _mm512_or_si512(_mm512_maskz_srli_epi64(0xff, x, 12), one_bits);
+        _mm512_storeu_pd(out + i, _mm512_sub_pd(_mm512_castsi512_pd(m),
+                                                _mm512_set1_pd(1.0)));
+    }
+#elif defined(__AVX2__)
+    for (; (i + 4) <= num_elems; i += 4) {
+        const auto x =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        _mm256_storeu_pd(out + i, internal::uniform_pd(x));
+    }
+#endif
+    for (; i < num_elems; i++) {
+        out[i] = internal::uniform(internal::load_bits(in + i));
+    }
+}
+
+void bits_to_uniform(float *out, const uint32_t *in,
+                     const size_t num_elems) noexcept
+{
+    size_t i = 0;
+#if defined(__AVX512F__)
+    const auto one_bits = _mm512_set1_epi32(internal::float_one_bits);
+    for (; (i + 16) <= num_elems; i += 16) {
+        const auto x = _mm512_loadu_si512(in + i);
+        const auto m =
+            _mm512_or_si512(_mm512_maskz_srli_epi32(0xffff, x, 9), one_bits);
+        _mm512_storeu_ps(out + i, _mm512_sub_ps(_mm512_castsi512_ps(m),
+                                                _mm512_set1_ps(1.0f)));
+    }
+#elif defined(__AVX2__)
+    const auto one_bits = _mm256_set1_epi32(internal::float_one_bits);
+    for (; (i + 8) <= num_elems; i += 8) {
+        const auto x =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        const auto m = _mm256_or_si256(_mm256_srli_epi32(x, 9), one_bits);
+        _mm256_storeu_ps(out + i, _mm256_sub_ps(_mm256_castsi256_ps(m),
+                                                _mm256_set1_ps(1.0f)));
+    }
+#endif
+    for (; i < num_elems; i++) {
+        uint32_t x;
+        std::memcpy(&x, in + i, sizeof(x));
+        out[i] = std::bit_cast<float>((x >> 9) | internal::float_one_bits) -
+                 1.0f;
+    }
+}
+
+void bits_to_normal(double *out, const uint64_t *in,
+                    const size_t num_elems) noexcept
+{
+    assert((num_elems % 2) == 0);
+    // NOTE: Each group of 8 elements pairs lane j of the first half (radius)
+    // with lane j of the second half (angle), and writes r cos to the first
+    // half and r sin to the second half. The rest pairs adjacent elements.
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; (i + 8) <= num_elems; i += 8) {
+        const auto *p_in = reinterpret_cast<const __m256i *>(in + i);
+        const auto u0 = internal::uniform_open_pd(_mm256_loadu_si256(p_in));
+        const auto u1 = internal::uniform_pd(_mm256_loadu_si256(p_in + 1));
+        const auto r = _mm256_sqrt_pd(
+            _mm256_mul_pd(_mm256_set1_pd(-2.0), internal::log_pd(u0)));
+        __m256d s, c;
+        internal::sincos_2pi_pd(u1, s, c);
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(r, c));
+        _mm256_storeu_pd(out + i + 4, _mm256_mul_pd(r, s));
+    }
+#else
+    for (; (i + 8) <= num_elems; i += 8) {
+        for (size_t j = 0; j < 4; j++) {
+            internal::box_muller(out[i + j], out[i + j + 4],
+                                 internal::load_bits(in + i + j),
+                                 internal::load_bits(in + i + j + 4));
+        }
+    }
+#endif
+    for (; i < num_elems; i += 2) {
+        internal::box_muller(out[i], out[i + 1], internal::load_bits(in + i),
+                             internal::load_bits(in + i + 1));
+    }
+}
+
+void bits_to_exponential(double *out, const uint64_t *in,
+                         const size_t num_elems) noexcept
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; (i + 4) <= num_elems; i += 4) {
+        const auto x =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        const auto y = internal::log_pd(internal::uniform_open_pd(x));
+        _mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_setzero_pd(), y));
+    }
+#endif
+    for (; i < num_elems; i++) {
+        out[i] = -std::log(internal::uniform_open(internal::load_bits(in + i)));
+    }
+}
+} // namespace distribution
+} // namespace clt
@@ -0,0 +1,423 @@
+#include <cassert>
+#include <stdexcept>
+
+#include <x86intrin.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/dpf.hpp>
+
+namespace clt {
+namespace internal {
+inline __m128i dpf_lsb() noexcept { return _mm_set_epi64x(0, 1); }
+
+inline __m128i dpf_clear_lsb(const __m128i b) noexcept
+{
+    return _mm_andnot_si128(dpf_lsb(), b);
+}
+
+inline bool dpf_get_lsb(const __m128i b) noexcept
+{
+    return _mm_cvtsi128_si64(b) & 1;
+}
+
+inline __m128i dpf_lsb_mask(const __m128i b) noexcept
+{
+    // NOTE: All ones if the control bit in the lowest bit is set.
+    const auto t = _mm_and_si128(b, dpf_lsb());
+    return _mm_shuffle_epi32(_mm_sub_epi64(_mm_setzero_si128(), t), 0x44);
+}
+
+template <size_t ElemBits>
+inline __m128i dpf_add(const __m128i a, const __m128i b) noexcept
+{
+    if constexpr (ElemBits == 1) {
+        return _mm_xor_si128(a, b);
+    } else if constexpr (ElemBits == 8) {
+        return _mm_add_epi8(a, b);
+    } else if constexpr (ElemBits == 16) {
+        return _mm_add_epi16(a, b);
+    } else if constexpr (ElemBits == 32) {
+        return _mm_add_epi32(a, b);
+    } else {
+        static_assert(ElemBits == 64);
+        return _mm_add_epi64(a, b);
+    }
+}
+
+template <size_t ElemBits>
+inline __m128i dpf_sub(const __m128i a, const __m128i b) noexcept
+{
+    if constexpr (ElemBits == 1) {
+        return _mm_xor_si128(a, b);
+    } else if constexpr (ElemBits == 8) {
+        return _mm_sub_epi8(a, b);
+    } else if constexpr (ElemBits == 16) {
+        return _mm_sub_epi16(a, b);
+    } else if constexpr (ElemBits == 32) {
+        return _mm_sub_epi32(a, b);
+    } else {
+        static_assert(ElemBits == 64);
+        return _mm_sub_epi64(a, b);
+    }
+}
+
+inline __m128i dpf_load(const AES128::block_t &b) noexcept
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(b.data()));
+}
+
+inline AES128::block_t dpf_store(const __m128i b) noexcept
+{
+    AES128::block_t out;
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out.data()), b);
+    return out;
+}
+
+struct DPFContext {
+    __m128i keys_l[aes128::num_rounds + 1];
+    __m128i keys_r[aes128::num_rounds + 1];
+    __m128i keys_v[aes128::num_rounds + 1];
+    const dpf::Key *key;
+    __m128i cw_out;
+    bool negate;
+    /**
+     * Correction word of level l + 1 with the control bit of the left (side
+     * = 0) or right (side = 1) child in the lowest bit.
+     */
+    __m128i cw(const size_t l, const size_t side) const noexcept
+    {
+        return _mm_or_si128(
+            dpf_load(key->cw_seeds[l]),
+            _mm_cvtsi32_si128((key->cw_bits[l] >> side) & 1));
+    }
+};
+
+template <size_t W>
+inline void dpf_expand_nodes(__m128i *p_out, const __m128i *p_in,
+                             const __m128i cw_l, const __m128i cw_r,
+                             const DPFContext &ctx) noexcept
+{
+    __m128i ss[W], ms[W], ls[W], rs[W];
+    for (size_t k = 0; k < W; k++) {
+        const auto b = _mm_loadu_si128(p_in + k);
+        ss[k] = dpf_clear_lsb(b);
+        ms[k] = dpf_lsb_mask(b);
+    }
+    ggm_children<W>(ls, rs, ss, ctx.keys_l, ctx.keys_r);
+    for (size_t k = 0; k < W; k++) {
+        _mm_storeu_si128(p_out + 2 * k,
+                         _mm_xor_si128(ls[k], _mm_and_si128(cw_l, ms[k])));
+        _mm_storeu_si128(p_out + 2 * k + 1,
+                         _mm_xor_si128(rs[k], _mm_and_si128(cw_r, ms[k])));
+    }
+}
+
+inline void dpf_expand_in_place(__m128i *p, const size_t first_level,
+                                const size_t last_level,
+                                const DPFContext &ctx) noexcept
+{
+    constexpr size_t W = ggm::batch_width;
+    for (size_t l = first_level; l < last_level; l++) {
+        // NOTE: Backward as GGMTree::expand.
+        const auto cw_l = ctx.cw(l, 0), cw_r = ctx.cw(l, 1);
+        size_t i = size_t(1) << (l - first_level);
+        for (; i >= W; i -= W) {
+            dpf_expand_nodes<W>(p + 2 * (i - W), p + (i - W), cw_l, cw_r, ctx);
+        }
+        for (; i > 0; i--) {
+            dpf_expand_nodes<1>(p + 2 * (i - 1), p + (i - 1), cw_l, cw_r, ctx);
+        }
+    }
+}
+
+template <size_t ElemBits, size_t W>
+inline void dpf_convert_leaves(__m128i *p, const DPFContext &ctx) noexcept
+{
+    __m128i ss[W], ms[W], vs[W];
+    for (size_t k = 0; k < W; k++) {
+        const auto b = _mm_loadu_si128(p + k);
+        vs[k] = ss[k] = dpf_clear_lsb(b);
+        ms[k] = dpf_lsb_mask(b);
+    }
+    using sfinae::aes128_enc_impl;
+    using sfinae::width_round_t;
+    aes128_enc_impl(vs, width_round_t<W, 0>{}, ctx.keys_v);
+    for (size_t k = 0; k < W; k++) {
+        auto y = dpf_add<ElemBits>(_mm_xor_si128(vs[k], ss[k]),
+                                   _mm_and_si128(ctx.cw_out, ms[k]));
+        // NOTE: No-op for XOR shares.
+        if (ctx.negate) {
+            y = dpf_sub<ElemBits>(_mm_setzero_si128(), y);
+        }
+        _mm_storeu_si128(p + k, y);
+    }
+}
+
+template <size_t ElemBits>
+inline void dpf_convert_range(__m128i *p, const size_t num_leaves,
+                              const DPFContext &ctx) noexcept
+{
+    constexpr size_t W = ggm::batch_width;
+    size_t i = 0;
+    for (; (i + W) <= num_leaves; i += W) {
+        dpf_convert_leaves<ElemBits, W>(p + i, ctx);
+    }
+    for (; i < num_leaves; i++) {
+        dpf_convert_leaves<ElemBits, 1>(p + i, ctx);
+    }
+}
+
+inline void dpf_convert(__m128i *p, const size_t num_leaves,
+                        const size_t elem_bits, const DPFContext &ctx) noexcept
+{
+    switch (elem_bits) {
+    case 1:
+        dpf_convert_range<1>(p, num_leaves, ctx);
+        break;
+    case 8:
+        dpf_convert_range<8>(p, num_leaves, ctx);
+        break;
+    case 16:
+        dpf_convert_range<16>(p, num_leaves, ctx);
+        break;
+    case 32:
+        dpf_convert_range<32>(p, num_leaves, ctx);
+        break;
+    default:
+        assert(elem_bits == 64);
+        dpf_convert_range<64>(p, num_leaves, ctx);
+    }
+}
+
+template <size_t ElemBits>
+inline __m128i dpf_final_cw_impl(const __m128i e, const __m128i c0,
+                                 const __m128i c1, const bool t1) noexcept
+{
+    // NOTE: (-1)^t1 (e - c0 + c1), i.e., e xor c0 xor c1 for XOR shares.
+    const auto cw = dpf_add<ElemBits>(dpf_sub<ElemBits>(e, c0), c1);
+    return t1 ? dpf_sub<ElemBits>(_mm_setzero_si128(), cw) : cw;
+}
+
+inline __m128i dpf_final_cw(const size_t elem_bits, const __m128i e,
+                            const __m128i c0, const __m128i c1,
+                            const bool t1) noexcept
+{
+    switch (elem_bits) {
+    case 1:
+        return dpf_final_cw_impl<1>(e, c0, c1, t1);
+    case 8:
+        return dpf_final_cw_impl<8>(e, c0, c1, t1);
+    case 16:
+        return dpf_final_cw_impl<16>(e, c0, c1, t1);
+    case 32:
+        return dpf_final_cw_impl<32>(e, c0, c1, t1);
+    default:
+        assert(elem_bits == 64);
+        return dpf_final_cw_impl<64>(e, c0, c1, t1);
+    }
+}
+
+inline uint64_t dpf_elem_mask(const size_t elem_bits) noexcept
+{
+    return (elem_bits == 64) ? ~uint64_t(0) : ((uint64_t(1) << elem_bits) - 1);
+}
+
+inline void dpf_expand_key(uint8_t *expanded_keys, const void *key) noexcept
+{
+    __m128i keys[aes128::num_rounds + 1];
+    keys[0] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(key));
+    aes128_key_expansion_impl<0>(keys);
+    auto *p_out = reinterpret_cast<__m128i *>(expanded_keys);
+    for (size_t i = 0; i < std::size(keys); i++) {
+        _mm_storeu_si128(p_out + i, keys[i]);
+    }
+}
+} // namespace internal
+
+DPF::DPF(const size_t log_domain, const size_t elem_bits)
+    : log_domain_(log_domain), elem_bits_(elem_bits)
+{
+    size_t nu = 0;
+    switch (elem_bits) {
+    case 1:
+        nu = 7;
+        break;
+    case 8:
+        nu = 4;
+        break;
+    case 16:
+        nu = 3;
+        break;
+    case 32:
+        nu = 2;
+        break;
+    case 64:
+        nu = 1;
+        break;
+    default:
+        throw std::invalid_argument("elem_bits must be 1, 8, 16, 32 or 64.");
+    }
+    if ((log_domain < nu) || (log_domain >= 64)) {
+        throw std::invalid_argument(
+            "log_domain must cover a block and be less than 64.");
+    }
+    depth_ = log_domain - nu;
+    static_assert(sizeof(expanded_keys_left_) ==
+                  sizeof(__m128i) * (aes128::num_rounds + 1));
+    internal::dpf_expand_key(expanded_keys_left_, ggm::default_key_left);
+    internal::dpf_expand_key(expanded_keys_right_, ggm::default_key_right);
+    internal::dpf_expand_key(expanded_keys_value_, dpf::default_key_value);
+}
+
+std::pair<dpf::Key, dpf::Key> DPF::gen(const uint64_t alpha,
+                                       const uint64_t beta, const void *seed0,
+                                       const void *seed1) const
+{
+    using namespace internal;
+    assert((log_domain_ == 63) || (alpha < (uint64_t(1) << log_domain_)));
+    __m128i keys_l[aes128::num_rounds + 1], keys_r[aes128::num_rounds + 1];
+    aes128_load_expkey_for_enc(keys_l, expanded_keys_left_);
+    aes128_load_expkey_for_enc(keys_r, expanded_keys_right_);
+    std::pair<dpf::Key, dpf::Key> keys;
+    auto &[key0, key1] = keys;
+    __m128i s0 = dpf_clear_lsb(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(seed0)));
+    __m128i s1 = dpf_clear_lsb(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(seed1)));
+    bool t0 = false, t1 = true;
+    key0.party = 0;
+    key1.party = 1;
+    key0.seed = dpf_store(s0);
+    key1.seed = dpf_store(s1);
+    const uint64_t index = alpha >> (log_domain_ - depth_);
+    for (size_t l = 0; l < depth_; l++) {
+        const bool a = (index >> (depth_ - 1 - l)) & 1;
+        __m128i l0, r0, l1, r1;
+        ggm_children<1>(&l0, &r0, &s0, keys_l, keys_r);
+        ggm_children<1>(&l1, &r1, &s1, keys_l, keys_r);
+        // NOTE: The lost children of both parties agree after correction.
+        const auto cw_seed = a ? dpf_clear_lsb(_mm_xor_si128(l0, l1))
+                               : dpf_clear_lsb(_mm_xor_si128(r0, r1));
+        const bool cw_t_l = dpf_get_lsb(l0) ^ dpf_get_lsb(l1) ^ a ^ 1;
+        const bool cw_t_r = dpf_get_lsb(r0) ^ dpf_get_lsb(r1) ^ a;
+        for (auto *key : {&key0, &key1}) {
+            key->cw_seeds.push_back(dpf_store(cw_seed));
+            key->cw_bits.push_back(cw_t_l | (cw_t_r << 1));
+        }
+        const auto cw_keep =
+            _mm_or_si128(cw_seed, _mm_cvtsi32_si128(a ? cw_t_r : cw_t_l));
+        const auto keep0 = _mm_xor_si128(a ? r0 : l0,
+                                         t0 ? cw_keep : _mm_setzero_si128());
+        const auto keep1 = _mm_xor_si128(a ? r1 : l1,
+                                         t1 ? cw_keep : _mm_setzero_si128());
+        t0 = dpf_get_lsb(keep0);
+        t1 = dpf_get_lsb(keep1);
+        s0 = dpf_clear_lsb(keep0);
+        s1 = dpf_clear_lsb(keep1);
+    }
+    __m128i keys_v[aes128::num_rounds + 1];
+    aes128_load_expkey_for_enc(keys_v, expanded_keys_value_);
+    __m128i cs[2] = {s0, s1};
+    using sfinae::aes128_enc_impl;
+    using sfinae::width_round_t;
+    aes128_enc_impl(cs, width_round_t<2, 0>{}, keys_v);
+    const auto c0 = _mm_xor_si128(cs[0], s0);
+    const auto c1 = _mm_xor_si128(cs[1], s1);
+    const size_t offset =
+        (alpha & ((uint64_t(1) << (log_domain_ - depth_)) - 1)) * elem_bits_;
+    uint64_t e[2] = {0, 0};
+    e[offset / 64] = (beta & dpf_elem_mask(elem_bits_)) << (offset % 64);
+    const auto cw_out =
+        dpf_final_cw(elem_bits_, _mm_set_epi64x(e[1], e[0]), c0, c1, t1);
+    key0.cw_out = key1.cw_out = dpf_store(cw_out);
+    return keys;
+}
+
+std::pair<dpf::Key, dpf::Key> DPF::gen(const uint64_t alpha,
+                                       const uint64_t beta) const
+{
+    const auto seed0 = gen_key(), seed1 = gen_key();
+    return gen(alpha, beta, seed0.data(), seed1.data());
+}
+
+namespace internal {
+inline void dpf_load_context(DPFContext &ctx, const dpf::Key &key,
+                             const uint8_t *expanded_keys_left,
+                             const uint8_t *expanded_keys_right,
+                             const uint8_t *expanded_keys_value) noexcept
+{
+    aes128_load_expkey_for_enc(ctx.keys_l, expanded_keys_left);
+    aes128_load_expkey_for_enc(ctx.keys_r, expanded_keys_right);
+    aes128_load_expkey_for_enc(ctx.keys_v, expanded_keys_value);
+    ctx.key = &key;
+    ctx.cw_out = dpf_load(key.cw_out);
+    ctx.negate = key.party;
+}
+
+inline __m128i dpf_root(const dpf::Key &key) noexcept
+{
+    return _mm_or_si128(dpf_clear_lsb(dpf_load(key.seed)),
+                        _mm_cvtsi32_si128(key.party & 1));
+}
+} // namespace internal
+
+uint64_t DPF::eval(const dpf::Key &key, const uint64_t x) const noexcept
+{
+    using namespace internal;
+    assert(key.cw_seeds.size() == depth_);
+    DPFContext ctx;
+    dpf_load_context(ctx, key, expanded_keys_left_, expanded_keys_right_,
+                     expanded_keys_value_);
+    __m128i b = dpf_root(key);
+    const size_t nu = log_domain_ - depth_;
+    const uint64_t index = x >> nu;
+    using single::aes128_enc_impl;
+    for (size_t l = 0; l < depth_; l++) {
+        // NOTE: Only the child on the path is computed.
+        const size_t bit = (index >> (depth_ - 1 - l)) & 1;
+        const auto s = dpf_clear_lsb(b);
+        const auto m = dpf_lsb_mask(b);
+        b = s;
+        aes128_enc_impl<0>(b, bit ? ctx.keys_r : ctx.keys_l);
+        b = _mm_xor_si128(_mm_xor_si128(b, s),
+                          _mm_and_si128(ctx.cw(l, bit), m));
+    }
+    dpf_convert(&b, 1, elem_bits_, ctx);
+    uint64_t ys[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(ys), b);
+    const size_t offset = (x & ((uint64_t(1) << nu) - 1)) * elem_bits_;
+    return (ys[offset / 64] >> (offset % 64)) & dpf_elem_mask(elem_bits_);
+}
+
+void DPF::eval_full(const dpf::Key &key, void *out,
+                    [[maybe_unused]] const bool parallel) const noexcept
+{
+    using namespace internal;
+    assert(key.cw_seeds.size() == depth_);
+    DPFContext ctx;
+    dpf_load_context(ctx, key, expanded_keys_left_, expanded_keys_right_,
+                     expanded_keys_value_);
+    auto *p = reinterpret_cast<__m128i *>(out);
+    _mm_storeu_si128(p, dpf_root(key));
+    if (depth_ <= ggm::subtree_depth) {
+        dpf_expand_in_place(p, 0, depth_, ctx);
+        dpf_convert(p, size_t(1) << depth_, elem_bits_, ctx);
+        return;
+    }
+    // NOTE: Subtrees are expanded and converted while they stay in L1.
+    const size_t top_depth = depth_ - ggm::subtree_depth;
+    const size_t num_subtrees = size_t(1) << top_depth;
+    constexpr size_t subtree_leaves = size_t(1) << ggm::subtree_depth;
+    dpf_expand_in_place(p, 0, top_depth, ctx);
+    for (size_t i = num_subtrees - 1; i > 0; i--) {
+        _mm_storeu_si128(p + (i << ggm::subtree_depth),
+                         _mm_loadu_si128(p + i));
+    }
+#pragma omp parallel for schedule(static) if (parallel)
+    for (size_t i = 0; i < num_subtrees; i++) {
+        auto *p_sub = p + (i << ggm::subtree_depth);
+        dpf_expand_in_place(p_sub, top_depth, depth_, ctx);
+        dpf_convert(p_sub, subtree_leaves, elem_bits_, ctx);
+    }
+}
+} // namespace clt
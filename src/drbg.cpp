@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+#include <x86intrin.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/drbg.hpp>
+#include <clt/rng.hpp>
+#include <clt/util.hpp>
+
+namespace clt {
+namespace internal {
+inline __m128i drbg_counter_block(const uint64_t v_hi,
+                                  const uint64_t v_lo) noexcept
+{
+    // NOTE: V is a 128-bit big-endian counter.
+    return _mm_set_epi64x(__builtin_bswap64(v_lo), __builtin_bswap64(v_hi));
+}
+
+inline void drbg_increment(uint64_t &v_hi, uint64_t &v_lo) noexcept
+{
+    v_lo++;
+    v_hi += (v_lo == 0);
+}
+
+inline uint64_t load_be64(const uint8_t *in) noexcept
+{
+    uint64_t x;
+    std::copy(in, in + sizeof(x), reinterpret_cast<uint8_t *>(&x));
+    return __builtin_bswap64(x);
+}
+
+inline void drbg_pad_input(uint8_t *out, const void *in,
+                           const size_t num_bytes) noexcept
+{
+    assert(num_bytes <= drbg::seed_bytes);
+    std::fill(out, out + drbg::seed_bytes, 0);
+    if (in != nullptr) {
+        const auto *p_in = reinterpret_cast<const uint8_t *>(in);
+        std::copy(p_in, p_in + num_bytes, out);
+    }
+}
+} // namespace internal
+
+void AES128_CTR_DRBG::set_key(const uint8_t *key) noexcept
+{
+    __m128i keys[aes128::num_rounds + 1];
+    static_assert(sizeof(keys) == sizeof(expanded_keys_));
+    keys[0] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(key));
+    internal::aes128_key_expansion_impl<0>(keys);
+    auto *p_out = reinterpret_cast<__m128i *>(expanded_keys_);
+    for (size_t i = 0; i < std::size(keys); i++) {
+        _mm_storeu_si128(p_out + i, keys[i]);
+    }
+}
+
+void AES128_CTR_DRBG::update(const uint8_t *provided_data) noexcept
+{
+    static_assert(drbg::seed_bytes == 2 * aes128::block_bytes);
+    __m128i keys[aes128::num_rounds + 1];
+    internal::aes128_load_expkey_for_enc(keys, expanded_keys_);
+    internal::drbg_increment(v_hi_, v_lo_);
+    __m128i m0 = internal::drbg_counter_block(v_hi_, v_lo_);
+    internal::drbg_increment(v_hi_, v_lo_);
+    __m128i m1 = internal::drbg_counter_block(v_hi_, v_lo_);
+    using internal::variadic::aes128_enc_impl;
+    using internal::variadic::round_t;
+    aes128_enc_impl(round_t<0>{}, keys, m0, m1);
+    const auto *p_in = reinterpret_cast<const __m128i *>(provided_data);
+    m0 = _mm_xor_si128(m0, _mm_loadu_si128(p_in));
+    m1 = _mm_xor_si128(m1, _mm_loadu_si128(p_in + 1));
+    uint8_t temp[drbg::seed_bytes];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(temp), m0);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(temp) + 1, m1);
+    set_key(temp);
+    v_hi_ = internal::load_be64(temp + aes128::key_bytes);
+    v_lo_ = internal::load_be64(temp + aes128::key_bytes + sizeof(uint64_t));
+    secure_wipe(temp, sizeof(temp));
+}
+
+AES128_CTR_DRBG::AES128_CTR_DRBG(const void *entropy_input,
+                                 const void *personalization,
+                                 const size_t personalization_bytes,
+                                 const uint64_t reseed_interval) noexcept
+    : v_hi_(0), v_lo_(0), reseed_counter_(1),
+      reseed_interval_(std::min(reseed_interval, drbg::max_reseed_interval))
+{
+    uint8_t seed_material[drbg::seed_bytes];
+    internal::drbg_pad_input(seed_material, personalization,
+                             personalization_bytes);
+    const auto *p_entropy = reinterpret_cast<const uint8_t *>(entropy_input);
+    for (size_t i = 0; i < drbg::seed_bytes; i++) {
+        seed_material[i] ^= p_entropy[i];
+    }
+    set_key(aes128::zero_key);
+    update(seed_material);
+    secure_wipe(seed_material, sizeof(seed_material));
+}
+
+AES128_CTR_DRBG::~AES128_CTR_DRBG()
+{
+    // NOTE: Uninstantiate of SP 800-90A, the internal state is zeroized.
+    secure_wipe(expanded_keys_, sizeof(expanded_keys_));
+    secure_wipe(&v_hi_, sizeof(v_hi_));
+    secure_wipe(&v_lo_, sizeof(v_lo_));
+}
+
+namespace {
+/**
+ * Entropy input from rng::rng_global, zeroized when the temporary holding
+ * it is destroyed.
+ */
+class EntropyInput {
+    std::array<uint8_t, drbg::seed_bytes> bytes_;
+
+public:
+    EntropyInput()
+    {
+        if (!rng::rng_global(bytes_.data(), bytes_.size())) {
+            throw std::runtime_error("Random bytes generation is failed.");
+        }
+    }
+    EntropyInput(const EntropyInput &) = delete;
+    EntropyInput &operator=(const EntropyInput &) = delete;
+    ~EntropyInput() { secure_wipe(bytes_.data(), bytes_.size()); }
+    const uint8_t *data() const noexcept { return bytes_.data(); }
+};
+} // namespace
+
+AES128_CTR_DRBG::AES128_CTR_DRBG()
+    : AES128_CTR_DRBG(EntropyInput().data(), nullptr, 0)
+{
+}
+
+void AES128_CTR_DRBG::reseed(const void *entropy_input,
+                             const void *additional_input,
+                             const size_t additional_bytes) noexcept
+{
+    uint8_t seed_material[drbg::seed_bytes];
+    internal::drbg_pad_input(seed_material, additional_input,
+                             additional_bytes);
+    const auto *p_entropy = reinterpret_cast<const uint8_t *>(entropy_input);
+    for (size_t i = 0; i < drbg::seed_bytes; i++) {
+        seed_material[i] ^= p_entropy[i];
+    }
+    update(seed_material);
+    secure_wipe(seed_material, sizeof(seed_material));
+    reseed_counter_ = 1;
+}
+
+void AES128_CTR_DRBG::reseed(const void *additional_input,
+                             const size_t additional_bytes)
+{
+    reseed(EntropyInput().data(), additional_input, additional_bytes);
+}
+
+void AES128_CTR_DRBG::generate(void *out, const size_t num_bytes,
+                               const void *additional_input,
+                               const size_t additional_bytes,
+                               const bool prediction_resistance)
+{
+    assert(num_bytes <= drbg::max_request_bytes);
+    uint8_t additional[drbg::seed_bytes];
+    if (prediction_resistance || (reseed_counter_ > reseed_interval_)) {
+        reseed(additional_input, additional_bytes);
+        internal::drbg_pad_input(additional, nullptr, 0);
+    } else {
+        internal::drbg_pad_input(additional, additional_input,
+                                 additional_bytes);
+        if (additional_input != nullptr) {
+            update(additional);
+        }
+    }
+    __m128i keys[aes128::num_rounds + 1];
+    internal::aes128_load_expkey_for_enc(keys, expanded_keys_);
+    constexpr size_t grain_size = 4;
+    const size_t num_blocks = num_bytes / aes128::block_bytes;
+    const size_t num_blocks_q = num_blocks / grain_size;
+    const size_t num_blocks_r = num_blocks % grain_size;
+    auto *p_out = reinterpret_cast<__m128i *>(out);
+    for (size_t i = 0; i < num_blocks_q; i++) {
+        __m128i ms[grain_size];
+        for (size_t j = 0; j < grain_size; j++) {
+            internal::drbg_increment(v_hi_, v_lo_);
+            ms[j] = internal::drbg_counter_block(v_hi_, v_lo_);
+        }
+        using internal::variadic::aes128_enc_impl;
+        using internal::variadic::round_t;
+        aes128_enc_impl(round_t<0>{}, keys, ms[0], ms[1], ms[2], ms[3]);
+        auto *p_outq = p_out + grain_size * i;
+        for (size_t j = 0; j < grain_size; j++) {
+            _mm_storeu_si128(p_outq + j, ms[j]);
+        }
+    }
+    auto *p_out_last = p_out + grain_size * num_blocks_q;
+    using internal::single::aes128_enc_impl;
+    for (size_t i = 0; i < num_blocks_r; i++) {
+        internal::drbg_increment(v_hi_, v_lo_);
+        __m128i m = internal::drbg_counter_block(v_hi_, v_lo_);
+        aes128_enc_impl<0>(m, keys);
+        _mm_storeu_si128(p_out_last + i, m);
+    }
+    const size_t rem_bytes = num_bytes % aes128::block_bytes;
+    if (rem_bytes > 0) {
+        internal::drbg_increment(v_hi_, v_lo_);
+        __m128i m = internal::drbg_counter_block(v_hi_, v_lo_);
+        aes128_enc_impl<0>(m, keys);
+        std::array<uint8_t, aes128::block_bytes> block;
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(block.data()), m);
+        std::copy(block.begin(), block.begin() + rem_bytes,
+                  reinterpret_cast<uint8_t *>(p_out + num_blocks));
+    }
+    update(additional);
+    secure_wipe(additional, sizeof(additional));
+    reseed_counter_++;
+}
+
+bool AES128_CTR_DRBG::operator()(void *out, const size_t num_bytes) noexcept
+{
+    auto *p_out = reinterpret_cast<uint8_t *>(out);
+    try {
+        for (size_t done = 0; done < num_bytes;) {
+            const auto num =
+                std::min(num_bytes - done, drbg::max_request_bytes);
+            generate(p_out + done, num);
+            done += num;
+        }
+    } catch (const std::runtime_error &) {
+        return false;
+    }
+    return true;
+}
+
+AES128_CTR_DRBG &thread_local_drbg()
+{
+    thread_local AES128_CTR_DRBG drbg;
+    thread_local uint64_t generation = rng::fork_generation();
+    const auto current = rng::fork_generation();
+    if (generation != current) {
+        // NOTE: A child process must not replay the state of its parent.
+        drbg.reseed();
+        generation = current;
+    }
+    return drbg;
+}
+} // namespace clt
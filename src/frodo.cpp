@@ -0,0 +1,91 @@
+#include <cassert>
+#include <stdexcept>
+
+#include <x86intrin.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/frodo.hpp>
+
+namespace clt {
+namespace internal {
+template <size_t W>
+inline void frodo_expand_blocks(__m128i *p_out, __m128i &index,
+                                const __m128i inc, const __m128i mask,
+                                const __m128i *keys) noexcept
+{
+    __m128i ms[W];
+    for (size_t k = 0; k < W; k++) {
+        ms[k] = index;
+        index = _mm_add_epi32(index, inc);
+    }
+    using sfinae::aes128_enc_impl;
+    using sfinae::width_round_t;
+    aes128_enc_impl(ms, width_round_t<W, 0>{}, keys);
+    for (size_t k = 0; k < W; k++) {
+        _mm_storeu_si128(p_out + k, _mm_and_si128(ms[k], mask));
+    }
+}
+
+inline void frodo_expand_row(uint16_t *out, const size_t row, const size_t n,
+                             const __m128i mask,
+                             const __m128i *keys) noexcept
+{
+    // NOTE: The first 32-bit lane holds row | (column << 16).
+    auto index = _mm_cvtsi32_si128(static_cast<int>(row));
+    const auto inc = _mm_cvtsi32_si128(frodo::entries_per_block << 16);
+    const size_t num_blocks = n / frodo::entries_per_block;
+    const size_t num_blocks_q = num_blocks / frodo::batch_width;
+    auto *p_out = reinterpret_cast<__m128i *>(out);
+    for (size_t i = 0; i < num_blocks_q; i++) {
+        frodo_expand_blocks<frodo::batch_width>(
+            p_out + frodo::batch_width * i, index, inc, mask, keys);
+    }
+    for (size_t i = frodo::batch_width * num_blocks_q; i < num_blocks; i++) {
+        frodo_expand_blocks<1>(p_out + i, index, inc, mask, keys);
+    }
+}
+} // namespace internal
+
+FrodoMatrixAES128::FrodoMatrixAES128(const void *seed_a, const size_t n,
+                                     const size_t log_q)
+    : n_(n), log_q_(log_q)
+{
+    if ((n == 0) || ((n % frodo::entries_per_block) != 0) ||
+        (n >= (size_t(1) << 16))) {
+        throw std::invalid_argument("n must be a multiple of 8 below 2^16.");
+    }
+    if ((log_q == 0) || (log_q > 16)) {
+        throw std::invalid_argument("log_q must be in [1, 16].");
+    }
+    __m128i keys[aes128::num_rounds + 1];
+    static_assert(sizeof(keys) == sizeof(expanded_keys_));
+    keys[0] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(seed_a));
+    internal::aes128_key_expansion_impl<0>(keys);
+    auto *p_out = reinterpret_cast<__m128i *>(expanded_keys_);
+    for (size_t i = 0; i < std::size(keys); i++) {
+        _mm_storeu_si128(p_out + i, keys[i]);
+    }
+}
+
+void FrodoMatrixAES128::expand_rows(uint16_t *out, const size_t first_row,
+                                    const size_t num_rows) const noexcept
+{
+    assert((first_row + num_rows) <= n_);
+    __m128i keys[aes128::num_rounds + 1];
+    internal::aes128_load_expkey_for_enc(keys, expanded_keys_);
+    const auto mask = _mm_set1_epi16(static_cast<short>((1 << log_q_) - 1));
+    for (size_t i = 0; i < num_rows; i++) {
+        internal::frodo_expand_row(out + n_ * i, first_row + i, n_, mask,
+                                   keys);
+    }
+}
+
+void FrodoMatrixAES128::expand(
+    uint16_t *out, [[maybe_unused]] const bool parallel) const noexcept
+{
+#pragma omp parallel for schedule(static) if (parallel)
+    for (size_t i = 0; i < n_; i++) {
+        expand_rows(out + n_ * i, i, 1);
+    }
+}
+} // namespace clt
@@ -0,0 +1,364 @@
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#include <x86intrin.h>
+
+#include <clt/garble.hpp>
+
+namespace clt {
+namespace internal {
+inline __m128i gc_lsb_mask(const __m128i x) noexcept
+{
+    return _mm_set1_epi64x(-(_mm_cvtsi128_si64(x) & 1));
+}
+
+inline __m128i gc_bit_mask(const uint8_t bit) noexcept
+{
+    return _mm_set1_epi64x(-int64_t(bit & 1));
+}
+} // namespace internal
+
+Circuit::Circuit(std::istream &ist) : num_wires_(0), num_and_gates_(0)
+{
+    size_t num_gates = 0;
+    if (!(ist >> num_gates >> num_wires_)) {
+        throw std::runtime_error("Circuit: invalid header.");
+    }
+    if (num_wires_ > UINT32_MAX) {
+        throw std::runtime_error("Circuit: too many wires.");
+    }
+    auto read_sizes = [&](std::vector<size_t> &sizes) {
+        size_t n = 0;
+        if (!(ist >> n)) {
+            throw std::runtime_error("Circuit: invalid input/output sizes.");
+        }
+        sizes.resize(n);
+        for (auto &size : sizes) {
+            if (!(ist >> size)) {
+                throw std::runtime_error(
+                    "Circuit: invalid input/output sizes.");
+            }
+        }
+    };
+    read_sizes(input_sizes_);
+    read_sizes(output_sizes_);
+    if ((num_inputs() + num_outputs()) > num_wires_) {
+        throw std::runtime_error("Circuit: too few wires for inputs/outputs.");
+    }
+
+    std::vector<gc::Gate> gates(num_gates);
+    std::vector<uint32_t> gate_depths(num_gates);
+    std::vector<uint32_t> wire_depths(num_wires_, 0);
+    std::vector<uint8_t> defined(num_wires_, 0);
+    std::fill_n(defined.begin(), num_inputs(), 1);
+    uint32_t max_depth = 0;
+    for (size_t i = 0; i < num_gates; i++) {
+        size_t num_in = 0, num_out = 0;
+        if (!(ist >> num_in >> num_out) || (num_in < 1) || (num_in > 2) ||
+            (num_out != 1)) {
+            throw std::runtime_error(
+                fmt::format("Circuit: unsupported gate {:d}.", i));
+        }
+        size_t wires[3] = {0, 0, 0};
+        for (size_t k = 0; k < (num_in + num_out); k++) {
+            if (!(ist >> wires[k]) || (wires[k] >= num_wires_)) {
+                throw std::runtime_error(
+                    fmt::format("Circuit: invalid wire of gate {:d}.", i));
+            }
+        }
+        std::string op;
+        ist >> op;
+        auto &gate = gates[i];
+        gate.in0 = wires[0];
+        gate.in1 = (num_in == 2) ? wires[1] : wires[0];
+        gate.out = wires[num_in];
+        if ((num_in == 2) && (op == "XOR")) {
+            gate.type = gc::GateType::XOR;
+        } else if ((num_in == 2) && (op == "AND")) {
+            gate.type = gc::GateType::AND;
+        } else if ((num_in == 1) && (op == "INV")) {
+            gate.type = gc::GateType::INV;
+        } else if ((num_in == 1) && (op == "EQW")) {
+            gate.type = gc::GateType::EQW;
+        } else {
+            throw std::runtime_error(fmt::format(
+                "Circuit: unsupported gate {:d} of type {:s}.", i, op));
+        }
+        if (!defined[gate.in0] || !defined[gate.in1] || defined[gate.out]) {
+            throw std::runtime_error(fmt::format(
+                "Circuit: gate {:d} is not in topological order.", i));
+        }
+        defined[gate.out] = 1;
+        const bool is_and = (gate.type == gc::GateType::AND);
+        gate_depths[i] =
+            std::max(wire_depths[gate.in0], wire_depths[gate.in1]) + is_and;
+        wire_depths[gate.out] = gate_depths[i];
+        max_depth = std::max(max_depth, gate_depths[i]);
+        num_and_gates_ += is_and;
+    }
+    if (!std::all_of(defined.end() - num_outputs(), defined.end(),
+                     [](const auto x) { return x != 0; })) {
+        throw std::runtime_error("Circuit: undefined output wires.");
+    }
+
+    // NOTE: Stable counting sort of gates by 2 depth + (gate is linear).
+    auto bucket = [&](const size_t i) {
+        return 2 * size_t(gate_depths[i]) +
+               (gates[i].type != gc::GateType::AND);
+    };
+    offsets_.assign(2 * (size_t(max_depth) + 1) + 1, 0);
+    for (size_t i = 0; i < num_gates; i++) {
+        offsets_[bucket(i) + 1]++;
+    }
+    for (size_t k = 1; k < offsets_.size(); k++) {
+        offsets_[k] += offsets_[k - 1];
+    }
+    gates_.resize(num_gates);
+    std::vector<size_t> next(offsets_.begin(), offsets_.end() - 1);
+    for (size_t i = 0; i < num_gates; i++) {
+        gates_[next[bucket(i)]++] = gates[i];
+    }
+}
+
+Circuit Circuit::from_file(const std::string &path)
+{
+    std::ifstream ifs(path);
+    if (!ifs) {
+        throw std::runtime_error(
+            fmt::format("Circuit: cannot open {:s}.", path));
+    }
+    return Circuit(ifs);
+}
+
+size_t Circuit::num_inputs() const noexcept
+{
+    size_t n = 0;
+    for (const auto size : input_sizes_) {
+        n += size;
+    }
+    return n;
+}
+
+size_t Circuit::num_outputs() const noexcept
+{
+    size_t n = 0;
+    for (const auto size : output_sizes_) {
+        n += size;
+    }
+    return n;
+}
+
+void Circuit::eval(uint8_t *out, const uint8_t *in) const
+{
+    std::vector<uint8_t> wires(num_wires_);
+    std::copy_n(in, num_inputs(), wires.begin());
+    for (const auto &gate : gates_) {
+        const auto x = wires[gate.in0], y = wires[gate.in1];
+        switch (gate.type) {
+        case gc::GateType::XOR:
+            wires[gate.out] = x ^ y;
+            break;
+        case gc::GateType::AND:
+            wires[gate.out] = x & y;
+            break;
+        case gc::GateType::INV:
+            wires[gate.out] = x ^ 1;
+            break;
+        case gc::GateType::EQW:
+            wires[gate.out] = x;
+            break;
+        }
+    }
+    std::copy(wires.end() - num_outputs(), wires.end(), out);
+}
+
+HalfGatesGarbler::HalfGatesGarbler(const void *seed) noexcept
+    : hash_(gc::default_hash_key), prg_(seed), counter_(0)
+{
+    counter_ = prg_.ctr_stream(delta_.data(), 1, counter_);
+    delta_[0] |= 1;
+}
+
+void HalfGatesGarbler::garble(const Circuit &circuit, void *tables,
+                              void *input_labels, uint8_t *decoding)
+{
+    const size_t num_inputs = circuit.num_inputs();
+    const size_t num_outputs = circuit.num_outputs();
+    const auto &gates = circuit.gates();
+    const auto &offsets = circuit.offsets();
+    std::vector<block_t> wires(circuit.num_wires());
+    counter_ = prg_.ctr_stream(wires.data(), num_inputs, counter_);
+    std::copy_n(wires.begin(), num_inputs,
+                reinterpret_cast<block_t *>(input_labels));
+
+    size_t max_width = 0;
+    for (size_t l = 0; l < circuit.num_layers(); l++) {
+        max_width = std::max(max_width, offsets[2 * l + 1] - offsets[2 * l]);
+    }
+    // NOTE: Hashes of A0, A1, B0, B1 of each AND gate of a layer.
+    std::vector<block_t> xs(4 * max_width), hs(4 * max_width);
+    std::vector<uint64_t> tweaks(4 * max_width);
+
+    auto *p_w = reinterpret_cast<__m128i *>(wires.data());
+    auto *p_x = reinterpret_cast<__m128i *>(xs.data());
+    const auto *p_h = reinterpret_cast<const __m128i *>(hs.data());
+    auto *p_t = reinterpret_cast<__m128i *>(tables);
+    const auto delta =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(delta_.data()));
+    uint64_t j = 0;
+    for (size_t l = 0; l < circuit.num_layers(); l++) {
+        const size_t first = offsets[2 * l], n = offsets[2 * l + 1] - first;
+        for (size_t k = 0; k < n; k++) {
+            const auto &gate = gates[first + k];
+            const auto a0 = _mm_loadu_si128(p_w + gate.in0);
+            const auto b0 = _mm_loadu_si128(p_w + gate.in1);
+            _mm_storeu_si128(p_x + 4 * k, a0);
+            _mm_storeu_si128(p_x + 4 * k + 1, _mm_xor_si128(a0, delta));
+            _mm_storeu_si128(p_x + 4 * k + 2, b0);
+            _mm_storeu_si128(p_x + 4 * k + 3, _mm_xor_si128(b0, delta));
+            tweaks[4 * k] = tweaks[4 * k + 1] = 2 * (j + k);
+            tweaks[4 * k + 2] = tweaks[4 * k + 3] = 2 * (j + k) + 1;
+        }
+        hash_.tccr(hs.data(), xs.data(), tweaks.data(), 4 * n);
+        for (size_t k = 0; k < n; k++) {
+            const auto &gate = gates[first + k];
+            const auto a0 = _mm_loadu_si128(p_x + 4 * k);
+            const auto b0 = _mm_loadu_si128(p_x + 4 * k + 2);
+            const auto pa = internal::gc_lsb_mask(a0);
+            const auto pb = internal::gc_lsb_mask(b0);
+            const auto ha0 = _mm_loadu_si128(p_h + 4 * k);
+            const auto ha1 = _mm_loadu_si128(p_h + 4 * k + 1);
+            const auto hb0 = _mm_loadu_si128(p_h + 4 * k + 2);
+            const auto hb1 = _mm_loadu_si128(p_h + 4 * k + 3);
+            // NOTE: Garbler half gate a AND pb, evaluator half gate
+            // a AND (b xor pb).
+            const auto tg = _mm_xor_si128(_mm_xor_si128(ha0, ha1),
+                                          _mm_and_si128(pb, delta));
+            const auto wg = _mm_xor_si128(ha0, _mm_and_si128(pa, tg));
+            const auto te = _mm_xor_si128(_mm_xor_si128(hb0, hb1), a0);
+            const auto we =
+                _mm_xor_si128(hb0, _mm_and_si128(pb, _mm_xor_si128(te, a0)));
+            _mm_storeu_si128(p_t + 2 * (j + k), tg);
+            _mm_storeu_si128(p_t + 2 * (j + k) + 1, te);
+            _mm_storeu_si128(p_w + gate.out, _mm_xor_si128(wg, we));
+        }
+        j += n;
+        for (size_t i = first + n; i < offsets[2 * l + 2]; i++) {
+            const auto &gate = gates[i];
+            const auto a0 = _mm_loadu_si128(p_w + gate.in0);
+            switch (gate.type) {
+            case gc::GateType::XOR:
+                _mm_storeu_si128(p_w + gate.out,
+                                 _mm_xor_si128(a0, _mm_loadu_si128(
+                                                       p_w + gate.in1)));
+                break;
+            case gc::GateType::INV:
+                _mm_storeu_si128(p_w + gate.out, _mm_xor_si128(a0, delta));
+                break;
+            default:
+                _mm_storeu_si128(p_w + gate.out, a0);
+                break;
+            }
+        }
+    }
+    for (size_t i = 0; i < num_outputs; i++) {
+        decoding[i] = wires[wires.size() - num_outputs + i][0] & 1;
+    }
+}
+
+void HalfGatesGarbler::encode(void *out, const void *input_labels,
+                              const uint8_t *in,
+                              const size_t num_bits) const noexcept
+{
+    const auto *p_in = reinterpret_cast<const __m128i *>(input_labels);
+    auto *p_out = reinterpret_cast<__m128i *>(out);
+    const auto delta =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(delta_.data()));
+    for (size_t i = 0; i < num_bits; i++) {
+        const auto d = _mm_and_si128(internal::gc_bit_mask(in[i]), delta);
+        _mm_storeu_si128(p_out + i,
+                         _mm_xor_si128(_mm_loadu_si128(p_in + i), d));
+    }
+}
+
+void HalfGatesEvaluator::evaluate(const Circuit &circuit, const void *tables,
+                                  const void *input_labels,
+                                  void *output_labels) const
+{
+    using block_t = AES128::block_t;
+    const size_t num_inputs = circuit.num_inputs();
+    const size_t num_outputs = circuit.num_outputs();
+    const auto &gates = circuit.gates();
+    const auto &offsets = circuit.offsets();
+    std::vector<block_t> wires(circuit.num_wires());
+    std::copy_n(reinterpret_cast<const block_t *>(input_labels), num_inputs,
+                wires.begin());
+
+    size_t max_width = 0;
+    for (size_t l = 0; l < circuit.num_layers(); l++) {
+        max_width = std::max(max_width, offsets[2 * l + 1] - offsets[2 * l]);
+    }
+    std::vector<block_t> xs(2 * max_width), hs(2 * max_width);
+    std::vector<uint64_t> tweaks(2 * max_width);
+
+    auto *p_w = reinterpret_cast<__m128i *>(wires.data());
+    auto *p_x = reinterpret_cast<__m128i *>(xs.data());
+    const auto *p_h = reinterpret_cast<const __m128i *>(hs.data());
+    const auto *p_t = reinterpret_cast<const __m128i *>(tables);
+    uint64_t j = 0;
+    for (size_t l = 0; l < circuit.num_layers(); l++) {
+        const size_t first = offsets[2 * l], n = offsets[2 * l + 1] - first;
+        for (size_t k = 0; k < n; k++) {
+            const auto &gate = gates[first + k];
+            _mm_storeu_si128(p_x + 2 * k, _mm_loadu_si128(p_w + gate.in0));
+            _mm_storeu_si128(p_x + 2 * k + 1,
+                             _mm_loadu_si128(p_w + gate.in1));
+            tweaks[2 * k] = 2 * (j + k);
+            tweaks[2 * k + 1] = 2 * (j + k) + 1;
+        }
+        hash_.tccr(hs.data(), xs.data(), tweaks.data(), 2 * n);
+        for (size_t k = 0; k < n; k++) {
+            const auto &gate = gates[first + k];
+            const auto a = _mm_loadu_si128(p_x + 2 * k);
+            const auto b = _mm_loadu_si128(p_x + 2 * k + 1);
+            const auto tg = _mm_loadu_si128(p_t + 2 * (j + k));
+            const auto te = _mm_loadu_si128(p_t + 2 * (j + k) + 1);
+            const auto wg =
+                _mm_xor_si128(_mm_loadu_si128(p_h + 2 * k),
+                              _mm_and_si128(internal::gc_lsb_mask(a), tg));
+            const auto we = _mm_xor_si128(
+                _mm_loadu_si128(p_h + 2 * k + 1),
+                _mm_and_si128(internal::gc_lsb_mask(b),
+                              _mm_xor_si128(te, a)));
+            _mm_storeu_si128(p_w + gate.out, _mm_xor_si128(wg, we));
+        }
+        j += n;
+        for (size_t i = first + n; i < offsets[2 * l + 2]; i++) {
+            const auto &gate = gates[i];
+            const auto a = _mm_loadu_si128(p_w + gate.in0);
+            if (gate.type == gc::GateType::XOR) {
+                _mm_storeu_si128(p_w + gate.out,
+                                 _mm_xor_si128(a, _mm_loadu_si128(
+                                                      p_w + gate.in1)));
+            } else {
+                // NOTE: INV is free for the evaluator, delta is applied by
+                // the garbler.
+                _mm_storeu_si128(p_w + gate.out, a);
+            }
+        }
+    }
+    std::copy(wires.end() - num_outputs, wires.end(),
+              reinterpret_cast<block_t *>(output_labels));
+}
+
+void HalfGatesEvaluator::decode(uint8_t *out, const void *output_labels,
+                                const uint8_t *decoding,
+                                const size_t num_bits) noexcept
+{
+    const auto *p_labels = reinterpret_cast<const uint8_t *>(output_labels);
+    for (size_t i = 0; i < num_bits; i++) {
+        out[i] = (p_labels[aes128::block_bytes * i] & 1) ^ decoding[i];
+    }
+}
+} // namespace clt
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include <x86intrin.h>
+
+#include <clt/gaussian.hpp>
+
+namespace clt {
+namespace internal {
+constexpr uint64_t gaussian_sign_shift = 63;
+constexpr uint64_t gaussian_magnitude_mask =
+    (uint64_t(1) << gaussian::precision_bits) - 1;
+
+inline int32_t gaussian_sample(const uint64_t word,
+                               const std::vector<uint64_t> &cdt) noexcept
+{
+    const uint64_t r = word & gaussian_magnitude_mask;
+    uint64_t k = 0;
+    for (const auto t : cdt) {
+        // NOTE: r >= t iff t - r - 1 is negative, both less than 2^63.
+        k += (t - r - 1) >> 63;
+    }
+    const uint64_t s = word >> gaussian_sign_shift;
+    return static_cast<int32_t>((k ^ (0 - s)) + s);
+}
+
+#if defined(__AVX512F__)
+inline __m512i gaussian_sample_epi64(const __m512i words,
+                                     const std::vector<uint64_t> &cdt) noexcept
+{
+    const auto one = _mm512_set1_epi64(1);
+    const auto r =
+        _mm512_and_si512(words, _mm512_set1_epi64(gaussian_magnitude_mask));
+    auto k = _mm512_setzero_si512();
+    for (const auto t : cdt) {
+        const auto d = _mm512_sub_epi64(
+            _mm512_sub_epi64(_mm512_set1_epi64(t), r), one);
+        k = _mm512_add_epi64(k, _mm512_maskz_srli_epi64(0xff, d, 63));
+    }
+    const auto s = _mm512_maskz_srli_epi64(0xff, words, gaussian_sign_shift);
+    const auto neg_s = _mm512_sub_epi64(_mm512_setzero_si512(), s);
+    return _mm512_add_epi64(_mm512_xor_si512(k, neg_s), s);
+}
+#elif defined(__AVX2__)
+inline __m256i gaussian_sample_epi64(const __m256i words,
+                                     const std::vector<uint64_t> &cdt) noexcept
+{
+    const auto one = _mm256_set1_epi64x(1);
+    const auto r =
+        _mm256_and_si256(words, _mm256_set1_epi64x(gaussian_magnitude_mask));
+    auto k = _mm256_setzero_si256();
+    for (const auto t : cdt) {
+        const auto d = _mm256_sub_epi64(
+            _mm256_sub_epi64(_mm256_set1_epi64x(t), r), one);
+        k = _mm256_add_epi64(k, _mm256_srli_epi64(d, 63));
+    }
+    const auto s = _mm256_srli_epi64(words, gaussian_sign_shift);
+    const auto neg_s = _mm256_sub_epi64(_mm256_setzero_si256(), s);
+    return _mm256_add_epi64(_mm256_xor_si256(k, neg_s), s);
+}
+#endif
+} // namespace internal
+
+DiscreteGaussianCDT::DiscreteGaussianCDT(const double sigma,
+                                         const double tail_cut)
+    : sigma_(sigma)
+{
+    if (!(sigma > 0) || !(tail_cut > 0)) {
+        throw std::invalid_argument("sigma and tail_cut must be positive.");
+    }
+    const double bound = std::ceil(tail_cut * sigma);
+    // NOTE: bound + 1 weights are indexed by int32_t.
+    if (!(bound < std::numeric_limits<int32_t>::max())) {
+        throw std::invalid_argument("tail_cut * sigma is too large.");
+    }
+    bound_ = static_cast<int32_t>(bound);
+    // NOTE: Weights of |x| = k, where x and -x are merged for k > 0.
+    std::vector<long double> weights(bound_ + 1);
+    const long double two_sigma2 = 2.0L * sigma * sigma;
+    long double total = 0;
+    for (int32_t k = 0; k <= bound_; k++) {
+        // NOTE: k * k overflows int32_t for k > 46340.
+        const long double kk = k;
+        weights[k] = ((k == 0) ? 1.0L : 2.0L) * std::exp(-kk * kk / two_sigma2);
+        total += weights[k];
+    }
+    const long double scale = std::ldexp(1.0L, gaussian::precision_bits);
+    cdt_.resize(bound_);
+    long double cumulative = 0;
+    for (int32_t k = 0; k < bound_; k++) {
+        cumulative += weights[k];
+        const auto t = std::round(cumulative / total * scale);
+        cdt_[k] = std::min(static_cast<uint64_t>(t),
+                           uint64_t(1) << gaussian::precision_bits);
+    }
+    // NOTE: Entries rounded to 2^63 are never reached; dropping them
+    // shortens the scan of every sample.
+    while (!cdt_.empty() &&
+           (cdt_.back() == (uint64_t(1) << gaussian::precision_bits))) {
+        cdt_.pop_back();
+    }
+    bound_ = static_cast<int32_t>(cdt_.size());
+}
+
+double DiscreteGaussianCDT::probability(const int32_t x) const noexcept
+{
+    const size_t k = std::abs(x);
+    if (k > size_t(bound_)) {
+        return 0;
+    }
+    const uint64_t hi =
+        (k < cdt_.size()) ? cdt_[k] : (uint64_t(1) << gaussian::precision_bits);
+    const uint64_t lo = (k == 0) ? 0 : cdt_[k - 1];
+    const double p =
+        std::ldexp(double(hi - lo), -int(gaussian::precision_bits));
+    return (k == 0) ? p : (p / 2);
+}
+
+void DiscreteGaussianCDT::sample(int32_t *out, const uint64_t *random_words,
+                                 const size_t num_samples) const noexcept
+{
+    size_t i = 0;
+#if defined(__AVX512F__)
+    for (; (i + 8) <= num_samples; i += 8) {
+        const auto words = _mm512_loadu_si512(random_words + i);
+        const auto xs = internal::gaussian_sample_epi64(words, cdt_);
+        // NOTE: The maskz variant avoids a false -Wmaybe-uninitialized of
+        // GCC 12 on _mm512_cvtepi64_epi32.
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),
+                            _mm512_maskz_cvtepi64_epi32(0xff, xs));
+    }
+#elif defined(__AVX2__)
+    // NOTE: Gather the lower 32 bits of the 64-bit lanes.
+    const auto low_halves = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    for (; (i + 4) <= num_samples; i += 4) {
+        const auto words = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(random_words + i));
+        const auto xs = _mm256_permutevar8x32_epi32(
+            internal::gaussian_sample_epi64(words, cdt_), low_halves);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),
+                         _mm256_castsi256_si128(xs));
+    }
+#endif
+    for (; i < num_samples; i++) {
+        out[i] = internal::gaussian_sample(random_words[i], cdt_);
+    }
+}
+} // namespace clt
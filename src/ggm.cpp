@@ -0,0 +1,176 @@
+#include <cassert>
+
+#include <x86intrin.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/ggm.hpp>
+
+namespace clt {
+namespace internal {
+inline void ggm_load_keys(__m128i *keys, const void *key) noexcept
+{
+    keys[0] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(key));
+    aes128_key_expansion_impl<0>(keys);
+}
+
+template <size_t W>
+inline void ggm_expand_nodes(__m128i *p_out, const __m128i *p_in,
+                             const __m128i *keys_l,
+                             const __m128i *keys_r) noexcept
+{
+    __m128i ss[W], ls[W], rs[W];
+    for (size_t k = 0; k < W; k++) {
+        ss[k] = _mm_loadu_si128(p_in + k);
+    }
+    ggm_children<W>(ls, rs, ss, keys_l, keys_r);
+    for (size_t k = 0; k < W; k++) {
+        _mm_storeu_si128(p_out + 2 * k, ls[k]);
+        _mm_storeu_si128(p_out + 2 * k + 1, rs[k]);
+    }
+}
+
+inline void ggm_expand_in_place(__m128i *p, const size_t depth,
+                                const __m128i *keys_l,
+                                const __m128i *keys_r) noexcept
+{
+    constexpr size_t W = ggm::batch_width;
+    for (size_t l = 0; l < depth; l++) {
+        // NOTE: Backward, so that children 2 i, 2 i + 1 overwrite only nodes
+        // already loaded.
+        size_t i = size_t(1) << l;
+        for (; i >= W; i -= W) {
+            ggm_expand_nodes<W>(p + 2 * (i - W), p + (i - W), keys_l, keys_r);
+        }
+        for (; i > 0; i--) {
+            ggm_expand_nodes<1>(p + 2 * (i - 1), p + (i - 1), keys_l, keys_r);
+        }
+    }
+}
+
+inline void ggm_expand_subtrees(__m128i *p, const size_t depth,
+                                [[maybe_unused]] const bool parallel,
+                                const __m128i *keys_l,
+                                const __m128i *keys_r) noexcept
+{
+    if (depth <= ggm::subtree_depth) {
+        ggm_expand_in_place(p, depth, keys_l, keys_r);
+        return;
+    }
+    const size_t top_depth = depth - ggm::subtree_depth;
+    const size_t num_subtrees = size_t(1) << top_depth;
+    ggm_expand_in_place(p, top_depth, keys_l, keys_r);
+    // NOTE: Move the root of subtree i to its first leaf, backward as
+    // i << subtree_depth >= i.
+    for (size_t i = num_subtrees - 1; i > 0; i--) {
+        _mm_storeu_si128(p + (i << ggm::subtree_depth),
+                         _mm_loadu_si128(p + i));
+    }
+#pragma omp parallel for schedule(static) if (parallel)
+    for (size_t i = 0; i < num_subtrees; i++) {
+        ggm_expand_in_place(p + (i << ggm::subtree_depth), ggm::subtree_depth,
+                            keys_l, keys_r);
+    }
+}
+} // namespace internal
+
+GGMTree::GGMTree(const void *key_left, const void *key_right) noexcept
+{
+    __m128i keys[aes128::num_rounds + 1];
+    static_assert(sizeof(keys) == sizeof(expanded_keys_left_));
+    static_assert(sizeof(keys) == sizeof(expanded_keys_right_));
+    internal::ggm_load_keys(keys, key_left);
+    auto *p_out = reinterpret_cast<__m128i *>(expanded_keys_left_);
+    for (size_t i = 0; i < std::size(keys); i++) {
+        _mm_storeu_si128(p_out + i, keys[i]);
+    }
+    internal::ggm_load_keys(keys, key_right);
+    p_out = reinterpret_cast<__m128i *>(expanded_keys_right_);
+    for (size_t i = 0; i < std::size(keys); i++) {
+        _mm_storeu_si128(p_out + i, keys[i]);
+    }
+}
+
+void GGMTree::expand_level(void *out, const void *in,
+                           const size_t num_nodes) const noexcept
+{
+    __m128i keys_l[aes128::num_rounds + 1], keys_r[aes128::num_rounds + 1];
+    internal::aes128_load_expkey_for_enc(keys_l, expanded_keys_left_);
+    internal::aes128_load_expkey_for_enc(keys_r, expanded_keys_right_);
+    constexpr size_t W = ggm::batch_width;
+    const auto *p_in = reinterpret_cast<const __m128i *>(in);
+    auto *p_out = reinterpret_cast<__m128i *>(out);
+    size_t i = 0;
+    for (; (i + W) <= num_nodes; i += W) {
+        internal::ggm_expand_nodes<W>(p_out + 2 * i, p_in + i, keys_l, keys_r);
+    }
+    for (; i < num_nodes; i++) {
+        internal::ggm_expand_nodes<1>(p_out + 2 * i, p_in + i, keys_l, keys_r);
+    }
+}
+
+void GGMTree::expand(void *buff, const size_t depth,
+                     const bool parallel) const noexcept
+{
+    __m128i keys_l[aes128::num_rounds + 1], keys_r[aes128::num_rounds + 1];
+    internal::aes128_load_expkey_for_enc(keys_l, expanded_keys_left_);
+    internal::aes128_load_expkey_for_enc(keys_r, expanded_keys_right_);
+    internal::ggm_expand_subtrees(reinterpret_cast<__m128i *>(buff), depth,
+                                  parallel, keys_l, keys_r);
+}
+
+void GGMTree::derive(void *out, const void *root, const size_t depth,
+                     const uint64_t index) const noexcept
+{
+    assert(depth < 64);
+    __m128i keys_l[aes128::num_rounds + 1], keys_r[aes128::num_rounds + 1];
+    internal::aes128_load_expkey_for_enc(keys_l, expanded_keys_left_);
+    internal::aes128_load_expkey_for_enc(keys_r, expanded_keys_right_);
+    auto s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(root));
+    for (size_t l = 1; l <= depth; l++) {
+        __m128i left, right;
+        internal::ggm_children<1>(&left, &right, &s, keys_l, keys_r);
+        s = ((index >> (depth - l)) & 1) ? right : left;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), s);
+}
+
+void GGMTree::puncture(void *copath, const void *root, const size_t depth,
+                       const uint64_t index) const noexcept
+{
+    assert(depth < 64);
+    __m128i keys_l[aes128::num_rounds + 1], keys_r[aes128::num_rounds + 1];
+    internal::aes128_load_expkey_for_enc(keys_l, expanded_keys_left_);
+    internal::aes128_load_expkey_for_enc(keys_r, expanded_keys_right_);
+    auto *p_out = reinterpret_cast<__m128i *>(copath);
+    auto s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(root));
+    for (size_t l = 1; l <= depth; l++) {
+        __m128i left, right;
+        internal::ggm_children<1>(&left, &right, &s, keys_l, keys_r);
+        const bool bit = (index >> (depth - l)) & 1;
+        _mm_storeu_si128(p_out + (l - 1), bit ? left : right);
+        s = bit ? right : left;
+    }
+}
+
+void GGMTree::expand_punctured(void *leaves, const void *copath,
+                               const size_t depth, const uint64_t index,
+                               const bool parallel) const noexcept
+{
+    assert(depth < 64);
+    __m128i keys_l[aes128::num_rounds + 1], keys_r[aes128::num_rounds + 1];
+    internal::aes128_load_expkey_for_enc(keys_l, expanded_keys_left_);
+    internal::aes128_load_expkey_for_enc(keys_r, expanded_keys_right_);
+    auto *p = reinterpret_cast<__m128i *>(leaves);
+    const auto *p_copath = reinterpret_cast<const __m128i *>(copath);
+    for (size_t l = 1; l <= depth; l++) {
+        // NOTE: The sibling at level l covers 2^(depth - l) leaves.
+        const size_t sub_depth = depth - l;
+        const uint64_t sibling = (index >> sub_depth) ^ 1;
+        auto *p_sub = p + (sibling << sub_depth);
+        _mm_storeu_si128(p_sub, _mm_loadu_si128(p_copath + (l - 1)));
+        internal::ggm_expand_subtrees(p_sub, sub_depth, parallel, keys_l,
+                                      keys_r);
+    }
+    _mm_storeu_si128(p + index, _mm_setzero_si128());
+}
+} // namespace clt
@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <type_traits>
+
+#include <x86intrin.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/haraka.hpp>
+
+namespace clt {
+namespace internal {
+// NOTE: Round constants of the specification, as arguments of
+// _mm_set_epi32.
+constexpr uint32_t haraka_rc[haraka::num_constants][4] = {
+    {0x0684704c, 0xe620c00a, 0xb2c5fef0, 0x75817b9d},
+    {0x8b66b4e1, 0x88f3a06b, 0x640f6ba4, 0x2f08f717},
+    {0x3402de2d, 0x53f28498, 0xcf029d60, 0x9f029114},
+    {0x0ed6eae6, 0x2e7b4f08, 0xbbf3bcaf, 0xfd5b4f79},
+    {0xcbcfb0cb, 0x4872448b, 0x79eecd1c, 0xbe397044},
+    {0x7eeacdee, 0x6e9032b7, 0x8d5335ed, 0x2b8a057b},
+    {0x67c28f43, 0x5e2e7cd0, 0xe2412761, 0xda4fef1b},
+    {0x2924d9b0, 0xafcacc07, 0x675ffde2, 0x1fc70b3b},
+    {0xab4d63f1, 0xe6867fe9, 0xecdb8fca, 0xb9d465ee},
+    {0x1c30bf84, 0xd4b7cd64, 0x5b2a404f, 0xad037e33},
+    {0xb2cc0bb9, 0x941723bf, 0x69028b2e, 0x8df69800},
+    {0xfa0478a6, 0xde6f5572, 0x4aaa9ec8, 0x5c9d2d8a},
+    {0xdfb49f2b, 0x6b772a12, 0x0efa4f2e, 0x29129fd4},
+    {0x1ea10344, 0xf449a236, 0x32d611ae, 0xbb6a12ee},
+    {0xaf044988, 0x4b050084, 0x5f9600c9, 0x9ca8eca6},
+    {0x21025ed8, 0x9d199c4f, 0x78a2c7e3, 0x27e593ec},
+    {0xbf3aaaf8, 0xa759c9b7, 0xb9282ecd, 0x82d40173},
+    {0x6260700d, 0x6186b017, 0x37f2efd9, 0x10307d6b},
+    {0x5aca45c2, 0x21300443, 0x81c29153, 0xf6fc9ac6},
+    {0x9223973c, 0x226b68bb, 0x2caf92e8, 0x36d1943a},
+    {0xd3bf9238, 0x225886eb, 0x6cbab958, 0xe51071b4},
+    {0xdb863ce5, 0xaef0c677, 0x933dfddd, 0x24e1128d},
+    {0xbb606268, 0xffeba09c, 0x83e48de3, 0xcb2212b1},
+    {0x734bd3dc, 0xe2e4d19c, 0x2db91a4e, 0xc72bf77d},
+    {0x43bb47c3, 0x61301b43, 0x4b1415c4, 0x2cb3924e},
+    {0xdba775a8, 0xe707eff6, 0x03b231dd, 0x16eb6899},
+    {0x6df3614b, 0x3c755977, 0x8e5e2302, 0x7eca472c},
+    {0xcda75a17, 0xd6de7d77, 0x6d1be5b9, 0xb88617f9},
+    {0xec6b43f0, 0x6ba8e9aa, 0x9d6c069d, 0xa946ee5d},
+    {0xcb1e6950, 0xf957332b, 0xa2531159, 0x3bf327c1},
+    {0x2cee0c75, 0x00da619c, 0xe4ed0353, 0x600ed0d9},
+    {0xf0b1a5a1, 0x96e90cab, 0x80bbbabc, 0x63a4a350},
+    {0xae3db102, 0x5e962988, 0xab0dde30, 0x938dca39},
+    {0x17bb8f38, 0xd554a40b, 0x8814f3a8, 0x2e75b442},
+    {0x34bb8a5b, 0x5f427fd7, 0xaeb6b779, 0x360a16f6},
+    {0x26f65241, 0xcbe55438, 0x43ce5918, 0xffbaafde},
+    {0x4ce99a54, 0xb9f3026a, 0xa2ca9cf7, 0x839ec978},
+    {0xae51a51a, 0x1bdff7be, 0x40c06e28, 0x22901235},
+    {0xa0c1613c, 0xba7ed22b, 0xc173bc0f, 0x48a659cf},
+    {0x756acc03, 0x02288288, 0x4ad6bdfd, 0xe9c59da1}};
+
+template <size_t W>
+inline void haraka256_impl(__m128i (*ss)[2], const __m128i *rc) noexcept
+{
+    // NOTE: W messages interleaved, i.e., 2 W independent blocks per
+    // AESENC.
+    for (size_t r = 0; r < haraka::num_rounds; r++) {
+        for (size_t a = 0; a < 2; a++) {
+            for (size_t k = 0; k < W; k++) {
+                ss[k][0] = _mm_aesenc_si128(ss[k][0], rc[4 * r + 2 * a]);
+                ss[k][1] = _mm_aesenc_si128(ss[k][1], rc[4 * r + 2 * a + 1]);
+            }
+        }
+        for (size_t k = 0; k < W; k++) {
+            const auto t = _mm_unpacklo_epi32(ss[k][0], ss[k][1]);
+            ss[k][1] = _mm_unpackhi_epi32(ss[k][0], ss[k][1]);
+            ss[k][0] = t;
+        }
+    }
+}
+
+template <size_t W>
+inline void haraka512_impl(__m128i (*ss)[4], const __m128i *rc) noexcept
+{
+    for (size_t r = 0; r < haraka::num_rounds; r++) {
+        for (size_t a = 0; a < 2; a++) {
+            for (size_t k = 0; k < W; k++) {
+                for (size_t j = 0; j < 4; j++) {
+                    ss[k][j] =
+                        _mm_aesenc_si128(ss[k][j], rc[8 * r + 4 * a + j]);
+                }
+            }
+        }
+        for (size_t k = 0; k < W; k++) {
+            auto &s = ss[k];
+            const auto t = _mm_unpacklo_epi32(s[0], s[1]);
+            s[0] = _mm_unpackhi_epi32(s[0], s[1]);
+            s[1] = _mm_unpacklo_epi32(s[2], s[3]);
+            s[2] = _mm_unpackhi_epi32(s[2], s[3]);
+            s[3] = _mm_unpacklo_epi32(s[0], s[2]);
+            s[0] = _mm_unpackhi_epi32(s[0], s[2]);
+            s[2] = _mm_unpackhi_epi32(s[1], t);
+            s[1] = _mm_unpacklo_epi32(s[1], t);
+        }
+    }
+}
+
+/**
+ * func(W, i) for messages [i, i + W) with W = 8, 4 and 1 in turn.
+ */
+template <class Func>
+inline void haraka_batches(const size_t num_msgs, Func &&func) noexcept
+{
+    size_t i = 0;
+    for (; (i + haraka::batch_width) <= num_msgs; i += haraka::batch_width) {
+        func(std::integral_constant<size_t, haraka::batch_width>{}, i);
+    }
+    for (; (i + 4) <= num_msgs; i += 4) {
+        func(std::integral_constant<size_t, 4>{}, i);
+    }
+    for (; i < num_msgs; i++) {
+        func(std::integral_constant<size_t, 1>{}, i);
+    }
+}
+
+inline void haraka_load_rc(__m128i *rc, const uint8_t *round_constants,
+                           const size_t num_constants) noexcept
+{
+    const auto *p_rc = reinterpret_cast<const __m128i *>(round_constants);
+    for (size_t i = 0; i < num_constants; i++) {
+        rc[i] = _mm_loadu_si128(p_rc + i);
+    }
+}
+} // namespace internal
+
+Haraka::Haraka() noexcept
+{
+    auto *p_rc = reinterpret_cast<__m128i *>(round_constants_);
+    for (size_t i = 0; i < haraka::num_constants; i++) {
+        const auto &c = internal::haraka_rc[i];
+        _mm_storeu_si128(p_rc + i, _mm_set_epi32(c[0], c[1], c[2], c[3]));
+    }
+}
+
+Haraka::Haraka(const void *seed, const size_t seed_bytes) noexcept
+{
+    const Haraka haraka;
+    haraka.sponge(round_constants_, sizeof(round_constants_), seed,
+                  seed_bytes);
+}
+
+void Haraka::hash256(void *out, const void *in,
+                     const size_t num_msgs) const noexcept
+{
+    __m128i rc[haraka::num_constants / 2];
+    internal::haraka_load_rc(rc, round_constants_, std::size(rc));
+    const auto *p_in = reinterpret_cast<const __m128i *>(in);
+    auto *p_out = reinterpret_cast<__m128i *>(out);
+    internal::haraka_batches(num_msgs, [&](const auto w, const size_t i) {
+        constexpr size_t W = decltype(w)::value;
+        __m128i ss[W][2];
+        for (size_t k = 0; k < W; k++) {
+            ss[k][0] = _mm_loadu_si128(p_in + 2 * (i + k));
+            ss[k][1] = _mm_loadu_si128(p_in + 2 * (i + k) + 1);
+        }
+        internal::haraka256_impl<W>(ss, rc);
+        for (size_t k = 0; k < W; k++) {
+            for (size_t j = 0; j < 2; j++) {
+                const auto x = _mm_loadu_si128(p_in + 2 * (i + k) + j);
+                _mm_storeu_si128(p_out + 2 * (i + k) + j,
+                                 _mm_xor_si128(ss[k][j], x));
+            }
+        }
+    });
+}
+
+void Haraka::hash512(void *out, const void *in,
+                     const size_t num_msgs) const noexcept
+{
+    __m128i rc[haraka::num_constants];
+    internal::haraka_load_rc(rc, round_constants_, std::size(rc));
+    const auto *p_in = reinterpret_cast<const __m128i *>(in);
+    auto *p_out = reinterpret_cast<uint8_t *>(out);
+    internal::haraka_batches(num_msgs, [&](const auto w, const size_t i) {
+        constexpr size_t W = decltype(w)::value;
+        __m128i ss[W][4];
+        for (size_t k = 0; k < W; k++) {
+            for (size_t j = 0; j < 4; j++) {
+                ss[k][j] = _mm_loadu_si128(p_in + 4 * (i + k) + j);
+            }
+        }
+        internal::haraka512_impl<W>(ss, rc);
+        for (size_t k = 0; k < W; k++) {
+            for (size_t j = 0; j < 4; j++) {
+                ss[k][j] = _mm_xor_si128(
+                    ss[k][j], _mm_loadu_si128(p_in + 4 * (i + k) + j));
+            }
+            // NOTE: Truncation to the upper halves of s0, s1 and the lower
+            // halves of s2, s3.
+            auto *p = p_out + haraka::digest_bytes * (i + k);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(p),
+                             _mm_unpackhi_epi64(ss[k][0], ss[k][1]));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(p) + 1,
+                             _mm_unpacklo_epi64(ss[k][2], ss[k][3]));
+        }
+    });
+}
+
+void Haraka::perm512(void *out, const void *in) const noexcept
+{
+    __m128i rc[haraka::num_constants];
+    internal::haraka_load_rc(rc, round_constants_, std::size(rc));
+    const auto *p_in = reinterpret_cast<const __m128i *>(in);
+    __m128i ss[1][4];
+    for (size_t j = 0; j < 4; j++) {
+        ss[0][j] = _mm_loadu_si128(p_in + j);
+    }
+    internal::haraka512_impl<1>(ss, rc);
+    auto *p_out = reinterpret_cast<__m128i *>(out);
+    for (size_t j = 0; j < 4; j++) {
+        _mm_storeu_si128(p_out + j, ss[0][j]);
+    }
+}
+
+void Haraka::sponge(void *out, const size_t out_bytes, const void *in,
+                    const size_t in_bytes) const noexcept
+{
+    constexpr size_t rate = haraka::sponge_rate;
+    uint8_t state[4 * aes128::block_bytes] = {0};
+    const auto *p_in = reinterpret_cast<const uint8_t *>(in);
+    size_t n = in_bytes;
+    for (; n >= rate; n -= rate, p_in += rate) {
+        for (size_t i = 0; i < rate; i++) {
+            state[i] ^= p_in[i];
+        }
+        perm512(state, state);
+    }
+    uint8_t last[rate] = {0};
+    std::copy_n(p_in, n, last);
+    last[n] = 0x1f;
+    last[rate - 1] |= 0x80;
+    for (size_t i = 0; i < rate; i++) {
+        state[i] ^= last[i];
+    }
+    auto *p_out = reinterpret_cast<uint8_t *>(out);
+    for (size_t m = out_bytes; m > 0;) {
+        perm512(state, state);
+        const size_t num_bytes = std::min(m, rate);
+        std::copy_n(state, num_bytes, p_out);
+        p_out += num_bytes;
+        m -= num_bytes;
+    }
+}
+} // namespace clt
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cstring>
+
+#include <x86intrin.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/hirose.hpp>
+
+namespace clt {
+namespace internal {
+/**
+ * W compressions in lock step: the key schedules of H || M and then the
+ * 2 W encryptions, whose AESENC chains are independent.
+ */
+template <size_t W>
+inline void hirose_compress(__m128i *gs, __m128i *hs,
+                            const __m128i *ms) noexcept
+{
+    const auto c = _mm_set1_epi32(-1);
+    __m128i keys[W][aes256::num_rounds + 1], as[W], bs[W];
+    for (size_t k = 0; k < W; k++) {
+        keys[k][0] = hs[k];
+        keys[k][1] = ms[k];
+        aes256_key_expansion_impl<2>(keys[k]);
+    }
+    for (size_t k = 0; k < W; k++) {
+        as[k] = _mm_xor_si128(gs[k], keys[k][0]);
+        bs[k] = _mm_xor_si128(_mm_xor_si128(gs[k], c), keys[k][0]);
+    }
+    for (size_t r = 1; r < aes256::num_rounds; r++) {
+        for (size_t k = 0; k < W; k++) {
+            as[k] = _mm_aesenc_si128(as[k], keys[k][r]);
+            bs[k] = _mm_aesenc_si128(bs[k], keys[k][r]);
+        }
+    }
+    for (size_t k = 0; k < W; k++) {
+        const auto &last = keys[k][aes256::num_rounds];
+        as[k] = _mm_aesenclast_si128(as[k], last);
+        bs[k] = _mm_aesenclast_si128(bs[k], last);
+        hs[k] = _mm_xor_si128(bs[k], _mm_xor_si128(gs[k], c));
+        gs[k] = _mm_xor_si128(as[k], gs[k]);
+    }
+}
+
+/**
+ * The last 1 or 2 blocks of a message of num_bytes bytes, whose last
+ * num_bytes % 16 bytes are tail, padded into blocks; returns their number.
+ */
+inline size_t hirose_pad(__m128i *blocks, const uint8_t *tail,
+                         const uint64_t num_bytes) noexcept
+{
+    const size_t r = num_bytes % hirose::block_bytes;
+    const size_t num_blocks = (r + 1 + sizeof(uint64_t) > hirose::block_bytes)
+                                  ? 2
+                                  : 1;
+    uint8_t buff[2 * hirose::block_bytes] = {};
+    std::copy_n(tail, r, buff);
+    buff[r] = 0x80;
+    const uint64_t num_bits = __builtin_bswap64(num_bytes * 8);
+    std::memcpy(buff + num_blocks * hirose::block_bytes - sizeof(num_bits),
+                &num_bits, sizeof(num_bits));
+    const auto *p = reinterpret_cast<const __m128i *>(buff);
+    for (size_t j = 0; j < num_blocks; j++) {
+        blocks[j] = _mm_loadu_si128(p + j);
+    }
+    return num_blocks;
+}
+
+inline void hirose_hash_impl(uint8_t *out, const uint8_t *in,
+                             const size_t num_bytes,
+                             const uint8_t *iv) noexcept
+{
+    const auto *p_iv = reinterpret_cast<const __m128i *>(iv);
+    auto g = _mm_loadu_si128(p_iv), h = _mm_loadu_si128(p_iv + 1);
+    const size_t num_blocks = num_bytes / hirose::block_bytes;
+    const auto *p_in = reinterpret_cast<const __m128i *>(in);
+    for (size_t j = 0; j < num_blocks; j++) {
+        const auto m = _mm_loadu_si128(p_in + j);
+        hirose_compress<1>(&g, &h, &m);
+    }
+    __m128i ms[2];
+    const size_t num_pads = hirose_pad(
+        ms, in + num_blocks * hirose::block_bytes, num_bytes);
+    for (size_t j = 0; j < num_pads; j++) {
+        hirose_compress<1>(&g, &h, ms + j);
+    }
+    auto *p_out = reinterpret_cast<__m128i *>(out);
+    _mm_storeu_si128(p_out, g);
+    _mm_storeu_si128(p_out + 1, h);
+}
+} // namespace internal
+
+Hirose256::Hirose256(const void *iv) noexcept
+{
+    std::copy_n(reinterpret_cast<const uint8_t *>(iv), sizeof(iv_), iv_);
+}
+
+void Hirose256::compress(void *state, const void *block) noexcept
+{
+    auto *p_state = reinterpret_cast<__m128i *>(state);
+    auto g = _mm_loadu_si128(p_state), h = _mm_loadu_si128(p_state + 1);
+    const auto m = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+    internal::hirose_compress<1>(&g, &h, &m);
+    _mm_storeu_si128(p_state, g);
+    _mm_storeu_si128(p_state + 1, h);
+}
+
+void Hirose256::hash(void *out, const void *in,
+                     const size_t num_bytes) const noexcept
+{
+    internal::hirose_hash_impl(reinterpret_cast<uint8_t *>(out),
+                               reinterpret_cast<const uint8_t *>(in),
+                               num_bytes, iv_);
+}
+
+void Hirose256::hash(void *out, const void *in, const size_t msg_bytes,
+                     const size_t num_msgs) const noexcept
+{
+    constexpr size_t W = hirose::batch_width;
+    const auto *p_in = reinterpret_cast<const uint8_t *>(in);
+    auto *p_out = reinterpret_cast<uint8_t *>(out);
+    const auto *p_iv = reinterpret_cast<const __m128i *>(iv_);
+    const size_t num_blocks = msg_bytes / hirose::block_bytes;
+    size_t i = 0;
+    for (; (i + W) <= num_msgs; i += W) {
+        // NOTE: W messages of the same length in lock step, so that their
+        // padding blocks line up as well.
+        const auto *p = p_in + msg_bytes * i;
+        __m128i gs[W], hs[W], ms[W], pads[W][2];
+        for (size_t k = 0; k < W; k++) {
+            gs[k] = _mm_loadu_si128(p_iv);
+            hs[k] = _mm_loadu_si128(p_iv + 1);
+        }
+        for (size_t j = 0; j < num_blocks; j++) {
+            for (size_t k = 0; k < W; k++) {
+                ms[k] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+                    p + msg_bytes * k + hirose::block_bytes * j));
+            }
+            internal::hirose_compress<W>(gs, hs, ms);
+        }
+        size_t num_pads = 0;
+        for (size_t k = 0; k < W; k++) {
+            num_pads = internal::hirose_pad(
+                pads[k], p + msg_bytes * k + num_blocks * hirose::block_bytes,
+                msg_bytes);
+        }
+        for (size_t j = 0; j < num_pads; j++) {
+            for (size_t k = 0; k < W; k++) {
+                ms[k] = pads[k][j];
+            }
+            internal::hirose_compress<W>(gs, hs, ms);
+        }
+        for (size_t k = 0; k < W; k++) {
+            auto *q = reinterpret_cast<__m128i *>(
+                p_out + hirose::digest_bytes * (i + k));
+            _mm_storeu_si128(q, gs[k]);
+            _mm_storeu_si128(q + 1, hs[k]);
+        }
+    }
+    for (; i < num_msgs; i++) {
+        internal::hirose_hash_impl(p_out + hirose::digest_bytes * i,
+                                   p_in + msg_bytes * i, msg_bytes, iv_);
+    }
+}
+} // namespace clt
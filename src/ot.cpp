@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <x86intrin.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/ot.hpp>
+
+namespace clt {
+namespace internal {
+template <class T> inline void ot_transpose_16x16_epi8(T *a) noexcept
+{
+    // NOTE: Each round rotates the 8-bit index (row, column) of bytes left by
+    // 1, so that 4 rounds swap row and column.
+    for (size_t round = 0; round < 4; round++) {
+        T b[16];
+        for (size_t i = 0; i < 8; i++) {
+            if constexpr (sizeof(T) == sizeof(__m128i)) {
+                b[2 * i] = _mm_unpacklo_epi8(a[i], a[i + 8]);
+                b[2 * i + 1] = _mm_unpackhi_epi8(a[i], a[i + 8]);
+            } else {
+                b[2 * i] = _mm256_unpacklo_epi8(a[i], a[i + 8]);
+                b[2 * i + 1] = _mm256_unpackhi_epi8(a[i], a[i + 8]);
+            }
+        }
+        std::copy(b, b + 16, a);
+    }
+}
+
+inline void ot_xor(uint8_t *out, const uint8_t *a, const uint8_t *b,
+                   const __m128i mask, const size_t num_bytes) noexcept
+{
+    assert((num_bytes % sizeof(__m128i)) == 0);
+    auto *p_out = reinterpret_cast<__m128i *>(out);
+    const auto *p_a = reinterpret_cast<const __m128i *>(a);
+    const auto *p_b = reinterpret_cast<const __m128i *>(b);
+    for (size_t i = 0; i < (num_bytes / sizeof(__m128i)); i++) {
+        const auto x = _mm_and_si128(_mm_loadu_si128(p_b + i), mask);
+        _mm_storeu_si128(p_out + i,
+                         _mm_xor_si128(_mm_loadu_si128(p_a + i), x));
+    }
+}
+
+template <bool Pair, size_t W>
+inline void ot_hash_batch(__m128i *p_out0, __m128i *p_out1,
+                          const __m128i *p_in, const uint64_t index,
+                          const __m128i delta, const __m128i *keys) noexcept
+{
+    // NOTE: H(j, x) = pi(x xor j) xor x xor j, with 2 W independent blocks
+    // for pairs.
+    constexpr size_t N = Pair ? (2 * W) : W;
+    __m128i xs[N], ms[N];
+    for (size_t k = 0; k < W; k++) {
+        xs[k] = _mm_xor_si128(_mm_loadu_si128(p_in + k),
+                              _mm_cvtsi64_si128(index + k));
+        if constexpr (Pair) {
+            xs[W + k] = _mm_xor_si128(xs[k], delta);
+        }
+    }
+    std::copy(xs, xs + N, ms);
+    using sfinae::aes128_enc_impl;
+    using sfinae::width_round_t;
+    aes128_enc_impl(ms, width_round_t<N, 0>{}, keys);
+    for (size_t k = 0; k < W; k++) {
+        _mm_storeu_si128(p_out0 + k, _mm_xor_si128(ms[k], xs[k]));
+        if constexpr (Pair) {
+            _mm_storeu_si128(p_out1 + k, _mm_xor_si128(ms[W + k], xs[W + k]));
+        }
+    }
+}
+
+template <bool Pair>
+inline void ot_hash_rows(void *out0, void *out1, const void *in,
+                         const size_t num_rows, const uint64_t first_index,
+                         const __m128i delta,
+                         const uint8_t *expanded_keys) noexcept
+{
+    constexpr size_t W = 8;
+    static_assert((ot::batch_ots % W) == 0);
+    assert((num_rows % W) == 0);
+    __m128i keys[aes128::num_rounds + 1];
+    aes128_load_expkey_for_enc(keys, expanded_keys);
+    auto *p_out0 = reinterpret_cast<__m128i *>(out0);
+    auto *p_out1 = reinterpret_cast<__m128i *>(out1);
+    const auto *p_in = reinterpret_cast<const __m128i *>(in);
+    for (size_t i = 0; i < num_rows; i += W) {
+        ot_hash_batch<Pair, W>(p_out0 + i, Pair ? (p_out1 + i) : nullptr,
+                               p_in + i, first_index + i, delta, keys);
+    }
+}
+
+inline void ot_expand_key(uint8_t *expanded_keys, const void *key) noexcept
+{
+    __m128i keys[aes128::num_rounds + 1];
+    keys[0] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(key));
+    aes128_key_expansion_impl<0>(keys);
+    auto *p_out = reinterpret_cast<__m128i *>(expanded_keys);
+    for (size_t i = 0; i < std::size(keys); i++) {
+        _mm_storeu_si128(p_out + i, keys[i]);
+    }
+}
+} // namespace internal
+
+namespace ot {
+void transpose_128xn(void *out, const void *in, const size_t row_stride,
+                     const size_t num_cols) noexcept
+{
+    assert((num_cols % batch_ots) == 0);
+    const auto *p_in = reinterpret_cast<const uint8_t *>(in);
+    auto *p_out = reinterpret_cast<uint8_t *>(out);
+    constexpr size_t row_bytes = num_base_ots / 8;
+    for (size_t t = 0; t < (num_cols / batch_ots); t++) {
+        // NOTE: A tile of 128 x 128 bits, i.e., 16 bytes of each row.
+        const auto *p_tile = p_in + sizeof(__m128i) * t;
+        auto *p_out_tile = p_out + row_bytes * batch_ots * t;
+#if defined(__AVX2__)
+        // NOTE: Rows 32 g + k and 32 g + 16 + k share a register, so that
+        // movemask gathers bits of 32 rows at once.
+        for (size_t g = 0; g < (num_base_ots / 32); g++) {
+            __m256i a[16];
+            for (size_t k = 0; k < 16; k++) {
+                const auto *p_row = p_tile + row_stride * (32 * g + k);
+                a[k] = _mm256_loadu2_m128i(
+                    reinterpret_cast<const __m128i *>(p_row + 16 * row_stride),
+                    reinterpret_cast<const __m128i *>(p_row));
+            }
+            internal::ot_transpose_16x16_epi8(a);
+            for (size_t o = 0; o < 16; o++) {
+                auto v = a[o];
+                for (size_t bit = 8; bit-- > 0;) {
+                    const uint32_t bits = _mm256_movemask_epi8(v);
+                    v = _mm256_add_epi8(v, v);
+                    std::memcpy(p_out_tile + row_bytes * (8 * o + bit) + 4 * g,
+                                &bits, sizeof(bits));
+                }
+            }
+        }
+#else
+        for (size_t g = 0; g < (num_base_ots / 16); g++) {
+            __m128i a[16];
+            for (size_t k = 0; k < 16; k++) {
+                a[k] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+                    p_tile + row_stride * (16 * g + k)));
+            }
+            internal::ot_transpose_16x16_epi8(a);
+            for (size_t o = 0; o < 16; o++) {
+                auto v = a[o];
+                for (size_t bit = 8; bit-- > 0;) {
+                    const uint16_t bits = _mm_movemask_epi8(v);
+                    v = _mm_add_epi8(v, v);
+                    std::memcpy(p_out_tile + row_bytes * (8 * o + bit) + 2 * g,
+                                &bits, sizeof(bits));
+                }
+            }
+        }
+#endif
+    }
+}
+} // namespace ot
+
+IKNPSender::IKNPSender(const void *delta, const void *base_seeds)
+    : counter_(0), num_ots_(0)
+{
+    std::copy_n(reinterpret_cast<const uint8_t *>(delta), delta_.size(),
+                delta_.data());
+    const auto *p_seeds = reinterpret_cast<const uint8_t *>(base_seeds);
+    prgs_.reserve(ot::num_base_ots);
+    for (size_t i = 0; i < ot::num_base_ots; i++) {
+        prgs_.emplace_back(p_seeds + aes128::key_bytes * i);
+    }
+    internal::ot_expand_key(expanded_hash_keys_, ot::default_hash_key);
+}
+
+void IKNPSender::extend(void *out0, void *out1, const void *u,
+                        const size_t num_ots)
+{
+    assert((num_ots % ot::batch_ots) == 0);
+    const size_t col_bytes = ot::chunk_ots / 8;
+    std::vector<uint8_t> q(ot::num_base_ots * col_bytes);
+    const auto *p_u = reinterpret_cast<const uint8_t *>(u);
+    auto *p_out0 = reinterpret_cast<uint8_t *>(out0);
+    auto *p_out1 = reinterpret_cast<uint8_t *>(out1);
+    const auto delta = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(delta_.data()));
+    for (size_t done = 0; done < num_ots; done += ot::chunk_ots) {
+        const size_t n = std::min(ot::chunk_ots, num_ots - done);
+        const size_t nb = n / 8;
+        for (size_t i = 0; i < ot::num_base_ots; i++) {
+            auto *q_i = q.data() + nb * i;
+            prgs_[i].ctr_stream(q_i, n / ot::batch_ots, counter_);
+            // NOTE: q_i xor (delta_i u_i) without branching on delta.
+            const auto mask = _mm_set1_epi8(
+                -static_cast<char>((delta_[i / 8] >> (i % 8)) & 1));
+            internal::ot_xor(q_i, q_i, p_u + (num_ots / 8) * i + done / 8,
+                             mask, nb);
+        }
+        counter_ += n / ot::batch_ots;
+        auto *p_rows0 = p_out0 + aes128::block_bytes * done;
+        auto *p_rows1 = p_out1 + aes128::block_bytes * done;
+        ot::transpose_128xn(p_rows0, q.data(), nb, n);
+        internal::ot_hash_rows<true>(p_rows0, p_rows1, p_rows0, n,
+                                     num_ots_ + done, delta,
+                                     expanded_hash_keys_);
+    }
+    num_ots_ += num_ots;
+}
+
+IKNPReceiver::IKNPReceiver(const void *base_seeds0, const void *base_seeds1)
+    : counter_(0), num_ots_(0)
+{
+    const auto *p_seeds0 = reinterpret_cast<const uint8_t *>(base_seeds0);
+    const auto *p_seeds1 = reinterpret_cast<const uint8_t *>(base_seeds1);
+    prgs0_.reserve(ot::num_base_ots);
+    prgs1_.reserve(ot::num_base_ots);
+    for (size_t i = 0; i < ot::num_base_ots; i++) {
+        prgs0_.emplace_back(p_seeds0 + aes128::key_bytes * i);
+        prgs1_.emplace_back(p_seeds1 + aes128::key_bytes * i);
+    }
+    internal::ot_expand_key(expanded_hash_keys_, ot::default_hash_key);
+}
+
+void IKNPReceiver::extend(void *out, void *u, const void *choices,
+                          const size_t num_ots)
+{
+    assert((num_ots % ot::batch_ots) == 0);
+    const size_t col_bytes = ot::chunk_ots / 8;
+    std::vector<uint8_t> t(ot::num_base_ots * col_bytes), g(col_bytes);
+    auto *p_u = reinterpret_cast<uint8_t *>(u);
+    const auto *p_choices = reinterpret_cast<const uint8_t *>(choices);
+    auto *p_out = reinterpret_cast<uint8_t *>(out);
+    const auto ones = _mm_set1_epi8(-1);
+    for (size_t done = 0; done < num_ots; done += ot::chunk_ots) {
+        const size_t n = std::min(ot::chunk_ots, num_ots - done);
+        const size_t nb = n / 8;
+        for (size_t i = 0; i < ot::num_base_ots; i++) {
+            auto *t_i = t.data() + nb * i;
+            auto *u_i = p_u + (num_ots / 8) * i + done / 8;
+            prgs0_[i].ctr_stream(t_i, n / ot::batch_ots, counter_);
+            prgs1_[i].ctr_stream(g.data(), n / ot::batch_ots, counter_);
+            // NOTE: u_i = t_i xor G(k_i^1) xor r.
+            internal::ot_xor(u_i, t_i, g.data(), ones, nb);
+            internal::ot_xor(u_i, u_i, p_choices + done / 8, ones, nb);
+        }
+        counter_ += n / ot::batch_ots;
+        auto *p_rows = p_out + aes128::block_bytes * done;
+        ot::transpose_128xn(p_rows, t.data(), nb, n);
+        internal::ot_hash_rows<false>(p_rows, nullptr, p_rows, n,
+                                      num_ots_ + done, _mm_setzero_si128(),
+                                      expanded_hash_keys_);
+    }
+    num_ots_ += num_ots;
+}
+} // namespace clt
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <cassert>
+
+#include <clt/pool.hpp>
+#include <clt/rng.hpp>
+
+namespace clt {
+RandomPool::RandomPool(const AES128::key_t &key, const size_t num_slots)
+    : prf_(key), num_slots_(num_slots), bytes_(pool::slot_bytes * num_slots),
+      seqs_(new Sequence[num_slots]), head_(0), wake_(0), sleeping_(false),
+      stop_(false),
+      fallback_counter_(pool::fallback_counter_base), num_fallbacks_(0)
+{
+    static_assert((pool::slot_bytes % aes128::block_bytes) == 0);
+    assert(num_slots >= pool::refill_batch_slots);
+    // NOTE: Slot i is empty for position p when its sequence is p.
+    for (size_t i = 0; i < num_slots_; i++) {
+        seqs_[i].value.store(i, std::memory_order_relaxed);
+    }
+    producer_ = std::thread([this]() { produce(); });
+}
+
+RandomPool::RandomPool(const size_t num_slots)
+    : RandomPool(gen_key(), num_slots)
+{
+}
+
+RandomPool::~RandomPool()
+{
+    stop_.store(true);
+    wake_.fetch_add(1);
+    wake_.notify_one();
+    producer_.join();
+}
+
+void RandomPool::produce() noexcept
+{
+    constexpr size_t blocks_per_slot = pool::slot_bytes / aes128::block_bytes;
+    uint64_t tail = 0;
+    uint64_t counter = 0;
+    while (!stop_.load(std::memory_order_relaxed)) {
+        const auto wake = wake_.load();
+        // NOTE: Count free slots from the tail, not across the end of the
+        // ring so that one ctr_stream call covers them.
+        const size_t first = tail % num_slots_;
+        const size_t max_slots =
+            std::min(pool::refill_batch_slots, num_slots_ - first);
+        size_t num_free = 0;
+        while ((num_free < max_slots) &&
+               (seqs_[first + num_free].value.load(std::memory_order_acquire) ==
+                tail + num_free)) {
+            num_free++;
+        }
+        if (num_free == 0) {
+            // NOTE: Consumers notify only while this flag is set; the
+            // seq_cst store and load pair with the fence in wake_producer.
+            sleeping_.store(true);
+            if (seqs_[first].value.load() != tail) {
+                wake_.wait(wake, std::memory_order_acquire);
+            }
+            sleeping_.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        counter = prf_.ctr_stream(bytes_.data() + pool::slot_bytes * first,
+                                  blocks_per_slot * num_free, counter);
+        for (size_t i = 0; i < num_free; i++) {
+            seqs_[first + i].value.store(tail + i + 1,
+                                         std::memory_order_release);
+        }
+        tail += num_free;
+    }
+}
+
+void RandomPool::wake_producer() noexcept
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // NOTE: Only the first consumer seeing the producer asleep notifies it,
+    // the others skip the syscall while the producer is being scheduled.
+    if (sleeping_.load(std::memory_order_relaxed) &&
+        sleeping_.exchange(false)) {
+        wake_.fetch_add(1);
+        wake_.notify_one();
+    }
+}
+
+void RandomPool::fallback(void *out, const size_t num_bytes) noexcept
+{
+    const auto num_blocks = aes128::bytes_to_blocks(num_bytes);
+    const auto counter = fallback_counter_.fetch_add(
+        num_blocks, std::memory_order_relaxed);
+    prf_.ctr_byte_stream(out, num_bytes, counter);
+    num_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RandomPool::operator()(void *out, const size_t num_bytes) noexcept
+{
+    if (num_bytes > pool::slot_bytes) {
+        fallback(out, num_bytes);
+        return;
+    }
+    auto pos = head_.load(std::memory_order_relaxed);
+    while (true) {
+        auto &seq = seqs_[pos % num_slots_].value;
+        const auto s = seq.load(std::memory_order_acquire);
+        if (s == pos + 1) {
+            if (head_.compare_exchange_weak(pos, pos + 1,
+                                            std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (s < pos + 1) {
+            // NOTE: The ring is dry, so make sure the producer is awake.
+            wake_producer();
+            fallback(out, num_bytes);
+            return;
+        } else {
+            pos = head_.load(std::memory_order_relaxed);
+        }
+    }
+    const auto *p_slot = bytes_.data() + pool::slot_bytes * (pos % num_slots_);
+    auto *p_out = reinterpret_cast<uint8_t *>(out);
+    std::copy(p_slot, p_slot + num_bytes, p_out);
+    seqs_[pos % num_slots_].value.store(pos + num_slots_,
+                                        std::memory_order_release);
+    if (((pos + 1) % pool::refill_batch_slots) == 0) {
+        wake_producer();
+    }
+}
+} // namespace clt
@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <cassert>
+
+#include <x86intrin.h>
+
+#include <clt/aes-ni.hpp>
+#include <clt/prp.hpp>
+
+namespace clt {
+namespace prp {
+size_t default_num_rounds(const uint64_t domain_size) noexcept
+{
+    // NOTE: About 6 lg(n) rounds following Hoang et al., but never too few
+    // for tiny domains.
+    constexpr size_t min_num_rounds = 24;
+    size_t lg = 0;
+    while ((lg < 64) && ((uint64_t(1) << lg) < domain_size)) {
+        lg++;
+    }
+    return std::max(min_num_rounds, 6 * lg);
+}
+} // namespace prp
+
+namespace internal {
+// NOTE: The top bit of the upper word separates round-key derivation from
+// round-function evaluation.
+constexpr uint64_t prp_round_key_tag = uint64_t(1) << 63;
+
+inline uint64_t prp_partner(const uint64_t x, const uint64_t k,
+                            const uint64_t n) noexcept
+{
+    // NOTE: (k - x) mod n, with k, x < n.
+    return (k >= x) ? (k - x) : (k + (n - x));
+}
+
+template <size_t W>
+inline void prp_round_batch(uint64_t *xs, const uint64_t round,
+                            const uint64_t k, const uint64_t n,
+                            const __m128i *keys) noexcept
+{
+    __m128i ms[W];
+    uint64_t partners[W];
+    for (size_t i = 0; i < W; i++) {
+        partners[i] = prp_partner(xs[i], k, n);
+        const auto x_hat = std::max(xs[i], partners[i]);
+        ms[i] = _mm_set_epi64x(round, x_hat);
+    }
+    using sfinae::aes128_enc_impl;
+    using sfinae::width_round_t;
+    aes128_enc_impl(ms, width_round_t<W, 0>{}, keys);
+    for (size_t i = 0; i < W; i++) {
+        const auto bit = _mm_cvtsi128_si64(ms[i]) & 1;
+        xs[i] = bit ? partners[i] : xs[i];
+    }
+}
+
+template <bool Forward, size_t W>
+inline void prp_eval_batch(uint64_t *out, const uint64_t *in,
+                           const size_t num_indices,
+                           const std::vector<uint64_t> &round_keys,
+                           const uint64_t n, const uint8_t *expanded_keys)
+{
+    __m128i keys[aes128::num_rounds + 1];
+    aes128_load_expkey_for_enc(keys, expanded_keys);
+    const size_t num_rounds = round_keys.size();
+    for (size_t i = 0; i < num_indices; i += W) {
+        const size_t num_lanes = std::min(W, num_indices - i);
+        uint64_t xs[W] = {0};
+        std::copy(in + i, in + i + num_lanes, xs);
+        for (size_t r = 0; r < num_rounds; r++) {
+            const size_t round = Forward ? r : (num_rounds - 1 - r);
+            prp_round_batch<W>(xs, round, round_keys[round], n, keys);
+        }
+        std::copy(xs, xs + num_lanes, out + i);
+    }
+}
+} // namespace internal
+
+SwapOrNot::SwapOrNot(const void *key, const uint64_t domain_size,
+                     const size_t num_rounds)
+    : domain_size_(domain_size), round_keys_(num_rounds)
+{
+    assert(domain_size > 0);
+    __m128i keys[aes128::num_rounds + 1];
+    static_assert(sizeof(keys) == sizeof(expanded_keys_));
+    keys[0] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(key));
+    internal::aes128_key_expansion_impl<0>(keys);
+    auto *p_out = reinterpret_cast<__m128i *>(expanded_keys_);
+    for (size_t i = 0; i < std::size(keys); i++) {
+        _mm_storeu_si128(p_out + i, keys[i]);
+    }
+    // NOTE: The modulo bias of a round key is at most n / 2^64.
+    using internal::single::aes128_enc_impl;
+    for (size_t r = 0; r < num_rounds; r++) {
+        __m128i m = _mm_set_epi64x(r | internal::prp_round_key_tag, 0);
+        aes128_enc_impl<0>(m, keys);
+        round_keys_[r] = uint64_t(_mm_cvtsi128_si64(m)) % domain_size_;
+    }
+}
+
+auto SwapOrNot::forward(const index_t i) const noexcept -> index_t
+{
+    assert(i < domain_size_);
+    index_t out;
+    internal::prp_eval_batch<true, 1>(&out, &i, 1, round_keys_, domain_size_,
+                                      expanded_keys_);
+    return out;
+}
+
+auto SwapOrNot::inverse(const index_t j) const noexcept -> index_t
+{
+    assert(j < domain_size_);
+    index_t out;
+    internal::prp_eval_batch<false, 1>(&out, &j, 1, round_keys_,
+                                       domain_size_, expanded_keys_);
+    return out;
+}
+
+void SwapOrNot::forward(index_t *out, const index_t *in,
+                        const size_t num_indices) const noexcept
+{
+    internal::prp_eval_batch<true, prp::batch_width>(
+        out, in, num_indices, round_keys_, domain_size_, expanded_keys_);
+}
+
+void SwapOrNot::inverse(index_t *out, const index_t *in,
+                        const size_t num_indices) const noexcept
+{
+    internal::prp_eval_batch<false, prp::batch_width>(
+        out, in, num_indices, round_keys_, domain_size_, expanded_keys_);
+}
+} // namespace clt
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <stdexcept>
 #include <type_traits>
 #include <tuple>
 
@@ -5,30 +7,135 @@
 
 #include <clt/arg_type.hpp>
 #include <clt/rdrand.hpp>
+#include <clt/rng.hpp>
+#include <clt/util.hpp>
 
 namespace clt {
 namespace rng {
-#if defined(__RDRND__) || defined(__APPLE__)
-void rdrand(uint16_t *out, const size_t num_elems) noexcept
+namespace {
+template <size_t MaxRetries, class T, class Step>
+inline bool hardware_steps(T *out, const size_t num_elems, Step &&step)
 {
-    for (size_t i = 0; i < num_elems; i += _rdrand16_step(out + i)) {
+    for (size_t i = 0; i < num_elems; i++) {
+        size_t num_retries = 0;
+        while (!step(out + i)) {
+            if (++num_retries >= MaxRetries) {
+                return false;
+            }
+            _mm_pause();
+        }
     }
+    return true;
 }
-void rdrand(uint32_t *out, const size_t num_elems) noexcept
+} // namespace
+
+#if defined(__RDRND__) || defined(__APPLE__)
+bool rdrand(uint16_t *out, const size_t num_elems) noexcept
 {
-    for (size_t i = 0; i < num_elems; i += _rdrand32_step(out + i)) {
-    }
+    return hardware_steps<rdrand_max_retries>(
+        out, num_elems, [](uint16_t *p) { return _rdrand16_step(p); });
+}
+bool rdrand(uint32_t *out, const size_t num_elems) noexcept
+{
+    return hardware_steps<rdrand_max_retries>(
+        out, num_elems, [](uint32_t *p) { return _rdrand32_step(p); });
 }
-void rdrand(uint64_t *out, const size_t num_elems) noexcept
+bool rdrand(uint64_t *out, const size_t num_elems) noexcept
 {
     using rdrand_arg_type =
         typename arg_type<0, decltype(&_rdrand64_step)>::type;
     static_assert(sizeof(uint64_t) ==
                   sizeof(std::remove_pointer_t<rdrand_arg_type>));
-    for (size_t i = 0; i < num_elems;
-         i += _rdrand64_step(reinterpret_cast<rdrand_arg_type>(out) + i)) {
-    }
+    return hardware_steps<rdrand_max_retries>(
+        out, num_elems, [](uint64_t *p) {
+            return _rdrand64_step(reinterpret_cast<rdrand_arg_type>(p));
+        });
 }
 #endif
+
+#if defined(__RDSEED__)
+bool rdseed(uint16_t *out, const size_t num_elems) noexcept
+{
+    return hardware_steps<rdseed_max_retries>(
+        out, num_elems, [](uint16_t *p) { return _rdseed16_step(p); });
+}
+bool rdseed(uint32_t *out, const size_t num_elems) noexcept
+{
+    return hardware_steps<rdseed_max_retries>(
+        out, num_elems, [](uint32_t *p) { return _rdseed32_step(p); });
+}
+bool rdseed(uint64_t *out, const size_t num_elems) noexcept
+{
+    using rdseed_arg_type =
+        typename arg_type<0, decltype(&_rdseed64_step)>::type;
+    static_assert(sizeof(uint64_t) ==
+                  sizeof(std::remove_pointer_t<rdseed_arg_type>));
+    return hardware_steps<rdseed_max_retries>(
+        out, num_elems, [](uint64_t *p) {
+            return _rdseed64_step(reinterpret_cast<rdseed_arg_type>(p));
+        });
+}
+#endif
+
+bool hardware_seed(uint64_t *out, const size_t num_elems) noexcept
+{
+#if defined(__RDSEED__)
+    if (rdseed(out, num_elems)) {
+        return true;
+    }
+#endif
+#if defined(__RDRND__) || defined(__APPLE__)
+    if (rdrand(out, num_elems)) {
+        return true;
+    }
+#endif
+    return rng_global(out, sizeof(uint64_t) * num_elems);
+}
+
+HybridRandom::HybridRandom(const uint64_t reseed_interval_blocks)
+    : counter_(0), reseed_interval_blocks_(reseed_interval_blocks),
+      fork_generation_(fork_generation()), num_reseeds_(0)
+{
+    assert(reseed_interval_blocks > 0);
+    if (!reseed()) {
+        throw std::runtime_error("Hardware seeding is failed.");
+    }
+}
+
+bool HybridRandom::reseed() noexcept
+{
+    static_assert((aes128::key_bytes % sizeof(uint64_t)) == 0);
+    uint64_t key[aes128::key_bytes / sizeof(uint64_t)];
+    if (!hardware_seed(key, std::size(key))) {
+        return false;
+    }
+    cipher_ = AES128(key);
+    secure_wipe(key, sizeof(key));
+    // NOTE: A fresh key makes it safe to restart the counter.
+    counter_ = 0;
+    fork_generation_ = fork_generation();
+    num_reseeds_++;
+    return true;
+}
+
+bool HybridRandom::operator()(void *out, const size_t num_bytes) noexcept
+{
+    if ((fork_generation_ != fork_generation()) && !reseed()) {
+        return false;
+    }
+    auto *p_out = reinterpret_cast<uint8_t *>(out);
+    size_t done = 0;
+    while (done < num_bytes) {
+        if ((counter_ >= reseed_interval_blocks_) && !reseed()) {
+            return false;
+        }
+        const uint64_t max_bytes =
+            (reseed_interval_blocks_ - counter_) * aes128::block_bytes;
+        const auto num = std::min<uint64_t>(num_bytes - done, max_bytes);
+        counter_ = cipher_.ctr_byte_stream(p_out + done, num, counter_);
+        done += num;
+    }
+    return true;
+}
 } // namespace rng
-} // namespace clt
\ No newline at end of file
+} // namespace clt
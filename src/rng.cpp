@@ -1,7 +1,102 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <mutex>
+
+#include <pthread.h>
+
 #include <clt/rng.hpp>
 
 namespace clt {
 namespace rng {
-RandomDevice rng_global;
+namespace {
+// NOTE: Incremented in the child process on every fork.
+std::atomic<uint64_t> fork_generation_counter{0};
+
+void on_fork_child() noexcept
+{
+    fork_generation_counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool fill_from_os(void *out, const size_t num_bytes) noexcept
+{
+#if IS_SYSCALL_GETRANDOM_ENABLED
+    auto *p_out = reinterpret_cast<uint8_t *>(out);
+    size_t gened_bytes = 0;
+    while (gened_bytes < num_bytes) {
+        const auto ret_bytes =
+            ::getrandom(p_out + gened_bytes, num_bytes - gened_bytes, 0);
+        if (ret_bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        gened_bytes += ret_bytes;
+    }
+    return true;
+#else
+    static std::mutex mtx;
+    static RandomDevice rdev;
+    std::lock_guard<std::mutex> lock(mtx);
+    return rdev(out, num_bytes);
+#endif
+}
+
+struct ThreadBuffer {
+    uint8_t bytes_[SystemRandom::buffer_bytes];
+    size_t pos_ = SystemRandom::buffer_bytes;
+    uint64_t generation_ = 0;
+};
+
+thread_local ThreadBuffer thread_buffer;
+} // namespace
+
+uint64_t fork_generation() noexcept
+{
+    return fork_generation_counter.load(std::memory_order_relaxed);
+}
+
+SystemRandom::SystemRandom() noexcept
+{
+    static const int registered =
+        pthread_atfork(nullptr, nullptr, on_fork_child);
+    (void)registered;
+}
+
+bool SystemRandom::operator()(void *buff,
+                              const size_t byte_size) const noexcept
+{
+    if (byte_size > (buffer_bytes / 2)) {
+        return fill_from_os(buff, byte_size);
+    }
+    auto &tb = thread_buffer;
+    const auto generation = fork_generation();
+    if (tb.generation_ != generation) {
+        // NOTE: Never reuse bytes that the parent process may also use.
+        tb.pos_ = buffer_bytes;
+        tb.generation_ = generation;
+    }
+    auto *p_out = reinterpret_cast<uint8_t *>(buff);
+    size_t done = 0;
+    while (done < byte_size) {
+        if (tb.pos_ == buffer_bytes) {
+            if (!fill_from_os(tb.bytes_, buffer_bytes)) {
+                return false;
+            }
+            tb.pos_ = 0;
+        }
+        const auto num = std::min(byte_size - done, buffer_bytes - tb.pos_);
+        std::copy(tb.bytes_ + tb.pos_, tb.bytes_ + tb.pos_ + num,
+                  p_out + done);
+        // NOTE: Consumed bytes are erased, they must not be served twice.
+        std::fill(tb.bytes_ + tb.pos_, tb.bytes_ + tb.pos_ + num, 0);
+        tb.pos_ += num;
+        done += num;
+    }
+    return true;
+}
+
+SystemRandom rng_global;
 } // namespace rng
-} // namespace clt
\ No newline at end of file
+} // namespace clt
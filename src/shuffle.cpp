@@ -3,51 +3,140 @@ static_assert(sizeof(uint64_t) == sizeof(unsigned long int));
 
 #include <clt/shuffle.hpp>
 
+/**
+ * NOTE: rank/unrank follow Myrvold and Ruskey, "Ranking and unranking
+ * permutations in linear time". The swap sequence yields digits d_k in
+ * [0, k) for k = degree, ..., 1, and the rank is the mixed-radix number
+ *   sum_k d_k * prod_{j = k + 1}^{degree} j.
+ * The conversions between digits and the number are done by divide and
+ * conquer over a product tree, so the big integer work is
+ * O(M(n log n) log n) instead of n multiplications or divisions by small
+ * numbers of an O(n log n)-bit integer.
+ */
+
 namespace clt {
 namespace internal {
-inline mpz_class rank_impl(const size_t n, permutation_t &pi,
-                           permutation_t &inv_pi)
+// NOTE: Ranges of at most this many digits are converted by Horner's rule.
+constexpr size_t mixed_radix_leaf_size = 16;
+
+inline mpz_class mixed_radix_leaf_product(const size_t lo, const size_t hi)
 {
-    if (n == 1) {
-        return 0;
+    mpz_class product = 1;
+    for (size_t k = lo; k <= hi; k++) {
+        mpz_mul_ui(product.get_mpz_t(), product.get_mpz_t(), k);
     }
-    const auto s = pi[n - 1];
-    std::swap(pi[n - 1], pi[inv_pi[n - 1]]);
-    std::swap(inv_pi[s], inv_pi[n - 1]);
-    mpz_class mpz_s;
-    mpz_set_ui64(mpz_s, s);
-    return mpz_s + n * rank_impl(n - 1, pi, inv_pi);
+    return product;
 }
-} // namespace internal
 
-mpz_class rank(const permutation_t &pi)
+/**
+ * Convert digits of levels [lo, hi] into (value, product of radices).
+ * Level lo is the most significant and level hi the least significant.
+ */
+inline std::tuple<mpz_class, mpz_class>
+mixed_radix_to_mpz(const permutation_t &digits, const size_t lo,
+                   const size_t hi)
 {
-    const auto degree = pi.size();
-    auto pi_ = pi;
-    auto inv_pi = inverse_permutation(pi);
-    return factorial(degree) - internal::rank_impl(degree, pi_, inv_pi) - 1;
+    if ((hi - lo) < mixed_radix_leaf_size) {
+        mpz_class value = 0;
+        for (size_t k = lo; k <= hi; k++) {
+            mpz_mul_ui(value.get_mpz_t(), value.get_mpz_t(), k);
+            mpz_add_ui(value.get_mpz_t(), value.get_mpz_t(), digits[k]);
+        }
+        return {value, mixed_radix_leaf_product(lo, hi)};
+    }
+    const size_t mid = lo + (hi - lo) / 2;
+    auto [value_hi, product_hi] = mixed_radix_to_mpz(digits, lo, mid);
+    auto [value_lo, product_lo] = mixed_radix_to_mpz(digits, mid + 1, hi);
+    value_hi *= product_lo;
+    value_hi += value_lo;
+    product_hi *= product_lo;
+    return {value_hi, product_hi};
 }
 
-namespace internal {
-inline void unrank_impl(size_t n, mpz_class &r, permutation_t &pi)
+/**
+ * Product tree over levels, with the same splitting as mixed_radix_to_mpz.
+ * Node i has children 2i and 2i + 1.
+ */
+inline void build_product_tree(std::vector<mpz_class> &tree, const size_t node,
+                               const size_t lo, const size_t hi)
+{
+    if (tree.size() <= node) {
+        tree.resize(2 * node + 1);
+    }
+    if ((hi - lo) < mixed_radix_leaf_size) {
+        tree[node] = mixed_radix_leaf_product(lo, hi);
+        return;
+    }
+    const size_t mid = lo + (hi - lo) / 2;
+    build_product_tree(tree, 2 * node, lo, mid);
+    build_product_tree(tree, 2 * node + 1, mid + 1, hi);
+    tree[node] = tree[2 * node] * tree[2 * node + 1];
+}
+
+inline void mpz_to_mixed_radix(permutation_t &digits, mpz_class &value,
+                               const std::vector<mpz_class> &tree,
+                               const size_t node, const size_t lo,
+                               const size_t hi)
 {
-    while (n > 0) {
-        mpz_class r_mod_n;
-        mpz_mod_ui(r_mod_n.get_mpz_t(), r.get_mpz_t(), n);
-        assert(r_mod_n.fits_ulong_p());
-        std::swap(pi[n - 1], pi[r_mod_n.get_ui()]);
-        r /= n;
-        n--;
+    if ((hi - lo) < mixed_radix_leaf_size) {
+        for (size_t k = hi; k >= lo; k--) {
+            digits[k] = mpz_tdiv_q_ui(value.get_mpz_t(), value.get_mpz_t(), k);
+        }
+        assert(value == 0);
+        return;
     }
+    const size_t mid = lo + (hi - lo) / 2;
+    mpz_class value_lo;
+    mpz_tdiv_qr(value.get_mpz_t(), value_lo.get_mpz_t(), value.get_mpz_t(),
+                tree[2 * node + 1].get_mpz_t());
+    mpz_to_mixed_radix(digits, value, tree, 2 * node, lo, mid);
+    mpz_to_mixed_radix(digits, value_lo, tree, 2 * node + 1, mid + 1, hi);
 }
 } // namespace internal
 
-permutation_t unrank(const mpz_class &r, const size_t degree)
+template <class T> mpz_class rank(const std::vector<T> &pi)
 {
-    permutation_t pi(degree);
+    const auto degree = pi.size();
+    if (degree == 0) {
+        return 0;
+    }
+    auto pi_ = pi;
+    auto inv_pi = inverse_permutation(pi);
+    // NOTE: digits[k] is the digit of level k, in [0, k).
+    permutation_t digits(degree + 1, 0);
+    for (size_t n = degree; n > 1; n--) {
+        const auto s = pi_[n - 1];
+        std::swap(pi_[n - 1], pi_[inv_pi[n - 1]]);
+        std::swap(inv_pi[s], inv_pi[n - 1]);
+        digits[n] = s;
+    }
+    const auto [value, fact] = internal::mixed_radix_to_mpz(digits, 1, degree);
+    return fact - value - 1;
+}
+
+template <class T>
+std::vector<T> unrank(const mpz_class &r, const size_t degree)
+{
+    std::vector<T> pi(degree);
     std::iota(pi.begin(), pi.end(), 0);
-    mpz_class r_ = factorial(degree) - r - 1;
-    internal::unrank_impl(degree, r_, pi);
+    if (degree == 0) {
+        return pi;
+    }
+    std::vector<mpz_class> tree;
+    internal::build_product_tree(tree, 1, 1, degree);
+    mpz_class r_ = tree[1] - r - 1;
+    permutation_t digits(degree + 1, 0);
+    internal::mpz_to_mixed_radix(digits, r_, tree, 1, 1, degree);
+    for (size_t n = degree; n > 0; n--) {
+        std::swap(pi[n - 1], pi[digits[n]]);
+    }
     return pi;
 }
+
+template mpz_class rank(const std::vector<uint32_t> &pi);
+template mpz_class rank(const std::vector<uint64_t> &pi);
+template std::vector<uint32_t> unrank(const mpz_class &r,
+                                      const size_t degree);
+template std::vector<uint64_t> unrank(const mpz_class &r,
+                                      const size_t degree);
 } // namespace clt
@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <clt/tree_hash.hpp>
+
+namespace clt {
+namespace internal {
+inline Hirose256 tree_hash_domain(const Hirose256 &base,
+                                  const tree_hash::Domain domain) noexcept
+{
+    uint8_t iv[hirose::digest_bytes];
+    const auto tag = static_cast<uint8_t>(domain);
+    base.hash(iv, &tag, sizeof(tag));
+    return Hirose256(iv);
+}
+
+/**
+ * Read-only mapping of a whole file, unmapped by the destructor.
+ */
+class MappedFile {
+    void *addr_ = nullptr;
+    size_t size_ = 0;
+
+public:
+    explicit MappedFile(const std::string &path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error(
+                fmt::format("TreeHash: cannot open {:s}.", path));
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error(
+                fmt::format("TreeHash: cannot stat {:s}.", path));
+        }
+        size_ = st.st_size;
+        if (size_ > 0) {
+            addr_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if (addr_ == MAP_FAILED) {
+            throw std::runtime_error(
+                fmt::format("TreeHash: cannot map {:s}.", path));
+        }
+        if (size_ > 0) {
+            ::madvise(addr_, size_, MADV_SEQUENTIAL);
+        }
+    }
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile()
+    {
+        if (size_ > 0) {
+            ::munmap(addr_, size_);
+        }
+    }
+    const void *data() const noexcept { return addr_; }
+    size_t size() const noexcept { return size_; }
+};
+} // namespace internal
+
+TreeHash::TreeHash(const size_t leaf_bytes, const void *iv)
+    : leaf_bytes_(leaf_bytes)
+{
+    if ((leaf_bytes == 0) || ((leaf_bytes % hirose::block_bytes) != 0)) {
+        throw std::invalid_argument(fmt::format(
+            "TreeHash: leaf_bytes must be a positive multiple of {:d}.",
+            hirose::block_bytes));
+    }
+    const Hirose256 base(iv);
+    leaf_ = internal::tree_hash_domain(base, tree_hash::Domain::Leaf);
+    node_ = internal::tree_hash_domain(base, tree_hash::Domain::Node);
+    root_ = internal::tree_hash_domain(base, tree_hash::Domain::Root);
+}
+
+size_t TreeHash::num_leaves(const uint64_t num_bytes) const noexcept
+{
+    return std::max<uint64_t>(1, (num_bytes + leaf_bytes_ - 1) / leaf_bytes_);
+}
+
+void TreeHash::hash_leaves(void *out, const void *in,
+                           const uint64_t num_bytes,
+                           [[maybe_unused]] const bool parallel) const noexcept
+{
+    constexpr size_t W = hirose::batch_width;
+    auto *p_out = reinterpret_cast<uint8_t *>(out);
+    const auto *p_in = reinterpret_cast<const uint8_t *>(in);
+    const size_t num_full = num_bytes / leaf_bytes_;
+    const size_t num_batches = num_full / W;
+#pragma omp parallel for schedule(static) if (parallel)
+    for (size_t b = 0; b < num_batches; b++) {
+        leaf_.hash(p_out + tree_hash::digest_bytes * W * b,
+                   p_in + leaf_bytes_ * W * b, leaf_bytes_, W);
+    }
+    leaf_.hash(p_out + tree_hash::digest_bytes * W * num_batches,
+               p_in + leaf_bytes_ * W * num_batches, leaf_bytes_,
+               num_full - W * num_batches);
+    if (num_leaves(num_bytes) > num_full) {
+        leaf_.hash(p_out + tree_hash::digest_bytes * num_full,
+                   p_in + leaf_bytes_ * num_full,
+                   num_bytes - leaf_bytes_ * num_full);
+    }
+}
+
+void TreeHash::hash_nodes(void *digests, const size_t num_digests,
+                          [[maybe_unused]] const bool parallel) const
+{
+    constexpr size_t W = hirose::batch_width;
+    constexpr size_t node_bytes = 2 * tree_hash::digest_bytes;
+    if (num_digests <= 1) {
+        return;
+    }
+    // NOTE: Levels alternate between the digests and a buffer, since
+    // batches of a level would otherwise overwrite digests read by others.
+    std::vector<uint8_t> buff(tree_hash::digest_bytes *
+                              ((num_digests + 1) / 2));
+    auto *src = reinterpret_cast<uint8_t *>(digests);
+    auto *dst = buff.data();
+    for (size_t n = num_digests; n > 1;) {
+        const size_t num_nodes = n / 2;
+        const size_t num_batches = num_nodes / W;
+#pragma omp parallel for schedule(static) if (parallel)
+        for (size_t b = 0; b < num_batches; b++) {
+            node_.hash(dst + tree_hash::digest_bytes * W * b,
+                       src + node_bytes * W * b, node_bytes, W);
+        }
+        node_.hash(dst + tree_hash::digest_bytes * W * num_batches,
+                   src + node_bytes * W * num_batches, node_bytes,
+                   num_nodes - W * num_batches);
+        if ((n % 2) != 0) {
+            std::copy_n(src + node_bytes * num_nodes, tree_hash::digest_bytes,
+                        dst + tree_hash::digest_bytes * num_nodes);
+        }
+        n = num_nodes + (n % 2);
+        std::swap(src, dst);
+    }
+    if (src != digests) {
+        std::copy_n(src, tree_hash::digest_bytes,
+                    reinterpret_cast<uint8_t *>(digests));
+    }
+}
+
+void TreeHash::hash_root(void *out, const void *top,
+                         const uint64_t num_bytes) const noexcept
+{
+    uint8_t buff[tree_hash::digest_bytes + sizeof(num_bytes)];
+    std::copy_n(reinterpret_cast<const uint8_t *>(top),
+                tree_hash::digest_bytes, buff);
+    std::memcpy(buff + tree_hash::digest_bytes, &num_bytes, sizeof(num_bytes));
+    root_.hash(out, buff, sizeof(buff));
+}
+
+void TreeHash::hash(void *out, const void *in, const uint64_t num_bytes,
+                    const bool parallel) const
+{
+    const size_t n = num_leaves(num_bytes);
+    std::vector<uint8_t> digests(tree_hash::digest_bytes * n);
+    hash_leaves(digests.data(), in, num_bytes, parallel);
+    hash_nodes(digests.data(), n, parallel);
+    hash_root(out, digests.data(), num_bytes);
+}
+
+void TreeHash::hash_file(void *out, const std::string &path,
+                         const bool parallel) const
+{
+    const internal::MappedFile file(path);
+    hash(out, file.data(), file.size(), parallel);
+}
+
+TreeHashStream::TreeHashStream(const size_t leaf_bytes, const void *iv)
+    : hash_(leaf_bytes, iv), buffer_(leaf_bytes), buffered_(0),
+      num_leaves_(0), num_bytes_(0)
+{
+}
+
+void TreeHashStream::push(const uint8_t *digest)
+{
+    stack_.insert(stack_.end(), digest, digest + tree_hash::digest_bytes);
+    // NOTE: Two subtrees of 2^k leaves are merged for each trailing zero
+    // bit of the number of leaves.
+    for (uint64_t n = ++num_leaves_; (n % 2) == 0; n /= 2) {
+        const size_t size = stack_.size() - tree_hash::digest_bytes;
+        hash_.hash_nodes(stack_.data() + size - tree_hash::digest_bytes, 2);
+        stack_.resize(size);
+    }
+}
+
+void TreeHashStream::update(const void *in, const size_t num_bytes,
+                            const bool parallel)
+{
+    const size_t leaf_bytes = hash_.leaf_bytes();
+    const auto *p = reinterpret_cast<const uint8_t *>(in);
+    size_t n = num_bytes;
+    uint8_t digest[tree_hash::digest_bytes];
+    if (buffered_ > 0) {
+        const size_t m = std::min(n, leaf_bytes - buffered_);
+        std::copy_n(p, m, buffer_.data() + buffered_);
+        buffered_ += m;
+        p += m;
+        n -= m;
+        if (buffered_ == leaf_bytes) {
+            hash_.hash_leaves(digest, buffer_.data(), leaf_bytes);
+            push(digest);
+            buffered_ = 0;
+        }
+    }
+    const size_t num_full = n / leaf_bytes;
+    if ((buffered_ == 0) && (num_full > 0)) {
+        std::vector<uint8_t> digests(tree_hash::digest_bytes * num_full);
+        hash_.hash_leaves(digests.data(), p, leaf_bytes * num_full, parallel);
+        for (size_t i = 0; i < num_full; i++) {
+            push(digests.data() + tree_hash::digest_bytes * i);
+        }
+        p += leaf_bytes * num_full;
+        n -= leaf_bytes * num_full;
+    }
+    std::copy_n(p, n, buffer_.data() + buffered_);
+    buffered_ += n;
+    num_bytes_ += num_bytes;
+}
+
+void TreeHashStream::finalize(void *out) const
+{
+    auto s = *this;
+    if ((s.buffered_ > 0) || (s.num_leaves_ == 0)) {
+        uint8_t digest[tree_hash::digest_bytes];
+        s.hash_.hash_leaves(digest, s.buffer_.data(), s.buffered_);
+        s.push(digest);
+    }
+    // NOTE: Subtrees are merged from the smallest, as the last digest of a
+    // level of odd size goes up unchanged.
+    while (s.stack_.size() > tree_hash::digest_bytes) {
+        const size_t size = s.stack_.size() - tree_hash::digest_bytes;
+        s.hash_.hash_nodes(s.stack_.data() + size - tree_hash::digest_bytes,
+                           2);
+        s.stack_.resize(size);
+    }
+    s.hash_.hash_root(out, s.stack_.data(), s.num_bytes_);
+}
+} // namespace clt
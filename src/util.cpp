@@ -1,3 +1,7 @@
+// NOTE: memset_s of C11 Annex K is declared only on request.
+#define __STDC_WANT_LIB_EXT1__ 1
+#include <string.h>
+
 #include <clt/util.hpp>
 
 namespace clt {
@@ -9,4 +13,21 @@ const std::string default_format_str<uint64_t>::value = "{:>016x}";
 const std::string default_format_str<uint32_t>::value = "{:>08x}";
 const std::string default_format_str<uint16_t>::value = "{:>04x}";
 const std::string default_format_str<uint8_t>::value = "{:>02x}";
+
+void secure_wipe(void *p, const size_t num_bytes) noexcept
+{
+#if defined(__APPLE__)
+    memset_s(p, num_bytes, 0, num_bytes);
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ > 24)
+    explicit_bzero(p, num_bytes);
+#else
+    // NOTE: Stores through a volatile pointer are kept, and the barrier
+    // keeps the compiler from assuming the bytes are unused afterward.
+    auto *p_byte = static_cast<volatile unsigned char *>(p);
+    for (size_t i = 0; i < num_bytes; i++) {
+        p_byte[i] = 0;
+    }
+    __asm__ __volatile__("" : : "r"(p) : "memory");
+#endif
+}
 } // namespace clt
\ No newline at end of file
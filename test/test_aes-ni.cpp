@@ -1,15 +1,46 @@
 #include <vector>
 #include <numeric>
 #include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 #include <gtest/gtest.h>
 
 #include <clt/aes-ni.hpp>
+#include <clt/aes_hash.hpp>
 #include <clt/rng.hpp>
 #include <clt/rdrand.hpp>
 #include <clt/shuffle.hpp>
+#include <clt/simpira.hpp>
+#include <clt/cuckoo.hpp>
+#include <clt/distribution.hpp>
+#include <clt/dpf.hpp>
+#include <clt/drbg.hpp>
+#include <clt/frodo.hpp>
+#include <clt/garble.hpp>
+#include <clt/ggm.hpp>
+#include <clt/haraka.hpp>
+#include <clt/hirose.hpp>
+#include <clt/ot.hpp>
+#include <clt/gaussian.hpp>
+#include <clt/pool.hpp>
+#include <clt/shared_ctr.hpp>
+#include <clt/streams.hpp>
+#include <clt/tree_hash.hpp>
 #include <clt/statistics.hpp>
 
 using namespace std;
@@ -118,19 +149,91 @@ TEST_F(AESNITest, dev_random)
     }
 }
 
+TEST_F(AESNITest, system_random_threads)
+{
+    constexpr size_t num_keys = 1 << 12;
+    vector<AES128::key_t> keys(num_keys);
+#pragma omp parallel for
+    for (size_t i = 0; i < num_keys; i++) {
+        keys[i] = gen_key();
+    }
+    sort(begin(keys), end(keys));
+    ASSERT_EQ(adjacent_find(begin(keys), end(keys)), end(keys));
+}
+
+TEST_F(AESNITest, system_random_fork)
+{
+    // NOTE: Leave some bytes in this thread's buffer before forking.
+    uint8_t warmup[8];
+    ASSERT_TRUE(rng_global(warmup, sizeof(warmup)));
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    const pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    AES128::key_t key;
+    if (pid == 0) {
+        close(fds[0]);
+        const bool ok = rng_global(key.data(), key.size());
+        const auto written = write(fds[1], key.data(), key.size());
+        _exit((ok && (written == ssize_t(key.size()))) ? 0 : 1);
+    }
+    close(fds[1]);
+    ASSERT_TRUE(rng_global(key.data(), key.size()));
+    AES128::key_t child_key;
+    ASSERT_EQ(read(fds[0], child_key.data(), child_key.size()),
+              ssize_t(child_key.size()));
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+    ASSERT_NE(key, child_key);
+}
+
 #if defined(__RDRND__) || defined(__APPLE__)
 TEST_F(AESNITest, rdrand)
 {
     const size_t num_bytes = 1 << 10;
     vector<uint8_t> out(num_bytes);
     ASSERT_EQ(out.size() % sizeof(generic_rdrand_t), 0);
-    rdrand(out.data(), num_bytes / sizeof(generic_rdrand_t));
+    ASSERT_TRUE(rdrand(out.data(), num_bytes / sizeof(generic_rdrand_t)));
     if (!check_random_bytes(out)) {
         fmt::print(cerr, "WARN: Statistical check failed, but not fatal.\n");
     }
 }
 #endif
 
+#if defined(__RDSEED__)
+TEST_F(AESNITest, rdseed)
+{
+    const size_t num_elems = 1 << 7;
+    vector<uint64_t> out(num_elems);
+    ASSERT_TRUE(rdseed(out.data(), out.size()));
+    if (!check_random_bytes(out)) {
+        fmt::print(cerr, "WARN: Statistical check failed, but not fatal.\n");
+    }
+}
+#endif
+
+TEST_F(AESNITest, hybrid_random)
+{
+    constexpr uint64_t reseed_interval_blocks = 1 << 4;
+    HybridRandom hrng(reseed_interval_blocks);
+    ASSERT_EQ(hrng.get_num_reseeds(), 1);
+    vector<uint8_t> out(5 * reseed_interval_blocks * aes128::block_bytes + 3);
+    ASSERT_TRUE(hrng(out.data(), out.size()));
+    ASSERT_EQ(hrng.get_num_reseeds(), 6);
+    ASSERT_EQ(hrng.get_counter(), 1);
+    // NOTE: Blocks right before and after a reseed come from distinct keys.
+    const auto *p_last = out.data() + (reseed_interval_blocks - 1) *
+                                          aes128::block_bytes;
+    ASSERT_FALSE(equal(p_last, p_last + aes128::block_bytes,
+                       p_last + aes128::block_bytes));
+    if (!check_random_bytes(out)) {
+        fmt::print(cerr, "WARN: Statistical check failed, but not fatal.\n");
+    }
+}
+
 TEST_F(AESNITest, simple_use_aes_ni_with_sample_key_and_texts)
 {
     AES128 cipher(sample_key_.data());
@@ -280,6 +383,1084 @@ TEST_F(AESNITest, aesprf_ctr_byte_stream)
     }
 }
 
+TEST_F(AESNITest, ctr_drbg_known_answer)
+{
+    // NOTE: Not a CAVP vector; computed by OpenSSL 3.0 EVP_RAND "CTR-DRBG"
+    // with cipher "AES-128-CTR" and use_derivation_function 0, whose parent
+    // is "TEST-RAND" with strength 256 and test_entropy 0x00, ..., 0x1f:
+    // EVP_RAND_instantiate(ctx, 128, 0, "pers", 4, params), then
+    // EVP_RAND_generate of 100 bytes without additional input and of 64
+    // bytes with additional input "ad".
+    const vector<uint8_t> expected_out1 = {
+        0x01, 0x1c, 0x71, 0x0e, 0x07, 0xb7, 0x0e, 0xbd,
+        0xe0, 0x25, 0xa4, 0x2e, 0x30, 0x58, 0x7d, 0xfb,
+        0x89, 0x70, 0xbd, 0xaa, 0xd2, 0x1e, 0x84, 0xc9,
+        0x08, 0x22, 0x5a, 0xfd, 0xa9, 0x9e, 0x3d, 0xbf,
+        0xfa, 0xcb, 0x96, 0xf1, 0x84, 0x7f, 0x42, 0x39,
+        0xb5, 0x40, 0x96, 0xa8, 0x6d, 0x84, 0xc3, 0x65,
+        0x59, 0x92, 0x04, 0xcf, 0x83, 0x05, 0x7b, 0x3d,
+        0x5b, 0xb2, 0x51, 0xcb, 0x3e, 0xfe, 0x8f, 0x6c,
+        0x39, 0x4f, 0x4b, 0x75, 0xa4, 0x35, 0xc4, 0xf8,
+        0x24, 0x5a, 0xa9, 0x51, 0xe3, 0x61, 0x8b, 0x1a,
+        0xb2, 0x07, 0xf1, 0xb9, 0x27, 0xea, 0xca, 0xc6,
+        0xa4, 0x98, 0x61, 0xae, 0x01, 0x3c, 0x9f, 0x88,
+        0xd1, 0xf5, 0x1e, 0x63,
+    };
+    const vector<uint8_t> expected_out2 = {
+        0x1d, 0x5c, 0x7a, 0x73, 0xf5, 0x70, 0x04, 0x87,
+        0x08, 0xdc, 0x1e, 0x49, 0x56, 0xe2, 0xef, 0x6b,
+        0xb6, 0x12, 0x20, 0xcd, 0xf8, 0xe8, 0x16, 0x6e,
+        0xc3, 0x06, 0x99, 0xe5, 0x97, 0xbe, 0x27, 0xdd,
+        0xf6, 0x69, 0x14, 0xa5, 0xc2, 0x1f, 0x23, 0x97,
+        0x28, 0x73, 0x1d, 0x06, 0xcc, 0xd6, 0x3a, 0x24,
+        0xf0, 0x98, 0x66, 0xee, 0x98, 0x85, 0xc3, 0xe2,
+        0x68, 0x2a, 0x2b, 0xd8, 0x0e, 0xda, 0xa8, 0x64,
+    };
+    uint8_t entropy_input[drbg::seed_bytes];
+    iota(begin(entropy_input), end(entropy_input), 0);
+    const string personalization = "pers", additional_input = "ad";
+    AES128_CTR_DRBG drbg(entropy_input, personalization.data(),
+                         personalization.size());
+    vector<uint8_t> out(expected_out1.size());
+    drbg.generate(out.data(), out.size());
+    ASSERT_EQ(out, expected_out1);
+    out.resize(expected_out2.size());
+    drbg.generate(out.data(), out.size(), additional_input.data(),
+                  additional_input.size());
+    ASSERT_EQ(out, expected_out2);
+    ASSERT_EQ(drbg.get_reseed_counter(), 3);
+}
+
+TEST_F(AESNITest, ctr_drbg_reseed)
+{
+    static_assert(!std::is_copy_constructible_v<AES128_CTR_DRBG>);
+    static_assert(!std::is_copy_assignable_v<AES128_CTR_DRBG>);
+    uint8_t entropy_input[drbg::seed_bytes] = {0};
+    AES128_CTR_DRBG drbg(entropy_input, nullptr, 0, 2);
+    AES128_CTR_DRBG drbg_ref(entropy_input, nullptr, 0, 2);
+    vector<uint8_t> out(1 << 10), out_ref(out.size());
+    ASSERT_TRUE(drbg(out.data(), out.size()));
+    ASSERT_TRUE(drbg_ref(out_ref.data(), out_ref.size()));
+    ASSERT_EQ(out, out_ref);
+    ASSERT_TRUE(drbg(out.data(), out.size()));
+    ASSERT_TRUE(drbg_ref(out_ref.data(), out_ref.size()));
+    ASSERT_EQ(drbg.get_reseed_counter(), 3);
+    // NOTE: The interval is exceeded, so both reseed from the OS.
+    ASSERT_TRUE(drbg(out.data(), out.size()));
+    ASSERT_TRUE(drbg_ref(out_ref.data(), out_ref.size()));
+    ASSERT_EQ(drbg.get_reseed_counter(), 2);
+    ASSERT_NE(out, out_ref);
+    if (!check_random_bytes(out)) {
+        fmt::print(cerr, "WARN: Statistical check failed, but not fatal.\n");
+    }
+}
+
+TEST_F(AESNITest, ctr_drbg_thread_local_fork)
+{
+    auto &drbg = thread_local_drbg();
+    ASSERT_EQ(&drbg, &thread_local_drbg());
+    AES128::key_t warmup;
+    ASSERT_TRUE(drbg(warmup.data(), warmup.size()));
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    const pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    AES128::key_t key;
+    if (pid == 0) {
+        close(fds[0]);
+        const bool ok = thread_local_drbg()(key.data(), key.size());
+        const auto written = write(fds[1], key.data(), key.size());
+        _exit((ok && (written == ssize_t(key.size()))) ? 0 : 1);
+    }
+    close(fds[1]);
+    ASSERT_TRUE(thread_local_drbg()(key.data(), key.size()));
+    AES128::key_t child_key;
+    ASSERT_EQ(read(fds[0], child_key.data(), child_key.size()),
+              ssize_t(child_key.size()));
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+    ASSERT_NE(key, child_key);
+}
+
+TEST_F(AESNITest, random_pool_threads)
+{
+    constexpr size_t num_threads = 4, num_calls = 1 << 12, request_bytes = 32;
+    AES128::key_t key;
+    copy(random_key_.begin(), random_key_.end(), key.begin());
+    RandomPool pool(key, 1 << 8);
+    vector<vector<uint8_t>> outs(num_threads,
+                                 vector<uint8_t>(num_calls * request_bytes));
+    vector<thread> threads;
+    for (size_t t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < num_calls; i++) {
+                pool(outs[t].data() + i * request_bytes, request_bytes);
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+    // NOTE: Ring and fallback outputs must never repeat a keystream block.
+    set<vector<uint8_t>> blocks;
+    for (const auto &out : outs) {
+        for (size_t i = 0; i < out.size(); i += request_bytes) {
+            blocks.emplace(out.begin() + i, out.begin() + i + request_bytes);
+        }
+    }
+    ASSERT_EQ(blocks.size(), num_threads * num_calls);
+    vector<uint8_t> large(1 << 10);
+    pool(large.data(), large.size());
+    if (!check_random_bytes(large)) {
+        fmt::print(cerr, "WARN: Statistical check failed, but not fatal.\n");
+    }
+}
+
+TEST_F(AESNITest, shared_ctr_single_thread)
+{
+    AESPRF128_CTR ctr(random_key_.data());
+    AESPRF128_SharedCTR shared_ctr(random_key_.data());
+    vector<uint8_t> out, shared_out;
+    for (size_t i = 1; i < 256; i += 7) {
+        out.resize(i);
+        shared_out.resize(i);
+        ctr(out.data(), out.size());
+        shared_ctr(shared_out.data(), shared_out.size());
+        ASSERT_EQ(out, shared_out);
+        ASSERT_EQ(ctr.get_counter(), shared_ctr.get_counter());
+    }
+}
+
+TEST_F(AESNITest, shared_ctr_threads)
+{
+    constexpr size_t num_threads = 4, num_calls = 1 << 10;
+    AES128 cipher(random_key_.data());
+    AES128_SharedCTR shared_ctr(random_key_.data());
+    vector<vector<uint64_t>> counters(num_threads);
+    vector<thread> threads;
+    for (size_t t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t]() {
+            vector<uint64_t> out;
+            for (size_t i = 0; i < num_calls; i++) {
+                // NOTE: 1 to 4 blocks per call.
+                out.resize(2 * (1 + (i + t) % 4));
+                shared_ctr(out.data(), sizeof(uint64_t) * out.size());
+                // NOTE: Decryption recovers the counters used.
+                cipher.dec(out.data(), out.data(), out.size() / 2);
+                for (size_t j = 0; j < out.size(); j += 2) {
+                    ASSERT_EQ(out[j + 1], 0);
+                    counters[t].push_back(out[j]);
+                }
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+    set<uint64_t> all_counters;
+    size_t num_blocks = 0;
+    for (const auto &cs : counters) {
+        all_counters.insert(cs.begin(), cs.end());
+        num_blocks += cs.size();
+    }
+    ASSERT_EQ(all_counters.size(), num_blocks);
+    ASSERT_EQ(shared_ctr.get_counter(), num_blocks);
+    ASSERT_EQ(*all_counters.rbegin(), num_blocks - 1);
+}
+
+TEST_F(AESNITest, ctr_split_and_jump)
+{
+    AES128 cipher(random_key_.data());
+    AES128_CTR ctr(random_key_.data());
+    constexpr size_t num_blocks = 1 << 6;
+    vector<uint64_t> out(2 * num_blocks), jumped_out(2 * num_blocks);
+    ctr.jump(3);
+    ctr(out.data(), sizeof(uint64_t) * out.size());
+    ASSERT_EQ(ctr.get_counter(), 3 + num_blocks);
+    // NOTE: Stream 5 uses counter blocks (5, i), i.e., 5 in the upper half.
+    auto ctr5 = ctr.split(5);
+    ASSERT_EQ(ctr5.get_counter(), 0);
+    ASSERT_EQ(ctr5.get_stream_id(), 5);
+    ctr5.jump(num_blocks / 2);
+    ctr5(jumped_out.data(), sizeof(uint64_t) * jumped_out.size());
+    cipher.dec(out.data(), out.data(), num_blocks);
+    cipher.dec(jumped_out.data(), jumped_out.data(), num_blocks);
+    for (size_t i = 0; i < num_blocks; i++) {
+        ASSERT_EQ(out[2 * i], 3 + i);
+        ASSERT_EQ(out[2 * i + 1], 0);
+        ASSERT_EQ(jumped_out[2 * i], num_blocks / 2 + i);
+        ASSERT_EQ(jumped_out[2 * i + 1], 5);
+    }
+}
+
+TEST_F(AESNITest, parallel_for_streams_reproducible)
+{
+    AESPRF128_CTR ctr(random_key_.data());
+    constexpr size_t num_tasks = 1 << 8, task_bytes = 100;
+#ifdef _OPENMP
+    const auto default_threads = omp_get_max_threads();
+#endif
+    auto run = [&](const int num_threads) {
+        vector<uint8_t> out(num_tasks * task_bytes);
+#ifdef _OPENMP
+        omp_set_num_threads(num_threads);
+#else
+        static_cast<void>(num_threads);
+#endif
+        parallel_for_streams(ctr, num_tasks, [&](size_t i, auto &stream) {
+            stream(out.data() + i * task_bytes, task_bytes);
+        });
+        return out;
+    };
+    const auto out1 = run(1);
+    const auto out4 = run(4), out7 = run(7);
+#ifdef _OPENMP
+    omp_set_num_threads(default_threads);
+#endif
+    ASSERT_EQ(out1, out4);
+    ASSERT_EQ(out1, out7);
+    // NOTE: Task i uses stream i + 1, after the stream 0 of ctr itself,
+    // whose keystream no task replays.
+    auto ctr3 = ctr.split(3);
+    vector<uint8_t> out3(task_bytes);
+    ctr3(out3.data(), out3.size());
+    ASSERT_TRUE(equal(out3.begin(), out3.end(), out1.begin() + 2 * task_bytes));
+    ctr(out3.data(), out3.size());
+    ASSERT_FALSE(equal(out3.begin(), out3.end(), out1.begin()));
+    if (!check_random_bytes(out1)) {
+        fmt::print(cerr, "WARN: Statistical check failed, but not fatal.\n");
+    }
+}
+
+namespace {
+template <class T> auto mean_and_variance(const vector<T> &xs)
+{
+    const double mean = accumulate(xs.begin(), xs.end(), 0.0) / xs.size();
+    double var = 0;
+    for (const auto x : xs) {
+        var += (x - mean) * (x - mean);
+    }
+    return make_tuple(mean, var / xs.size());
+}
+} // namespace
+
+TEST_F(AESNITest, fill_uniform)
+{
+    AESPRF128_CTR ctr(random_key_.data());
+    constexpr size_t num_elems = (1 << 20) + 3;
+    vector<double> ds(num_elems);
+    fill_uniform(ctr, ds.data(), ds.size());
+    ASSERT_TRUE(all_of(ds.begin(), ds.end(),
+                       [](double x) { return (0 <= x) && (x < 1); }));
+    const auto [d_mean, d_var] = mean_and_variance(ds);
+    ASSERT_NEAR(d_mean, 0.5, 0.005);
+    ASSERT_NEAR(d_var, 1.0 / 12, 0.005);
+    vector<float> fs(num_elems);
+    fill_uniform(ctr, fs.data(), fs.size());
+    ASSERT_TRUE(all_of(fs.begin(), fs.end(),
+                       [](float x) { return (0 <= x) && (x < 1); }));
+    const auto [f_mean, f_var] = mean_and_variance(fs);
+    ASSERT_NEAR(f_mean, 0.5, 0.005);
+    ASSERT_NEAR(f_var, 1.0 / 12, 0.005);
+}
+
+TEST_F(AESNITest, fill_normal_and_exponential)
+{
+    AESPRF128_CTR ctr(random_key_.data());
+    constexpr size_t num_elems = (1 << 20) + 1;
+    vector<double> zs(num_elems);
+    fill_normal(ctr, zs.data(), zs.size());
+    const auto [z_mean, z_var] = mean_and_variance(zs);
+    ASSERT_NEAR(z_mean, 0, 0.01);
+    ASSERT_NEAR(z_var, 1, 0.01);
+    vector<double> es(num_elems);
+    fill_exponential(ctr, es.data(), es.size());
+    ASSERT_TRUE(all_of(es.begin(), es.end(), [](double x) { return x >= 0; }));
+    const auto [e_mean, e_var] = mean_and_variance(es);
+    ASSERT_NEAR(e_mean, 1, 0.01);
+    ASSERT_NEAR(e_var, 1, 0.02);
+}
+
+TEST_F(AESNITest, bits_to_normal_and_exponential_accuracy)
+{
+    constexpr size_t num_elems = 1 << 16;
+    vector<uint64_t> bits(num_elems);
+    init(bits);
+    // NOTE: Extremes of the uniform variates.
+    bits[0] = bits[5] = 0;
+    bits[1] = bits[6] = ~uint64_t(0);
+    auto u01 = [](uint64_t x) { return double(x >> 12) / (1ULL << 52); };
+    vector<double> zs(num_elems), es(num_elems);
+    distribution::bits_to_normal(zs.data(), bits.data(), num_elems);
+    distribution::bits_to_exponential(es.data(), bits.data(), num_elems);
+    constexpr double two_pi = 6.283185307179586476925286766559;
+    for (size_t i = 0; i < num_elems; i += 8) {
+        for (size_t j = 0; j < 4; j++) {
+            const double r = sqrt(-2 * log(1 - u01(bits[i + j])));
+            const double theta = two_pi * u01(bits[i + j + 4]);
+            ASSERT_NEAR(zs[i + j], r * cos(theta), 1e-13);
+            ASSERT_NEAR(zs[i + j + 4], r * sin(theta), 1e-13);
+        }
+    }
+    for (size_t i = 0; i < num_elems; i++) {
+        const double e = -log(1 - u01(bits[i]));
+        ASSERT_NEAR(es[i], e, 1e-14 * max(1.0, e));
+    }
+}
+
+TEST_F(AESNITest, discrete_gaussian_sample)
+{
+    const DiscreteGaussianCDT dg(3.2);
+    // NOTE: Pr[|x| > 29] < 2^-64 is dropped from the table.
+    ASSERT_EQ(dg.bound(), 29) << dg;
+    const auto &cdt = dg.cdt();
+    ASSERT_TRUE(is_sorted(cdt.begin(), cdt.end()));
+    double total = 0;
+    for (int32_t x = -dg.bound(); x <= dg.bound(); x++) {
+        total += dg.probability(x);
+    }
+    ASSERT_NEAR(total, 1.0, 1e-15);
+    constexpr size_t num_samples = (1 << 12) + 7;
+    vector<uint64_t> words(num_samples);
+    init(words);
+    // NOTE: Extremes and boundaries of the table.
+    words[0] = 0;
+    words[1] = ~uint64_t(0);
+    words[2] = cdt[0];
+    words[3] = cdt[0] - 1;
+    words[4] = cdt[1] | (uint64_t(1) << 63);
+    vector<int32_t> xs(num_samples);
+    dg.sample(xs.data(), words.data(), num_samples);
+    for (size_t i = 0; i < num_samples; i++) {
+        const uint64_t r = words[i] & ~(uint64_t(1) << 63);
+        int32_t k = 0;
+        while ((k < int32_t(cdt.size())) && (r >= cdt[k])) {
+            k++;
+        }
+        ASSERT_EQ(xs[i], (words[i] >> 63) ? -k : k) << i;
+    }
+    ASSERT_EQ(xs[1], -dg.bound());
+    ASSERT_EQ(xs[2], 1);
+    ASSERT_EQ(xs[3], 0);
+    ASSERT_EQ(xs[4], -2);
+
+    // NOTE: k * k exceeds int32_t in the table of a wide distribution.
+    const DiscreteGaussianCDT wide(8000.0);
+    ASSERT_GT(wide.bound(), 46340);
+    ASSERT_NEAR(wide.probability(0), 1 / (sqrt(2 * M_PI) * 8000.0), 1e-9);
+    ASSERT_THROW(DiscreteGaussianCDT(1e9), std::invalid_argument);
+}
+
+TEST_F(AESNITest, discrete_gaussian_distribution)
+{
+    constexpr double sigma = 3.2;
+    const DiscreteGaussianCDT dg(sigma);
+    AES128_CTR ctr(random_key_.data());
+    vector<int32_t> xs((1 << 20) + 3);
+    dg(ctr, xs.data(), xs.size());
+    const auto [mean, var] = mean_and_variance(xs);
+    ASSERT_NEAR(mean, 0, 0.02);
+    ASSERT_NEAR(var, sigma * sigma, 0.05);
+    map<int32_t, size_t> counts;
+    for (const auto x : xs) {
+        counts[x]++;
+    }
+    // NOTE: Chi-squared test with about 30 bins; the 1e-6 quantile of
+    // chi-squared distribution with 30 degrees of freedom is about 87.
+    double chi2 = 0;
+    size_t num_bins = 0;
+    for (int32_t x = -dg.bound(); x <= dg.bound(); x++) {
+        const double expected = dg.probability(x) * xs.size();
+        if (expected < 5) {
+            continue;
+        }
+        const double d = counts[x] - expected;
+        chi2 += d * d / expected;
+        num_bins++;
+    }
+    ASSERT_GE(num_bins, 25);
+    ASSERT_LT(chi2, 87) << num_bins;
+}
+
+TEST_F(AESNITest, frodo_matrix_expansion)
+{
+    // NOTE: n = 976 has 122 blocks per row, not a multiple of the batch.
+    for (const auto &[n, log_q] : {pair<size_t, size_t>(640, 15),
+                                   pair<size_t, size_t>(976, 16)}) {
+        const FrodoMatrixAES128 a(random_key_.data(), n, log_q);
+        vector<uint16_t> mat(n * n);
+        a.expand(mat.data());
+        AES128 aes(random_key_.data());
+        const uint16_t mask = (1 << log_q) - 1;
+        for (const size_t i : {size_t(0), size_t(1), n / 2, n - 1}) {
+            for (size_t j = 0; j < n; j += 8) {
+                uint16_t block[8] = {uint16_t(i), uint16_t(j)};
+                aes.enc(block, block);
+                for (size_t k = 0; k < 8; k++) {
+                    ASSERT_EQ(mat[n * i + j + k], block[k] & mask)
+                        << a << " " << i << " " << j;
+                }
+            }
+        }
+        vector<uint16_t> rows(3 * n);
+        a.expand_rows(rows.data(), 5, 3);
+        ASSERT_TRUE(equal(rows.begin(), rows.end(), mat.begin() + 5 * n));
+        vector<uint16_t> mat_parallel(n * n);
+        a.expand(mat_parallel.data(), true);
+        ASSERT_EQ(mat, mat_parallel);
+    }
+    ASSERT_THROW(FrodoMatrixAES128(random_key_.data(), 641, 15),
+                 std::invalid_argument);
+    ASSERT_THROW(FrodoMatrixAES128(random_key_.data(), 640, 17),
+                 std::invalid_argument);
+}
+
+TEST_F(AESNITest, ggm_tree_expansion)
+{
+    const GGMTree tree;
+    using block_t = GGMTree::block_t;
+    block_t root;
+    copy_n(random_key_.begin(), root.size(), root.begin());
+    // NOTE: Reference by MMO128 with the fixed keys, level by level.
+    const MMO128 mmo_l(ggm::default_key_left), mmo_r(ggm::default_key_right);
+    constexpr size_t small_depth = 5;
+    vector<block_t> level(1, root);
+    for (size_t l = 0; l < small_depth; l++) {
+        vector<block_t> next(2 * level.size());
+        for (size_t i = 0; i < level.size(); i++) {
+            mmo_l(next[2 * i].data(), level[i].data());
+            mmo_r(next[2 * i + 1].data(), level[i].data());
+        }
+        level = next;
+    }
+    vector<block_t> leaves(level.size());
+    leaves[0] = root;
+    tree.expand(leaves.data(), small_depth);
+    ASSERT_EQ(leaves, level);
+    // NOTE: Deeper than ggm::subtree_depth, i.e., expanded by subtrees.
+    constexpr size_t depth = ggm::subtree_depth + 3;
+    leaves.assign(size_t(1) << depth, block_t{});
+    leaves[0] = root;
+    tree.expand(leaves.data(), depth);
+    for (const uint64_t i : {uint64_t(0), uint64_t(1), uint64_t(1000),
+                             uint64_t(leaves.size() - 1)}) {
+        block_t leaf;
+        tree.derive(leaf.data(), root.data(), depth, i);
+        ASSERT_EQ(leaf, leaves[i]) << i;
+    }
+    vector<block_t> leaves_parallel(leaves.size());
+    leaves_parallel[0] = root;
+    tree.expand(leaves_parallel.data(), depth, true);
+    ASSERT_EQ(leaves, leaves_parallel);
+    vector<block_t> leaves_chunks(leaves.size());
+    tree.expand_chunks(
+        root.data(), depth,
+        [&](size_t first, const block_t *chunk, size_t num_leaves) {
+            copy(chunk, chunk + num_leaves, leaves_chunks.begin() + first);
+        },
+        true);
+    ASSERT_EQ(leaves, leaves_chunks);
+    // NOTE: Every leaf but the punctured one from the co-path.
+    const uint64_t punctured = 0x5a5 % leaves.size();
+    vector<block_t> copath(depth);
+    tree.puncture(copath.data(), root.data(), depth, punctured);
+    vector<block_t> leaves_punctured(leaves.size());
+    tree.expand_punctured(leaves_punctured.data(), copath.data(), depth,
+                          punctured);
+    ASSERT_EQ(leaves_punctured[punctured], block_t{});
+    leaves_punctured[punctured] = leaves[punctured];
+    ASSERT_EQ(leaves, leaves_punctured);
+}
+
+TEST_F(AESNITest, dpf_eval_and_eval_full)
+{
+    // NOTE: The last domain is deeper than ggm::subtree_depth.
+    for (const auto &[log_domain, elem_bits] :
+         {pair<size_t, size_t>(12, 1), pair<size_t, size_t>(10, 8),
+          pair<size_t, size_t>(9, 16), pair<size_t, size_t>(8, 32),
+          pair<size_t, size_t>(11, 64), pair<size_t, size_t>(19, 1)}) {
+        const DPF dpf(log_domain, elem_bits);
+        const uint64_t domain_size = uint64_t(1) << log_domain;
+        const uint64_t mask =
+            (elem_bits == 64) ? ~uint64_t(0) : ((uint64_t(1) << elem_bits) - 1);
+        const uint64_t alpha = 0x2c5 % domain_size;
+        const uint64_t beta = 0x0123456789abcdefULL & mask;
+        const auto [key0, key1] = dpf.gen(alpha, beta);
+        ASSERT_EQ(key0.cw_seeds.size(), dpf.depth());
+        vector<uint64_t> full0(dpf.full_bytes() / sizeof(uint64_t));
+        vector<uint64_t> full1(full0.size());
+        dpf.eval_full(key0, full0.data());
+        dpf.eval_full(key1, full1.data(), true);
+        auto elem = [&](const vector<uint64_t> &full, uint64_t x) {
+            const uint64_t offset = x * elem_bits;
+            return (full[offset / 64] >> (offset % 64)) & mask;
+        };
+        for (uint64_t x = 0; x < domain_size; x++) {
+            const auto y0 = elem(full0, x), y1 = elem(full1, x);
+            const auto y = (elem_bits == 1) ? (y0 ^ y1) : ((y0 + y1) & mask);
+            ASSERT_EQ(y, (x == alpha) ? beta : 0) << dpf << " " << x;
+        }
+        for (const uint64_t x : {uint64_t(0), alpha, alpha ^ 1,
+                                 domain_size - 1, domain_size / 3}) {
+            ASSERT_EQ(dpf.eval(key0, x), elem(full0, x)) << dpf << " " << x;
+            ASSERT_EQ(dpf.eval(key1, x), elem(full1, x)) << dpf << " " << x;
+        }
+    }
+    ASSERT_THROW(DPF(20, 3), std::invalid_argument);
+    ASSERT_THROW(DPF(6, 1), std::invalid_argument);
+}
+
+TEST_F(AESNITest, ot_transpose)
+{
+    constexpr size_t num_cols = 3 * ot::batch_ots;
+    constexpr size_t row_stride = num_cols / 8 + 16;
+    vector<uint8_t> in(ot::num_base_ots * row_stride);
+    init(in);
+    vector<uint8_t> out(num_cols * ot::num_base_ots / 8);
+    ot::transpose_128xn(out.data(), in.data(), row_stride, num_cols);
+    auto bit = [](const uint8_t *p, const size_t i) {
+        return (p[i / 8] >> (i % 8)) & 1;
+    };
+    for (size_t i = 0; i < ot::num_base_ots; i++) {
+        for (size_t j = 0; j < num_cols; j++) {
+            ASSERT_EQ(bit(out.data() + j * ot::num_base_ots / 8, i),
+                      bit(in.data() + i * row_stride, j))
+                << i << " " << j;
+        }
+    }
+}
+
+TEST_F(AESNITest, iknp_random_ot)
+{
+    using block_t = AES128::block_t;
+    // NOTE: Base OTs by hand, the sender receives seeds1 where delta is set.
+    vector<block_t> seeds0(ot::num_base_ots), seeds1(ot::num_base_ots);
+    vector<block_t> chosen(ot::num_base_ots);
+    for (size_t i = 0; i < ot::num_base_ots; i++) {
+        seeds0[i] = gen_key();
+        seeds1[i] = gen_key();
+    }
+    const block_t delta = gen_key();
+    for (size_t i = 0; i < ot::num_base_ots; i++) {
+        chosen[i] = ((delta[i / 8] >> (i % 8)) & 1) ? seeds1[i] : seeds0[i];
+    }
+    IKNPSender sender(delta.data(), chosen.data());
+    IKNPReceiver receiver(seeds0.data(), seeds1.data());
+    // NOTE: Two calls, the second one over several chunks.
+    for (const size_t num_ots : {size_t(ot::batch_ots),
+                                 size_t(2 * ot::chunk_ots + ot::batch_ots)}) {
+        vector<uint8_t> choices(num_ots / 8);
+        init(choices);
+        vector<uint8_t> u(ot::num_base_ots * num_ots / 8);
+        vector<block_t> out(num_ots), out0(num_ots), out1(num_ots);
+        receiver.extend(out.data(), u.data(), choices.data(), num_ots);
+        sender.extend(out0.data(), out1.data(), u.data(), num_ots);
+        for (size_t j = 0; j < num_ots; j++) {
+            const bool r = (choices[j / 8] >> (j % 8)) & 1;
+            ASSERT_EQ(out[j], r ? out1[j] : out0[j]) << j;
+            ASSERT_NE(out[j], r ? out0[j] : out1[j]) << j;
+        }
+        ASSERT_EQ(set<block_t>(out0.begin(), out0.end()).size(), num_ots);
+    }
+    ASSERT_EQ(sender.get_num_ots(), receiver.get_num_ots());
+}
+
+TEST_F(AESNITest, half_gates_garbling)
+{
+    // NOTE: 32-bit adder in Bristol Fashion, the carry out is inverted and
+    // outputs are copied by EQW to the last wires.
+    constexpr size_t n = 32;
+    ostringstream body;
+    size_t num_gates = 0, next_wire = 2 * n;
+    auto gate = [&](const string &op, const size_t x, const size_t y) {
+        if (op == "INV" || op == "EQW") {
+            body << fmt::format("1 1 {} {} {}\n", x, next_wire, op);
+        } else {
+            body << fmt::format("2 1 {} {} {} {}\n", x, y, next_wire, op);
+        }
+        num_gates++;
+        return next_wire++;
+    };
+    vector<size_t> sums(n);
+    sums[0] = gate("XOR", 0, n);
+    size_t carry = gate("AND", 0, n);
+    for (size_t i = 1; i < n; i++) {
+        const auto t = gate("XOR", i, carry), u = gate("XOR", n + i, carry);
+        sums[i] = gate("XOR", t, n + i);
+        carry = gate("XOR", gate("AND", t, u), carry);
+    }
+    const auto not_carry = gate("INV", carry, 0);
+    for (const auto w : sums) {
+        gate("EQW", w, 0);
+    }
+    gate("EQW", not_carry, 0);
+    istringstream ist(fmt::format("{} {}\n2 {} {}\n1 {}\n\n{}", num_gates,
+                                  next_wire, n, n, n + 1, body.str()));
+    const Circuit circuit(ist);
+    ASSERT_EQ(circuit.num_and_gates(), n);
+    ASSERT_EQ(circuit.num_layers(), n + 1);
+
+    HalfGatesGarbler garbler;
+    HalfGatesEvaluator evaluator;
+    ASSERT_EQ(garbler.delta()[0] & 1, 1);
+    vector<uint8_t> tables(circuit.table_bytes());
+    vector<AES128::block_t> labels0(2 * n), labels(2 * n), outputs(n + 1);
+    vector<uint8_t> decoding(n + 1), in(2 * n), out(n + 1), plain(n + 1);
+    for (size_t trial = 0; trial < 16; trial++) {
+        uint32_t a;
+        std::memcpy(&a, gen_key().data(), sizeof(a));
+        const uint32_t b = trial * 0x9e3779b9;
+        for (size_t i = 0; i < n; i++) {
+            in[i] = (a >> i) & 1;
+            in[n + i] = (b >> i) & 1;
+        }
+        circuit.eval(plain.data(), in.data());
+        garbler.garble(circuit, tables.data(), labels0.data(),
+                       decoding.data());
+        garbler.encode(labels.data(), labels0.data(), in.data(), 2 * n);
+        evaluator.evaluate(circuit, tables.data(), labels.data(),
+                           outputs.data());
+        HalfGatesEvaluator::decode(out.data(), outputs.data(),
+                                   decoding.data(), n + 1);
+        const uint64_t sum = uint64_t(a) + b;
+        for (size_t i = 0; i < n; i++) {
+            ASSERT_EQ(plain[i], (sum >> i) & 1) << trial << " " << i;
+        }
+        ASSERT_EQ(plain[n], ((sum >> n) & 1) ^ 1);
+        ASSERT_EQ(out, plain) << trial;
+    }
+
+    istringstream bad("1 3\n1 1\n1 1\n\n2 1 0 5 2 AND\n");
+    ASSERT_THROW(Circuit{bad}, std::runtime_error);
+}
+
+TEST_F(AESNITest, cuckoo_hashing)
+{
+    using block_t = AES128::block_t;
+    constexpr size_t num_items = 10000, num_bins = 12700, k = 3;
+    vector<block_t> items(num_items);
+    AES128(gen_key()).ctr_stream(items.data(), num_items, 0);
+    const MultiHash hash(num_bins, k);
+    vector<uint32_t> hashes(k * num_items);
+    hash(hashes.data(), items.data(), num_items);
+    const AES128 aes(cuckoo::default_key);
+    for (size_t i = 0; i < num_items; i++) {
+        uint32_t words[4];
+        aes.enc(words, items[i].data());
+        for (size_t j = 0; j < k; j++) {
+            ASSERT_EQ(hashes[k * i + j],
+                      (uint64_t(words[j]) * num_bins) >> 32);
+        }
+    }
+
+    // NOTE: Every item is in exactly one bin of its hash functions or in the
+    // stash.
+    CuckooTable table(num_bins, k);
+    table.build(items.data(), num_items);
+    ASSERT_LE(table.stash().size(), 4);
+    vector<size_t> seen(num_items, 0);
+    for (size_t b = 0; b < num_bins; b++) {
+        const auto entry = table.bins()[b];
+        if (entry != cuckoo::empty) {
+            const auto i = cuckoo::index_of(entry);
+            ASSERT_EQ(hashes[k * i + cuckoo::func_of(entry)], b);
+            seen[i]++;
+        }
+    }
+    for (const auto i : table.stash()) {
+        seen[i]++;
+    }
+    ASSERT_EQ(count(seen.begin(), seen.end(), 1), num_items);
+
+    SimpleHashing simple(num_bins, k);
+    simple.build(items.data(), num_items);
+    ASSERT_EQ(simple.entries().size(), k * num_items);
+    ASSERT_EQ(simple.offsets().back(), k * num_items);
+    for (size_t b = 0; b < num_bins; b++) {
+        for (auto e = simple.offsets()[b]; e < simple.offsets()[b + 1]; e++) {
+            const auto entry = simple.entries()[e];
+            ASSERT_EQ(hashes[k * cuckoo::index_of(entry) +
+                             cuckoo::func_of(entry)],
+                      b);
+        }
+    }
+    ASSERT_GT(simple.max_bin_size(), 0);
+    ASSERT_THROW(MultiHash(num_bins, 5), std::invalid_argument);
+    ASSERT_THROW(MultiHash(0), std::invalid_argument);
+}
+
+TEST_F(AESNITest, aes_round_hash)
+{
+    const AESRoundHash<2> hash;
+    vector<uint8_t> data(300);
+    init(data);
+    // NOTE: Streaming in pieces and batches agree with one-shot hashing.
+    for (size_t n = 0; n <= data.size(); n++) {
+        AESRoundHash<2>::digest_t expected, actual;
+        hash.hash128(expected.data(), data.data(), n);
+        AESRoundHashStream<2> stream;
+        for (size_t i = 0, step = 1; i < n; i += step, step = 2 * step + 1) {
+            stream.update(data.data() + i, min(step, n - i));
+        }
+        stream.digest128(actual.data());
+        ASSERT_EQ(expected, actual) << n;
+        ASSERT_EQ(stream.digest64(), hash.hash64(data.data(), n));
+    }
+    for (const size_t key_bytes : {1, 8, 13, 16, 40, 64, 65, 100}) {
+        const size_t num_keys = data.size() / key_bytes;
+        vector<uint64_t> out(num_keys);
+        hash.hash64(out.data(), data.data(), key_bytes, num_keys);
+        for (size_t i = 0; i < num_keys; i++) {
+            ASSERT_EQ(out[i], hash.hash64(data.data() + key_bytes * i,
+                                          key_bytes))
+                << key_bytes << " " << i;
+        }
+    }
+
+    // NOTE: SMHasher-style checks: avalanche of every input bit into every
+    // output bit, sparse keys, zero keys of every length and seeds.
+    auto check_avalanche = [&](const auto &h, const size_t key_bytes) {
+        constexpr size_t num_samples = 4000;
+        vector<size_t> flips(8 * key_bytes * 64, 0);
+        vector<uint8_t> key(key_bytes);
+        for (size_t s = 0; s < num_samples; s++) {
+            init(key);
+            const auto base = h.hash64(key.data(), key_bytes);
+            for (size_t i = 0; i < 8 * key_bytes; i++) {
+                key[i / 8] ^= 1 << (i % 8);
+                const auto diff = base ^ h.hash64(key.data(), key_bytes);
+                key[i / 8] ^= 1 << (i % 8);
+                for (size_t j = 0; j < 64; j++) {
+                    flips[64 * i + j] += (diff >> j) & 1;
+                }
+            }
+        }
+        double max_bias = 0;
+        for (const auto f : flips) {
+            max_bias = max(max_bias, abs(double(f) / num_samples - 0.5));
+        }
+        return max_bias;
+    };
+    for (const size_t key_bytes : {8, 32}) {
+        EXPECT_LT(check_avalanche(AESRoundHash<1>(), key_bytes), 0.05);
+        EXPECT_LT(check_avalanche(hash, key_bytes), 0.05);
+    }
+    set<uint64_t> sparse;
+    array<uint8_t, 32> key{};
+    sparse.insert(hash.hash64(key.data(), key.size()));
+    for (size_t i = 0; i < 8 * key.size(); i++) {
+        key[i / 8] ^= 1 << (i % 8);
+        sparse.insert(hash.hash64(key.data(), key.size()));
+        for (size_t j = i + 1; j < 8 * key.size(); j++) {
+            key[j / 8] ^= 1 << (j % 8);
+            sparse.insert(hash.hash64(key.data(), key.size()));
+            key[j / 8] ^= 1 << (j % 8);
+        }
+        key[i / 8] ^= 1 << (i % 8);
+    }
+    ASSERT_EQ(sparse.size(), 1 + 256 + 256 * 255 / 2);
+    set<uint64_t> zeros;
+    const vector<uint8_t> zero(data.size(), 0);
+    for (size_t n = 0; n <= zero.size(); n++) {
+        zeros.insert(hash.hash64(zero.data(), n));
+    }
+    ASSERT_EQ(zeros.size(), zero.size() + 1);
+    const auto seed = gen_key();
+    ASSERT_NE(AESRoundHash<2>(seed.data()).hash64(data.data(), 16),
+              hash.hash64(data.data(), 16));
+}
+
+TEST_F(AESNITest, haraka_v2)
+{
+    // NOTE: Test vectors of the reference implementation, inputs 0, 1, ...
+    const Haraka haraka;
+    vector<uint8_t> in(64 * 13);
+    iota(in.begin(), in.begin() + 64, 0);
+    const vector<uint8_t> expected256 = {
+        0x80, 0x27, 0xcc, 0xb8, 0x79, 0x49, 0x77, 0x4b, 0x78, 0xd0, 0x54,
+        0x5f, 0xb7, 0x2b, 0xf7, 0x0c, 0x69, 0x5c, 0x2a, 0x09, 0x23, 0xcb,
+        0xd4, 0x7b, 0xba, 0x11, 0x59, 0xef, 0xbf, 0x2b, 0x2c, 0x1c};
+    const vector<uint8_t> expected512 = {
+        0xbe, 0x7f, 0x72, 0x3b, 0x4e, 0x80, 0xa9, 0x98, 0x13, 0xb2, 0x92,
+        0x28, 0x7f, 0x30, 0x6f, 0x62, 0x5a, 0x6d, 0x57, 0x33, 0x1c, 0xae,
+        0x5f, 0x34, 0xdd, 0x92, 0x77, 0xb0, 0x94, 0x5b, 0xe2, 0xaa};
+    vector<uint8_t> out(haraka::digest_bytes);
+    haraka.hash256(out.data(), in.data());
+    ASSERT_EQ(out, expected256);
+    haraka.hash512(out.data(), in.data());
+    ASSERT_EQ(out, expected512);
+
+    // NOTE: Batches of 8, 4 and 1 agree with single messages.
+    init(in);
+    vector<uint8_t> batch(haraka::digest_bytes * 13);
+    haraka.hash512(batch.data(), in.data(), 13);
+    for (size_t i = 0; i < 13; i++) {
+        haraka.hash512(out.data(), in.data() + 64 * i);
+        ASSERT_TRUE(equal(out.begin(), out.end(),
+                          batch.begin() + haraka::digest_bytes * i));
+    }
+    haraka.hash256(batch.data(), in.data(), 13);
+    for (size_t i = 0; i < 13; i++) {
+        haraka.hash256(out.data(), in.data() + 32 * i);
+        ASSERT_TRUE(equal(out.begin(), out.end(),
+                          batch.begin() + haraka::digest_bytes * i));
+    }
+    // NOTE: Haraka-512 is the truncation of perm512(x) xor x.
+    vector<uint8_t> perm(64);
+    haraka.perm512(perm.data(), in.data());
+    haraka.hash512(out.data(), in.data());
+    for (size_t i = 0; i < 8; i++) {
+        ASSERT_EQ(out[i], perm[8 + i] ^ in[8 + i]);
+        ASSERT_EQ(out[24 + i], perm[48 + i] ^ in[48 + i]);
+    }
+
+    // NOTE: Outputs of Haraka-S are prefixes of longer ones, and tweaked
+    // constants change the hash.
+    vector<uint8_t> long_out(100), short_out(40);
+    haraka.sponge(long_out.data(), long_out.size(), in.data(), 70);
+    haraka.sponge(short_out.data(), short_out.size(), in.data(), 70);
+    ASSERT_TRUE(equal(short_out.begin(), short_out.end(), long_out.begin()));
+    haraka.sponge(short_out.data(), short_out.size(), in.data(), 64);
+    ASSERT_FALSE(equal(short_out.begin(), short_out.end(), long_out.begin()));
+    const Haraka tweaked(in.data(), 32);
+    tweaked.hash256(out.data(), in.data());
+    haraka.hash256(batch.data(), in.data());
+    ASSERT_FALSE(equal(out.begin(), out.end(), batch.begin()));
+}
+
+TEST_F(AESNITest, hirose_dbl_hash)
+{
+    // NOTE: E_K(G) = G' xor G with K = H || M, checked against the AES-256
+    // vector of FIPS 197 C.3.
+    vector<uint8_t> state(hirose::digest_bytes), block(hirose::block_bytes);
+    const vector<uint8_t> pt = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55,
+                                0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb,
+                                0xcc, 0xdd, 0xee, 0xff};
+    const vector<uint8_t> ct = {0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67,
+                                0x45, 0xbf, 0xea, 0xfc, 0x49, 0x90,
+                                0x4b, 0x49, 0x60, 0x89};
+    copy(pt.begin(), pt.end(), state.begin());
+    iota(state.begin() + 16, state.end(), 0);
+    iota(block.begin(), block.end(), 16);
+    Hirose256::compress(state.data(), block.data());
+    for (size_t i = 0; i < 16; i++) {
+        ASSERT_EQ(state[i] ^ pt[i], ct[i]);
+    }
+
+    // NOTE: Batches of 4 and the rest agree with single messages, for
+    // lengths around the one and two padding blocks.
+    const Hirose256 hirose;
+    vector<uint8_t> in(64 * 7), out(hirose::digest_bytes);
+    init(in);
+    vector<uint8_t> batch(hirose::digest_bytes * 7);
+    for (size_t msg_bytes : {0, 7, 8, 16, 23, 24, 64}) {
+        hirose.hash(batch.data(), in.data(), msg_bytes, 7);
+        for (size_t i = 0; i < 7; i++) {
+            hirose.hash(out.data(), in.data() + msg_bytes * i, msg_bytes);
+            ASSERT_TRUE(equal(out.begin(), out.end(),
+                              batch.begin() + hirose::digest_bytes * i));
+        }
+    }
+
+    // NOTE: Messages of different lengths, or a different IV, differ.
+    set<uint64_t> digests;
+    uint64_t digest;
+    for (size_t n = 0; n <= 40; n++) {
+        hirose.hash(out.data(), in.data(), n);
+        memcpy(&digest, out.data(), sizeof(digest));
+        digests.insert(digest);
+    }
+    ASSERT_EQ(digests.size(), 41);
+    const Hirose256 other(in.data());
+    other.hash(out.data(), in.data(), 40);
+    memcpy(&digest, out.data(), sizeof(digest));
+    ASSERT_EQ(digests.count(digest), 0);
+}
+
+TEST_F(AESNITest, tree_hash)
+{
+    // NOTE: Leaves of 64 bytes, so that trees are deep on small inputs.
+    ASSERT_THROW(TreeHash(24), std::invalid_argument);
+    const TreeHash tree(64);
+    vector<uint8_t> in(64 * 37 + 5), out(tree_hash::digest_bytes),
+        other(tree_hash::digest_bytes);
+    init(in);
+    set<uint64_t> digests;
+    for (size_t n : {0, 1, 63, 64, 65, 128, 64 * 5, 64 * 37, 64 * 37 + 5}) {
+        tree.hash(out.data(), in.data(), n);
+        tree.hash(other.data(), in.data(), n, true);
+        ASSERT_EQ(out, other);
+        uint64_t digest;
+        memcpy(&digest, out.data(), sizeof(digest));
+        digests.insert(digest);
+        // NOTE: Chunks of the stream straddle leaves.
+        for (size_t chunk : {1, 7, 64, 100, 1000}) {
+            TreeHashStream stream(64);
+            for (size_t i = 0; i < n; i += chunk) {
+                stream.update(in.data() + i, min(chunk, n - i), true);
+            }
+            stream.finalize(other.data());
+            ASSERT_EQ(out, other);
+        }
+    }
+    ASSERT_EQ(digests.size(), 9);
+    // NOTE: A single leaf differs from Hirose256 of the message.
+    tree.hash(out.data(), in.data(), 64);
+    Hirose256().hash(other.data(), in.data(), 64);
+    ASSERT_NE(out, other);
+
+    const string path = fmt::format("/tmp/clt_tree_hash_{:d}", getpid());
+    {
+        ofstream ofs(path, ios::binary);
+        ofs.write(reinterpret_cast<const char *>(in.data()), in.size());
+    }
+    tree.hash_file(out.data(), path, true);
+    tree.hash(other.data(), in.data(), in.size());
+    ASSERT_EQ(out, other);
+    unlink(path.c_str());
+    ASSERT_THROW(tree.hash_file(out.data(), path), std::runtime_error);
+}
+
+uint8_t gf256_mul(uint8_t a, uint8_t b)
+{
+    uint8_t p = 0;
+    for (; b != 0; b >>= 1) {
+        p ^= (b & 1) ? a : 0;
+        a = (a << 1) ^ ((a & 0x80) ? 0x1b : 0);
+    }
+    return p;
+}
+
+/**
+ * AESENC in software from FIPS 197, independent of AES-NI.
+ */
+void soft_aesenc(uint8_t *x, const uint8_t *key)
+{
+    static const auto sbox = []() {
+        array<uint8_t, 256> table{};
+        for (int i = 0; i < 256; i++) {
+            // NOTE: i^254 is the inverse of i, and 0 for i = 0.
+            uint8_t inv = 1;
+            for (int j = 0; j < 254; j++) {
+                inv = gf256_mul(inv, i);
+            }
+            uint8_t y = inv;
+            for (int j = 1; j <= 4; j++) {
+                y ^= (inv << j) | (inv >> (8 - j));
+            }
+            table[i] = y ^ 0x63;
+        }
+        return table;
+    }();
+    uint8_t t[16];
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            t[r + 4 * c] = sbox[x[r + 4 * ((c + r) % 4)]];
+        }
+    }
+    for (int c = 0; c < 4; c++) {
+        const uint8_t *a = t + 4 * c;
+        for (int r = 0; r < 4; r++) {
+            x[r + 4 * c] = gf256_mul(a[r], 2) ^ gf256_mul(a[(r + 1) % 4], 3) ^
+                           a[(r + 2) % 4] ^ a[(r + 3) % 4] ^ key[r + 4 * c];
+        }
+    }
+}
+
+/**
+ * Simpira v2 transcribed from Algorithm 1 of the paper over soft_aesenc.
+ */
+template <size_t Blocks> void soft_simpira(uint8_t *x)
+{
+    constexpr uint32_t b = Blocks;
+    uint32_t c = 1;
+    auto feistel = [&](const size_t i, const size_t j) {
+        uint8_t y[16], rc[16], zero[16] = {0};
+        copy_n(x + 16 * i, 16, y);
+        for (uint32_t w = 0; w < 4; w++) {
+            const uint32_t word = (0x10 * w) ^ c ^ b;
+            for (int k = 0; k < 4; k++) {
+                rc[4 * w + k] = uint8_t(word >> (8 * k));
+            }
+        }
+        soft_aesenc(y, rc);
+        soft_aesenc(y, zero);
+        for (int k = 0; k < 16; k++) {
+            x[16 * j + k] ^= y[k];
+        }
+        c++;
+    };
+    const size_t s[] = {0, 1, 6, 5, 4, 3}, t[] = {2, 7};
+    const size_t num_rounds = (b == 8) ? 18 : 15;
+    for (size_t r = 0; r < num_rounds; r++) {
+        if (b == 2) {
+            feistel(r % 2, (r + 1) % 2);
+        } else if (b == 4) {
+            feistel(r % 4, (r + 1) % 4);
+            feistel((r + 2) % 4, (r + 3) % 4);
+        } else {
+            feistel(s[r % 6], s[(r + 1) % 6]);
+            feistel(t[r % 2], s[(r + 5) % 6]);
+            feistel(s[(r + 4) % 6], s[(r + 3) % 6]);
+            feistel(s[(r + 2) % 6], t[(r + 1) % 2]);
+        }
+    }
+}
+
+template <size_t Blocks> void check_simpira(const vector<uint8_t> &in)
+{
+    constexpr size_t n = Simpira<Blocks>::state_bytes;
+    const size_t num_states = in.size() / n;
+    vector<uint8_t> out(in.size()), back(in.size()), one(n);
+    // NOTE: Batches and the rest agree with single states, and the inverse
+    // undoes the permutation.
+    Simpira<Blocks>::permute(out.data(), in.data(), num_states);
+    for (size_t i = 0; i < num_states; i++) {
+        Simpira<Blocks>::permute(one.data(), in.data() + n * i);
+        ASSERT_TRUE(equal(one.begin(), one.end(), out.begin() + n * i));
+    }
+    Simpira<Blocks>::inverse(back.data(), out.data(), num_states);
+    ASSERT_EQ(back, in);
+    // NOTE: A flipped bit of the last block changes about half the bits.
+    auto flipped = vector<uint8_t>(in.begin(), in.begin() + n);
+    flipped[n - 1] ^= 0x80;
+    Simpira<Blocks>::permute(one.data(), flipped.data());
+    size_t num_diff_bits = 0;
+    for (size_t i = 0; i < n; i++) {
+        num_diff_bits += __builtin_popcount(one[i] ^ out[i]);
+    }
+    ASSERT_NEAR(double(num_diff_bits) / (8 * n), 0.5, 0.1);
+    // NOTE: Agrees with the transcription of the specification.
+    for (size_t i = 0; i < min<size_t>(num_states, 3); i++) {
+        copy_n(in.begin() + n * i, n, one.begin());
+        soft_simpira<Blocks>(one.data());
+        ASSERT_TRUE(equal(one.begin(), one.end(), out.begin() + n * i)) << i;
+    }
+
+    const WideBlockCipher<Blocks> cipher(in.data());
+    cipher.enc(out.data(), in.data(), num_states, 100);
+    for (size_t i = 0; i < num_states; i++) {
+        cipher.enc(one.data(), in.data() + n * i, 1, 100 + i);
+        ASSERT_TRUE(equal(one.begin(), one.end(), out.begin() + n * i));
+    }
+    cipher.dec(back.data(), out.data(), num_states, 100);
+    ASSERT_EQ(back, in);
+    cipher.enc(one.data(), in.data(), 1, 101);
+    ASSERT_FALSE(equal(one.begin(), one.end(), out.begin()));
+}
+
+TEST_F(AESNITest, simpira_wide_block)
+{
+    vector<uint8_t> in(128 * 13);
+    init(in);
+    check_simpira<2>(in);
+    check_simpira<4>(in);
+    check_simpira<8>(in);
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
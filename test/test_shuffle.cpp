@@ -5,6 +5,7 @@
 
 #include <clt/shuffle.hpp>
 #include <clt/aes-ni.hpp>
+#include <clt/prp.hpp>
 #include <clt/statistics.hpp>
 
 using namespace std;
@@ -45,6 +46,58 @@ TEST_F(ShuffleTest, permutation_rank)
     ASSERT_EQ(rank_pi, rank_pi2);
 }
 
+TEST_F(ShuffleTest, permutation_rank_small_degrees)
+{
+    // NOTE: Exhaustive check that rank is a bijection onto [0, n!).
+    for (size_t degree = 0; degree <= 6; degree++) {
+        const auto num_perms = clt::factorial(degree).get_ui();
+        vector<bool> seen(num_perms, false);
+        for (size_t r = 0; r < num_perms; r++) {
+            const auto pi = clt::unrank(r, degree);
+            const auto r_pi = clt::rank(pi);
+            ASSERT_EQ(r_pi, r);
+            seen[r] = true;
+        }
+        ASSERT_EQ(count(begin(seen), end(seen), true), num_perms);
+    }
+}
+
+TEST_F(ShuffleTest, permutation_rank_large_degree)
+{
+    AESPRF128_CTR prf(random_key_.data());
+    // NOTE: Crosses several levels of the product tree.
+    for (const size_t degree : {17, 100, 1000, 100000}) {
+        Permutation perm(degree);
+        perm.shuffle(prf);
+        const auto rank_pi = clt::rank(perm.indices_);
+        ASSERT_LT(rank_pi, clt::factorial(degree));
+        ASSERT_EQ(clt::unrank(rank_pi, degree), perm.indices_);
+    }
+    const size_t degree = 1000;
+    const mpz_class last = clt::factorial(degree) - 1;
+    ASSERT_EQ(clt::rank(clt::unrank(last, degree)), last);
+}
+
+TEST_F(ShuffleTest, permutation_32bit_indices)
+{
+    static_assert(sizeof(Permutation32::index_t) == sizeof(uint32_t));
+    AESPRF128_CTR prf(random_key_.data());
+    const size_t degree = 1 << 10;
+    Permutation32 perm(degree);
+    perm.shuffle(prf);
+    const auto rank_pi = clt::rank(perm.indices_);
+    const auto pi = clt::unrank<uint32_t>(rank_pi, degree);
+    ASSERT_EQ(pi, perm.indices_);
+
+    Permutation wide(degree);
+    copy(begin(perm.indices_), end(perm.indices_), begin(wide.indices_));
+    ASSERT_EQ(clt::rank(wide.indices_), rank_pi);
+
+    const auto id = perm * perm.inverse();
+    ASSERT_EQ(id, Permutation32(degree));
+    ASSERT_NE(perm * perm, Permutation32(degree + 1));
+}
+
 TEST_F(ShuffleTest, permutation_composite)
 {
     AESPRF128_CTR prf(random_key_.data());
@@ -73,6 +126,91 @@ TEST_F(ShuffleTest, permutation_inverse)
     ASSERT_EQ(0, id_rank);
 }
 
+TEST_F(ShuffleTest, permutation_inverse_scatter)
+{
+    AESPRF128_CTR prf(random_key_.data());
+    // NOTE: Large enough to take the parallel paths.
+    const size_t degree = (1 << 17) + 3;
+    Permutation perm(degree);
+    perm.shuffle(prf);
+    const auto inv_perm = perm.inverse();
+    for (size_t i = 0; i < degree; i++) {
+        ASSERT_EQ(inv_perm[perm[i]], i);
+    }
+    permutation_t inv_blocked(degree);
+    inverse_permutation_blocked(inv_blocked.data(), perm.indices_.data(),
+                                degree, 1000);
+    ASSERT_EQ(inv_blocked, inv_perm.indices_);
+
+    vector<uint64_t> buff(degree), gathered(degree), gathered_blocked(degree),
+        scattered(degree);
+    iota(begin(buff), end(buff), 100);
+    apply_permutation(gathered.data(), buff.data(), perm.indices_.data(),
+                      degree);
+    apply_permutation_blocked(gathered_blocked.data(), buff.data(),
+                              perm.indices_.data(), degree, 1000);
+    ASSERT_EQ(gathered, gathered_blocked);
+    ASSERT_EQ(gathered, perm.apply(buff));
+    scatter_permutation(scattered.data(), gathered.data(),
+                        perm.indices_.data(), degree);
+    ASSERT_EQ(scattered, buff);
+}
+
+TEST_F(ShuffleTest, apply_permutation_inplace)
+{
+    AESPRF128_CTR prf(random_key_.data());
+    for (const size_t degree : {1, 2, 1000, (1 << 17) + 3}) {
+        Permutation perm(degree);
+        perm.shuffle(prf);
+        vector<string> buff(degree);
+        for (size_t i = 0; i < degree; i++) {
+            buff[i] = to_string(i);
+        }
+        const auto expected = apply_permutation(buff, perm.indices_);
+        auto inplace = buff;
+        apply_permutation_inplace(inplace, perm.indices_);
+        ASSERT_EQ(inplace, expected);
+        inplace = buff;
+        apply_permutation_inplace_parallel(inplace.data(),
+                                           perm.indices_.data(), degree);
+        ASSERT_EQ(inplace, expected);
+    }
+}
+
+TEST_F(ShuffleTest, apply_permutation_inplace_short_cycles)
+{
+    // NOTE: Many independent cycles of length 3, and fixed points.
+    const size_t degree = 3 * (1 << 16) + 2;
+    permutation_t perm(degree);
+    iota(begin(perm), end(perm), 0);
+    for (size_t i = 0; i + 3 <= degree; i += 3) {
+        perm[i] = i + 1;
+        perm[i + 1] = i + 2;
+        perm[i + 2] = i;
+    }
+    vector<uint64_t> buff(degree);
+    iota(begin(buff), end(buff), 100);
+    const auto expected = apply_permutation(buff, perm);
+    apply_permutation_inplace_parallel(buff.data(), perm.data(), degree);
+    ASSERT_EQ(buff, expected);
+}
+
+TEST_F(ShuffleTest, apply_permutation_inplace_long_cycle)
+{
+    // NOTE: A cyclic shift, a single cycle of length degree above the
+    // parallel threshold, whose leader search would be quadratic.
+    const size_t degree = (1 << 20) + 5;
+    permutation_t perm(degree);
+    for (size_t i = 0; i < degree; i++) {
+        perm[i] = (i + 1) % degree;
+    }
+    vector<uint64_t> buff(degree);
+    iota(begin(buff), end(buff), 100);
+    const auto expected = apply_permutation(buff, perm);
+    apply_permutation_inplace_parallel(buff.data(), perm.data(), degree);
+    ASSERT_EQ(buff, expected);
+}
+
 TEST_F(ShuffleTest, shuffle_FY)
 {
     AESPRF128_CTR prf(random_key_.data());
@@ -128,6 +266,43 @@ TEST_F(ShuffleTest, shuffle_FY_statistics)
     }
 }
 
+TEST_F(ShuffleTest, shuffle_rounding)
+{
+    AESPRF128_CTR prf(random_key_.data());
+    // NOTE: Span several refills of the internal index chunk.
+    const size_t n = 3 * shuffle_rounding_chunk_elems + 5;
+    vector<uint64_t> perm(n);
+    iota(begin(perm), end(perm), 0);
+    shuffle_rounding(perm.data(), size(perm), prf);
+    vector<uint64_t> sorted_perm(perm);
+    sort(begin(sorted_perm), end(sorted_perm));
+    for (size_t i = 0; i < n; i++) {
+        ASSERT_EQ(sorted_perm[i], i);
+    }
+}
+
+TEST_F(ShuffleTest, shuffle_rounding_statistics)
+{
+    AESPRF128_CTR prf(random_key_.data());
+    const size_t degree = 5;
+    using perm_t = Permutation::perm_t;
+    perm_t perm(degree);
+    iota(begin(perm), end(perm), 0);
+
+    const mpz_class perm_space_size = clt::factorial(degree);
+    vector<uint32_t> counter(perm_space_size.get_ui(), 0);
+    const size_t expectation = 1000;
+    const mpz_class num_loop = expectation * perm_space_size;
+    for (size_t i = 0; i < num_loop; i++) {
+        shuffle_rounding(perm.data(), size(perm), prf);
+        const auto rank_perm = clt::rank(perm);
+        counter[rank_perm.get_ui()]++;
+    }
+    if (!check_udist_by_chisq(counter, expectation)) {
+        fmt::print(cerr, "WARN: Statistical check failed, but not fatal.\n");
+    }
+}
+
 TEST_F(ShuffleTest, shuffle_RS)
 {
     AESPRF128_CTR prf(random_key_.data());
@@ -173,6 +348,67 @@ TEST_F(ShuffleTest, shuffle_RS_statistics)
     }
 }
 
+TEST_F(ShuffleTest, swap_or_not_bijection)
+{
+    for (const uint64_t n : {1, 2, 3, 10, 1000, (1 << 12) + 3}) {
+        SwapOrNot prp(random_key_, n);
+        vector<uint64_t> image(n), in(n), out(n);
+        for (uint64_t i = 0; i < n; i++) {
+            image[i] = prp.forward(i);
+            ASSERT_LT(image[i], n);
+            ASSERT_EQ(prp.inverse(image[i]), i);
+        }
+        vector<uint64_t> sorted_image(image);
+        sort(begin(sorted_image), end(sorted_image));
+        for (uint64_t i = 0; i < n; i++) {
+            ASSERT_EQ(sorted_image[i], i);
+        }
+        iota(begin(in), end(in), 0);
+        prp.forward(out.data(), in.data(), n);
+        ASSERT_EQ(out, image);
+        prp.inverse(out.data(), image.data(), n);
+        ASSERT_EQ(out, in);
+    }
+}
+
+TEST_F(ShuffleTest, swap_or_not_large_domain)
+{
+    const uint64_t n = (uint64_t(1) << 40) + 7;
+    SwapOrNot prp(random_key_, n);
+    const size_t num_indices = 1000;
+    vector<uint64_t> in(num_indices), out(num_indices), inv(num_indices);
+    for (size_t i = 0; i < num_indices; i++) {
+        in[i] = n - 1 - 997 * i;
+    }
+    prp.forward(out.data(), in.data(), num_indices);
+    prp.inverse(inv.data(), out.data(), num_indices);
+    ASSERT_EQ(in, inv);
+    for (size_t i = 0; i < num_indices; i++) {
+        ASSERT_LT(out[i], n);
+        ASSERT_EQ(out[i], prp.forward(in[i]));
+    }
+}
+
+TEST_F(ShuffleTest, swap_or_not_statistics)
+{
+    const size_t degree = 4;
+    const mpz_class perm_space_size = clt::factorial(degree);
+    vector<uint32_t> counter(perm_space_size.get_ui(), 0);
+    const size_t expectation = 200;
+    const size_t num_loop = expectation * perm_space_size.get_ui();
+    permutation_t perm(degree);
+    for (size_t i = 0; i < num_loop; i++) {
+        SwapOrNot prp(gen_key(), degree);
+        for (size_t j = 0; j < degree; j++) {
+            perm[j] = prp.forward(j);
+        }
+        counter[clt::rank(perm).get_ui()]++;
+    }
+    if (!check_udist_by_chisq(counter, expectation)) {
+        fmt::print(cerr, "WARN: Statistical check failed, but not fatal.\n");
+    }
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);